@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#   include <cerrno>
+#   include <cstring>
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////
+// Performance counters for benchmarks
+//
+// On Linux the counters are read with perf_event_open for
+// the calling thread and the threads it spawns while the
+// counters are enabled. Counters that can't be opened - no
+// PMU in a virtual machine, perf_event_paranoid too strict,
+// other platforms - are reported as unavailable and simply
+// not measured: benchmarks then rely on std::chrono alone.
+
+struct counter_description
+{
+    const char* name;
+#if defined(__linux__)
+    std::uint32_t type;
+    std::uint64_t config;
+#endif
+};
+
+#if defined(__linux__)
+#   define COUNTER_DESCRIPTION(name, type, config) { name, type, config }
+#else
+#   define COUNTER_DESCRIPTION(name, type, config) { name }
+#endif
+
+inline auto counter_descriptions()
+    -> std::vector<counter_description>
+{
+    return {
+        COUNTER_DESCRIPTION("cpu_cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+        COUNTER_DESCRIPTION("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+        COUNTER_DESCRIPTION("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES),
+        COUNTER_DESCRIPTION("cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES),
+        COUNTER_DESCRIPTION("dtlb_misses", PERF_TYPE_HW_CACHE,
+                            PERF_COUNT_HW_CACHE_DTLB
+                            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)),
+        COUNTER_DESCRIPTION("page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS),
+    };
+}
+
+#undef COUNTER_DESCRIPTION
+
+inline auto counter_names()
+    -> std::vector<std::string>
+{
+    std::vector<std::string> res;
+    for (const auto& desc: counter_descriptions()) {
+        res.push_back(desc.name);
+    }
+    return res;
+}
+
+class performance_counters
+{
+    public:
+
+        // Try to open the counters with the given names, the ones
+        // that can't be opened are listed by unavailable()
+        explicit performance_counters(const std::vector<std::string>& requested)
+        {
+            for (const auto& desc: counter_descriptions()) {
+                bool wanted = false;
+                for (const auto& name: requested) {
+                    wanted = wanted || name == desc.name;
+                }
+                if (not wanted) continue;
+#if defined(__linux__)
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof attr);
+                attr.type = desc.type;
+                attr.size = sizeof attr;
+                attr.config = desc.config;
+                attr.disabled = 1;
+                attr.inherit = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                if (fd != -1) {
+                    fds.push_back(fd);
+                    opened.push_back(desc.name);
+                } else {
+                    failed.push_back(std::string(desc.name) + " (" + std::strerror(errno) + ")");
+                }
+#else
+                failed.push_back(std::string(desc.name) + " (perf_event_open is Linux-only)");
+#endif
+            }
+        }
+
+        performance_counters(const performance_counters&) = delete;
+        performance_counters& operator=(const performance_counters&) = delete;
+
+        ~performance_counters()
+        {
+#if defined(__linux__)
+            for (int fd: fds) {
+                close(fd);
+            }
+#endif
+        }
+
+        // Names of the counters that are actually measured
+        auto names() const
+            -> const std::vector<std::string>&
+        {
+            return opened;
+        }
+
+        // Requested counters that couldn't be opened, with a reason
+        auto unavailable() const
+            -> const std::vector<std::string>&
+        {
+            return failed;
+        }
+
+        auto start()
+            -> void
+        {
+#if defined(__linux__)
+            for (int fd: fds) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        // Values of the counters since the last call to start(), in
+        // the same order as names(); counters multiplexed with other
+        // events are scaled, counters that never got to run are NaN
+        auto stop()
+            -> std::vector<double>
+        {
+            std::vector<double> res;
+#if defined(__linux__)
+            for (int fd: fds) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+            for (int fd: fds) {
+                std::uint64_t values[3] = {}; // value, time enabled, time running
+                auto nb_read = read(fd, values, sizeof values);
+                if (nb_read != static_cast<decltype(nb_read)>(sizeof values) || values[2] == 0) {
+                    res.push_back(std::numeric_limits<double>::quiet_NaN());
+                } else {
+                    res.push_back(static_cast<double>(values[0])
+                                  * static_cast<double>(values[1])
+                                  / static_cast<double>(values[2]));
+                }
+            }
+#endif
+            return res;
+        }
+
+    private:
+
+        std::vector<int> fds;
+        std::vector<std::string> opened;
+        std::vector<std::string> failed;
+};
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: MIT
  */
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <ctime>
 #include <random>
@@ -357,9 +358,9 @@ namespace dist
 
             for (long long int i = 0 ; i < size ; ++i) {
                 if (percent_dis(distributions_prng) < factor) {
-                    *out++ = value_dis(distributions_prng);
+                    *out++ = proj(value_dis(distributions_prng));
                 } else {
-                    *out++ = i;
+                    *out++ = proj(i);
                 }
             }
         }
@@ -398,4 +399,140 @@ namespace dist
 
         static constexpr const char* output = "vergesort_killer.txt";
     };
+
+    ////////////////////////////////////////////////////////////
+    // Workload-like distributions
+    //
+    // Distributions mimicking data commonly found in production
+    // rather than patterns designed to stress algorithms
+
+    struct zipf:
+        base_distribution<zipf>
+    {
+        // Values in [1, size] where the frequency of the value k is
+        // proportional to 1/k^exponent: a few values are extremely
+        // common while most others appear only a handful of times,
+        // like the keys of most real-world caches and databases
+        double exponent;
+
+        constexpr explicit zipf(double exponent=1.0) noexcept:
+            exponent(exponent)
+        {}
+
+        template<typename OutputIterator, typename Projection=cppsort::utility::identity>
+        auto operator()(OutputIterator out, long long int size, Projection projection={}) const
+            -> void
+        {
+            auto&& proj = cppsort::utility::as_function(projection);
+
+            // Rejection-inversion sampling, see "Rejection-inversion to
+            // generate variates from monotone discrete distributions" by
+            // Hörmann and Derflinger; unlike the inverse transform method
+            // it doesn't need a table of size elements
+            auto helper1 = [](double x) {
+                return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+            };
+            auto helper2 = [](double x) {
+                return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+            };
+            auto h = [this](double x) {
+                return std::exp(-exponent * std::log(x));
+            };
+            auto h_integral = [&](double x) {
+                double log_x = std::log(x);
+                return helper2((1.0 - exponent) * log_x) * log_x;
+            };
+            auto h_integral_inverse = [&](double x) {
+                double t = (std::max)(x * (1.0 - exponent), -1.0);
+                return std::exp(helper1(t) * x);
+            };
+
+            double n = static_cast<double>(size);
+            double h_integral_x1 = h_integral(1.5) - 1.0;
+            double h_integral_n = h_integral(n + 0.5);
+            double squeeze = 2.0 - h_integral_inverse(h_integral(2.5) - h(2.0));
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+            for (long long int i = 0 ; i < size ; ++i) {
+                long long int k;
+                while (true) {
+                    double u = h_integral_n + dist(distributions_prng) * (h_integral_x1 - h_integral_n);
+                    double x = h_integral_inverse(u);
+                    k = static_cast<long long int>(x + 0.5);
+                    k = (std::min)((std::max)(k, 1ll), size);
+                    if (static_cast<double>(k) - x <= squeeze ||
+                        u >= h_integral(static_cast<double>(k) + 0.5) - h(static_cast<double>(k))) {
+                        break;
+                    }
+                }
+                *out++ = proj(k);
+            }
+        }
+
+        static constexpr const char* output = "zipf.txt";
+    };
+
+    struct bounded_disorder:
+        base_distribution<bounded_disorder>
+    {
+        // Timestamps of events received with a random delay smaller
+        // than max_delay: every element is at most max_delay positions
+        // away from its sorted position, like logs merged from several
+        // sources or packets received out of order
+        long long int max_delay;
+
+        constexpr explicit bounded_disorder(long long int max_delay=64) noexcept:
+            max_delay(max_delay)
+        {}
+
+        template<typename OutputIterator, typename Projection=cppsort::utility::identity>
+        auto operator()(OutputIterator out, long long int size, Projection projection={}) const
+            -> void
+        {
+            auto&& proj = cppsort::utility::as_function(projection);
+            std::uniform_int_distribution<long long int> delay_dis(0, max_delay - 1);
+            for (long long int i = 0 ; i < size ; ++i) {
+                *out++ = proj(i + delay_dis(distributions_prng));
+            }
+        }
+
+        static constexpr const char* output = "bounded_disorder.txt";
+    };
+
+    struct clustered:
+        base_distribution<clustered>
+    {
+        // Values gathered in nb_clusters narrow ranges spread over a
+        // wide domain, in random order: many close values and a few
+        // big gaps, like prices or sensor measures
+        long long int nb_clusters;
+
+        constexpr explicit clustered(long long int nb_clusters=16) noexcept:
+            nb_clusters(nb_clusters)
+        {}
+
+        template<typename OutputIterator, typename Projection=cppsort::utility::identity>
+        auto operator()(OutputIterator out, long long int size, Projection projection={}) const
+            -> void
+        {
+            auto&& proj = cppsort::utility::as_function(projection);
+
+            // Every cluster spans a range of values whose size is a
+            // small fraction of the size of the domain
+            long long int width = (std::max)(size / (4 * nb_clusters), 1ll);
+            std::uniform_int_distribution<long long int> center_dis(0, 4 * size);
+            std::vector<long long int> centers;
+            for (long long int i = 0 ; i < nb_clusters ; ++i) {
+                centers.push_back(center_dis(distributions_prng));
+            }
+
+            std::uniform_int_distribution<std::size_t> cluster_dis(0, centers.size() - 1);
+            std::uniform_int_distribution<long long int> offset_dis(0, width - 1);
+            for (long long int i = 0 ; i < size ; ++i) {
+                *out++ = proj(centers[cluster_dis(distributions_prng)] + offset_dis(distributions_prng));
+            }
+        }
+
+        static constexpr const char* output = "clustered.txt";
+    };
 }
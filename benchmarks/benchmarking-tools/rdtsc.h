@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020 Morwenn
+ * Copyright (c) 2015-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
 
@@ -24,9 +24,14 @@
     3. This notice may not be removed or altered from any source distribution.
 */
 
+// RDTSC_IS_CYCLE_COUNTER is 1 when rdtsc() reads the time-stamp
+// counter, and 0 when it falls back to a monotonic clock counting
+// nanoseconds on architectures without such a counter
+
 #ifdef _WIN32
     #include <intrin.h>
     #define rdtsc __rdtsc
+    #define RDTSC_IS_CYCLE_COUNTER 1
 #else
     #ifdef __i586__
         static __inline__ unsigned long long rdtsc() {
@@ -34,13 +39,20 @@
             __asm__ volatile(".byte 0x0f, 0x31" : "=A" (x));
             return x;
         }
+        #define RDTSC_IS_CYCLE_COUNTER 1
     #elif defined(__x86_64__)
         static __inline__ unsigned long long rdtsc(){
             unsigned hi, lo;
             __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
             return ((unsigned long long) lo) | (((unsigned long long) hi) << 32);
         }
+        #define RDTSC_IS_CYCLE_COUNTER 1
     #else
-        #error no rdtsc implementation
+        #include <chrono>
+        static inline unsigned long long rdtsc() {
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        }
+        #define RDTSC_IS_CYCLE_COUNTER 0
     #endif
 #endif
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////
+// Records for benchmarks
+//
+// A record is a small key followed by a payload, the whole
+// record being Size bytes: comparing two records is cheap
+// while moving one is expensive, which is the kind of data
+// where sorting indirectly or caching projections can pay
+// off. Records are meant to be sorted on their key with the
+// record_key projection.
+
+template<std::size_t Size>
+struct record
+{
+    static_assert(Size > sizeof(std::uint32_t), "a record must be bigger than its key");
+
+    std::uint32_t key;
+    std::array<unsigned char, Size - sizeof(std::uint32_t)> payload;
+
+    record() = default;
+
+    explicit record(long long int value):
+        key(static_cast<std::uint32_t>(value))
+    {
+        payload.fill(static_cast<unsigned char>(value));
+    }
+
+    friend auto operator<(const record& lhs, const record& rhs)
+        -> bool
+    {
+        return lhs.key < rhs.key;
+    }
+};
+
+struct record_key
+{
+    template<std::size_t Size>
+    auto operator()(const record<Size>& rec) const noexcept
+        -> const std::uint32_t&
+    {
+        return rec.key;
+    }
+};
+
+// Projection for distributions: create a record from a value
+template<typename Record>
+struct make_record
+{
+    auto operator()(long long int value) const
+        -> Record
+    {
+        return Record(value);
+    }
+};
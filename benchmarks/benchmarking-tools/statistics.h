@@ -1,8 +1,11 @@
 /*
- * Copyright (c) 2020 Morwenn
+ * Copyright (c) 2020-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <vector>
 
 // Simple statistics functions
 
@@ -27,3 +30,43 @@ auto standard_deviation(const Iterable& values, double avg)
     }
     return std::sqrt(stddev);
 }
+
+// Robust statistics functions, less sensitive to outliers
+// caused by the rest of the system than the ones above
+
+template<typename Iterable>
+auto median(const Iterable& values)
+    -> double
+{
+    std::vector<double> sorted(std::begin(values), std::end(values));
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto middle = sorted.size() / 2;
+    if (sorted.size() % 2 == 0) {
+        return (sorted[middle - 1] + sorted[middle]) / 2.0;
+    }
+    return sorted[middle];
+}
+
+template<typename Iterable>
+auto median_absolute_deviation(const Iterable& values, double med)
+    -> double
+{
+    std::vector<double> deviations;
+    for (auto value : values) {
+        deviations.push_back(std::abs(double(value) - med));
+    }
+    return median(deviations);
+}
+
+template<typename Iterable>
+auto minimum(const Iterable& values)
+    -> double
+{
+    if (std::begin(values) == std::end(values)) {
+        return 0.0;
+    }
+    return *std::min_element(std::begin(values), std::end(values));
+}
@@ -0,0 +1,893 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <cpp-sort/probes/mono.h>
+#include <cpp-sort/probes/runs.h>
+#include "common.h"
+#include "statistics.h"
+
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Command line options
+
+    struct options
+    {
+        std::vector<std::string> candidates = {
+            "pdq_sort", "ska_sort", "spin_sort", "verge_sort",
+            "tim_sort", "quick_merge_sort", "drop_merge_sort"
+        };
+        std::vector<std::string> distributions;
+        std::string sample_file;
+        std::size_t sample_slices = 8;
+        std::vector<long long int> sizes = {
+            16, 64, 256, 1'024, 4'096, 16'384, 65'536, 262'144, 1'048'576
+        };
+        std::string type = "int32";
+        std::size_t repetitions = 9;
+        double max_time_s = 1.0;
+        unsigned long long seed = static_cast<unsigned long long>(std::time(nullptr));
+        std::string name = "autotuned_sorter";
+        std::string name_space;
+        std::string output;
+        bool help = false;
+    };
+
+    constexpr const char* usage =
+        "Usage: cpp-sort-autotune [options]\n"
+        "\n"
+        "Benchmarks candidate sorters on training collections of several sizes,\n"
+        "classifies the collections with cheap measures of presortedness, and\n"
+        "generates a header with a sorter dispatching each size range and class\n"
+        "of presortedness to the fastest candidate.\n"
+        "\n"
+        "Options:\n"
+        "  --candidates a,b,...     sorters to choose from (default: pdq_sort,\n"
+        "                           ska_sort,spin_sort,verge_sort,tim_sort,\n"
+        "                           quick_merge_sort,drop_merge_sort)\n"
+        "  --distributions a,b,...  training distributions (default: all, or none\n"
+        "                           when a sample file is given)\n"
+        "  --sample-file file       whitespace-separated values to train on\n"
+        "  --sample-slices n        random slices of the sample per size (default: 8)\n"
+        "  --sizes n,m,...          training sizes (default: powers of 4 from 16\n"
+        "                           to 1048576)\n"
+        "  --type name              type of the elements (default: int32)\n"
+        "  --repetitions n          maximum number of runs per measure (default: 9)\n"
+        "  --max-time s             maximum time in seconds per measure (default: 1)\n"
+        "  --seed n                 seed of the training data (default: current time)\n"
+        "  --name name              name of the generated sorter (default:\n"
+        "                           autotuned_sorter)\n"
+        "  --namespace name         namespace of the generated sorter (default: none)\n"
+        "  --output file            generated header (default: standard output)\n"
+        "  --help                   display this message\n"
+        "\n"
+        "The size ranges of the generated sorter are bounded by the geometric\n"
+        "means of consecutive training sizes. The training report is written to\n"
+        "the standard error.\n";
+
+    auto parse_options(int argc, char* argv[])
+        -> options
+    {
+        options opts;
+        bool has_distributions = false;
+        for (int idx = 1 ; idx < argc ; ++idx) {
+            std::string arg = argv[idx];
+            if (arg == "--help") {
+                opts.help = true;
+                continue;
+            }
+
+            if (idx + 1 == argc) {
+                throw std::invalid_argument("missing value for option " + arg);
+            }
+            std::string value = argv[++idx];
+
+            if (arg == "--candidates") {
+                opts.candidates = split(value);
+            } else if (arg == "--distributions") {
+                opts.distributions = split(value);
+                has_distributions = true;
+            } else if (arg == "--sample-file") {
+                opts.sample_file = value;
+            } else if (arg == "--sample-slices") {
+                opts.sample_slices = std::stoul(value);
+            } else if (arg == "--sizes") {
+                opts.sizes.clear();
+                for (const auto& size: split(value)) {
+                    opts.sizes.push_back(std::stoll(size));
+                    if (opts.sizes.back() <= 0) {
+                        throw std::invalid_argument("sizes must be positive");
+                    }
+                }
+            } else if (arg == "--type") {
+                opts.type = value;
+            } else if (arg == "--repetitions") {
+                opts.repetitions = std::stoul(value);
+            } else if (arg == "--max-time") {
+                opts.max_time_s = std::stod(value);
+            } else if (arg == "--seed") {
+                opts.seed = std::stoull(value);
+            } else if (arg == "--name") {
+                opts.name = value;
+            } else if (arg == "--namespace") {
+                opts.name_space = value;
+            } else if (arg == "--output") {
+                opts.output = value;
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+
+        if (not has_distributions && opts.sample_file.empty()) {
+            opts.distributions = { "all" };
+        }
+        if (opts.distributions.size() == 1 && opts.distributions.front() == "none") {
+            opts.distributions.clear();
+        }
+        if (opts.candidates.empty()) {
+            throw std::invalid_argument("at least one candidate is needed");
+        }
+        std::sort(opts.sizes.begin(), opts.sizes.end());
+        opts.sizes.erase(std::unique(opts.sizes.begin(), opts.sizes.end()), opts.sizes.end());
+        if (opts.sizes.empty()) {
+            throw std::invalid_argument("at least one training size is needed");
+        }
+        return opts;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Presortedness classes
+    //
+    // Collections are classified with two measures of presortedness:
+    // Mono tells apart random-looking collections from collections
+    // made of a few long monotonic runs, then Runs tells whether
+    // those few runs are mostly ascending or descending. Computing
+    // them is O(n), as costly as sorting a presorted collection
+    // with an adaptive algorithm, so big collections are only
+    // probed on a few evenly-spaced windows. The generated header
+    // embeds the same functions with the same constants.
+
+    constexpr int nb_classes = 4;
+
+    constexpr const char* class_names[nb_classes] = {
+        "few_ascending_runs",
+        "few_descending_runs",
+        "some_runs",
+        "random"
+    };
+
+    // Thresholds on Mono(X) / max(Mono) and Runs(X) / max(Runs)
+    constexpr double few_runs_threshold = 0.02;
+    constexpr double some_runs_threshold = 0.3;
+    constexpr double descending_threshold = 0.5;
+
+    // Windows used to probe big collections
+    constexpr long long int probe_nb_windows = 8;
+    constexpr long long int probe_window_size = 64;
+
+    // Measure of presortedness divided by its maximum
+    template<typename RandomAccessIterator, typename Probe, typename Projection>
+    auto probe_ratio(RandomAccessIterator first, long long int size,
+                     const Probe& probe, Projection projection)
+        -> double
+    {
+        if (size <= probe_nb_windows * probe_window_size) {
+            return static_cast<double>(probe(first, first + size, std::less<>{}, projection))
+                 / static_cast<double>(std::max(probe.max_for_size(size), 1LL));
+        }
+        long long int measure = 0;
+        for (long long int idx = 0 ; idx < probe_nb_windows ; ++idx) {
+            auto window = first + idx * (size / probe_nb_windows);
+            measure += probe(window, window + probe_window_size, std::less<>{}, projection);
+        }
+        return static_cast<double>(measure)
+             / static_cast<double>(probe_nb_windows * probe.max_for_size(probe_window_size));
+    }
+
+    template<typename RandomAccessIterator, typename Projection>
+    auto presortedness_class(RandomAccessIterator first, long long int size, Projection projection)
+        -> int
+    {
+        auto mono_ratio = probe_ratio(first, size, cppsort::probe::mono, projection);
+        if (mono_ratio >= some_runs_threshold) {
+            return 3;
+        }
+        if (mono_ratio >= few_runs_threshold) {
+            return 2;
+        }
+        auto runs_ratio = probe_ratio(first, size, cppsort::probe::runs, projection);
+        return runs_ratio >= descending_threshold ? 1 : 0;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Training data
+    //
+    // Training collections are generated lazily since keeping
+    // all of them in memory at once is not an option for the
+    // biggest sizes and element types.
+
+    template<typename T>
+    struct training_case
+    {
+        std::string name;
+        std::function<void(std::vector<T>&)> generate;
+    };
+
+    template<typename T>
+    auto sample_value(long double value)
+        -> std::enable_if_t<std::is_arithmetic<T>::value, T>
+    {
+        return static_cast<T>(value);
+    }
+
+    template<typename T>
+    auto sample_value(long double value)
+        -> std::enable_if_t<not std::is_arithmetic<T>::value, T>
+    {
+        using make_value = typename element_traits<T>::make_value;
+        return make_value{}(static_cast<long long int>(value));
+    }
+
+    template<typename T>
+    auto read_sample(const std::string& path)
+        -> std::vector<T>
+    {
+        std::ifstream file(path);
+        if (not file) {
+            throw std::runtime_error("can't open " + path);
+        }
+        std::vector<T> res;
+        long double value;
+        while (file >> value) {
+            res.push_back(sample_value<T>(value));
+        }
+        if (not file.eof()) {
+            throw std::runtime_error("invalid value in " + path);
+        }
+        return res;
+    }
+
+    template<typename T>
+    auto make_training_cases(const options& opts, const std::vector<T>& sample, long long int size)
+        -> std::vector<training_case<T>>
+    {
+        std::vector<training_case<T>> res;
+
+        auto distributions = make_distributions<T>();
+        for (const auto& name: opts.distributions) {
+            auto distribution = *std::find_if(
+                distributions.begin(), distributions.end(),
+                [&](const auto& entry) { return entry.name == name; }
+            );
+            auto seed = opts.seed;
+            res.push_back({
+                name,
+                [distribution, seed, size](std::vector<T>& collection) {
+                    distributions_prng.seed(seed);
+                    distribution.generate(collection, size);
+                }
+            });
+        }
+
+        // Contiguous slices of the sample keep its presortedness
+        if (not opts.sample_file.empty()) {
+            auto sample_size = static_cast<long long int>(sample.size());
+            if (sample_size < size) {
+                std::cerr << "warning: the sample is too small to train on size " << size << '\n';
+                return res;
+            }
+            std::mt19937_64 engine(opts.seed);
+            std::uniform_int_distribution<long long int> offsets(0, sample_size - size);
+            auto nb_slices = sample_size == size ? 1 : opts.sample_slices;
+            for (std::size_t idx = 0 ; idx < nb_slices ; ++idx) {
+                auto offset = offsets(engine);
+                res.push_back({
+                    "sample@" + std::to_string(offset),
+                    [&sample, offset, size](std::vector<T>& collection) {
+                        collection.assign(sample.begin() + offset, sample.begin() + offset + size);
+                    }
+                });
+            }
+        }
+        return res;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Measures
+
+    // Small collections are processed in batches of copies to
+    // rise above the resolution of the clock
+    constexpr std::size_t batch_elements = 1 << 16;
+
+    // Keeps the result of the probes alive
+    volatile int probe_sink = 0;
+
+    // Median time in nanoseconds to process one copy of the
+    // collection with func
+    template<typename T, typename Func>
+    auto measure(const std::vector<T>& collection, const options& opts, Func func)
+        -> double
+    {
+        auto batch = std::max<std::size_t>(1, batch_elements / collection.size());
+        std::vector<double> times;
+        auto max_time = std::chrono::duration<double>(opts.max_time_s);
+        auto total_start = clock_type::now();
+        do {
+            std::vector<std::vector<T>> copies(batch, collection);
+            auto start = clock_type::now();
+            for (auto& copy: copies) {
+                func(copy);
+            }
+            auto end = clock_type::now();
+            times.push_back(std::chrono::duration<double, std::nano>(end - start).count()
+                            / static_cast<double>(batch));
+        } while (times.size() < opts.repetitions && clock_type::now() - total_start < max_time);
+        return median(times);
+    }
+
+    struct case_result
+    {
+        std::string name;
+        int presortedness = 0;
+        double probe_ns = 0.0;
+        // One per candidate, infinite when the candidate failed
+        std::vector<double> times_ns;
+    };
+
+    template<typename T>
+    auto train(const options& opts, const std::vector<T>& sample, long long int size)
+        -> std::vector<case_result>
+    {
+        using projection = typename element_traits<T>::projection;
+        auto sorters = make_sorters<T>();
+        std::vector<case_result> results;
+
+        for (const auto& training: make_training_cases(opts, sample, size)) {
+            std::vector<T> collection;
+            collection.reserve(static_cast<std::size_t>(size));
+            training.generate(collection);
+
+            case_result res;
+            res.name = training.name;
+            res.presortedness = presortedness_class(collection.begin(), size, projection{});
+            res.probe_ns = measure(collection, opts, [size](std::vector<T>& copy) {
+                probe_sink = presortedness_class(copy.begin(), size, projection{});
+            });
+
+            for (const auto& name: opts.candidates) {
+                auto sorter = *std::find_if(
+                    sorters.begin(), sorters.end(),
+                    [&](const auto& entry) { return entry.name == name; }
+                );
+                double time = std::numeric_limits<double>::infinity();
+                try {
+                    // Warm-up run that also validates the result
+                    auto copy = collection;
+                    sorter.sort(copy);
+                    if (std::is_sorted(copy.begin(), copy.end())) {
+                        time = measure(collection, opts, sorter.sort);
+                    } else {
+                        std::cerr << "warning: " << name << " failed to sort "
+                                  << training.name << " (" << size << ")\n";
+                    }
+                } catch (const std::exception& exc) {
+                    std::cerr << "warning: " << name << " can't sort " << training.name
+                              << " (" << size << "): " << exc.what() << '\n';
+                }
+                res.times_ns.push_back(time);
+            }
+
+            if (std::isinf(*std::min_element(res.times_ns.begin(), res.times_ns.end()))) {
+                std::cerr << "warning: no candidate sorted " << training.name
+                          << " (" << size << "), ignoring it\n";
+                continue;
+            }
+            results.push_back(res);
+        }
+
+        if (results.empty()) {
+            throw std::runtime_error("no training data for size " + std::to_string(size));
+        }
+        return results;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Choice of the sorters
+
+    // Geometric mean over the matching cases of the cost relative
+    // to the fastest candidate: every case weighs the same no
+    // matter its absolute time
+    template<typename Predicate, typename Cost>
+    auto mean_slowdown(const std::vector<case_result>& results, Predicate matches, Cost cost)
+        -> double
+    {
+        double log_sum = 0.0;
+        std::size_t count = 0;
+        for (const auto& res: results) {
+            if (matches(res)) {
+                auto best = *std::min_element(res.times_ns.begin(), res.times_ns.end());
+                log_sum += std::log(cost(res) / best);
+                ++count;
+            }
+        }
+        return std::exp(log_sum / static_cast<double>(count));
+    }
+
+    struct choice
+    {
+        std::size_t candidate = 0;
+        double slowdown = std::numeric_limits<double>::infinity();
+    };
+
+    template<typename Predicate>
+    auto fastest_candidate(const std::vector<case_result>& results,
+                           std::size_t nb_candidates, Predicate matches)
+        -> choice
+    {
+        choice res;
+        for (std::size_t idx = 0 ; idx < nb_candidates ; ++idx) {
+            auto slowdown = mean_slowdown(results, matches, [idx](const case_result& result) {
+                return result.times_ns[idx];
+            });
+            if (slowdown < res.slowdown) {
+                res = { idx, slowdown };
+            }
+        }
+        return res;
+    }
+
+    // Candidate picked for each class of presortedness
+    using decision = std::vector<std::size_t>;
+
+    auto dispatches(const decision& dec)
+        -> bool
+    {
+        return std::adjacent_find(dec.begin(), dec.end(), std::not_equal_to<>{}) != dec.end();
+    }
+
+    // Pick the fastest candidate for each class of presortedness,
+    // unless a single candidate is faster on average than paying
+    // for the probes, then report the choice on the standard error
+    auto decide(const options& opts, long long int size, const std::vector<case_result>& results)
+        -> decision
+    {
+        auto nb_candidates = opts.candidates.size();
+        auto any = [](const case_result&) { return true; };
+        auto overall = fastest_candidate(results, nb_candidates, any);
+
+        std::cerr << std::fixed << std::setprecision(3) << "size " << size << ":\n";
+        decision res(nb_classes, overall.candidate);
+        for (int cls = 0 ; cls < nb_classes ; ++cls) {
+            auto in_class = [cls](const case_result& result) { return result.presortedness == cls; };
+            if (std::none_of(results.begin(), results.end(), in_class)) {
+                continue;
+            }
+            auto best = fastest_candidate(results, nb_candidates, in_class);
+            res[cls] = best.candidate;
+
+            std::cerr << "  " << std::left << std::setw(20) << class_names[cls]
+                      << std::setw(18) << opts.candidates[best.candidate]
+                      << std::right << best.slowdown << "x  (";
+            const char* separator = "";
+            for (const auto& result: results) {
+                if (in_class(result)) {
+                    std::cerr << separator << result.name;
+                    separator = ", ";
+                }
+            }
+            std::cerr << ")\n";
+        }
+
+        std::cerr << "  " << std::left << std::setw(20) << "single sorter"
+                  << std::setw(18) << opts.candidates[overall.candidate]
+                  << std::right << overall.slowdown << "x\n";
+        if (dispatches(res)) {
+            auto with_probes = mean_slowdown(results, any, [&res](const case_result& result) {
+                return result.times_ns[res[result.presortedness]] + result.probe_ns;
+            });
+            std::cerr << "  " << std::left << std::setw(38) << "dispatch with probes"
+                      << std::right << with_probes << "x\n";
+            if (with_probes >= overall.slowdown) {
+                res.assign(nb_classes, overall.candidate);
+            }
+        }
+        return res;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Code generation
+
+    // Headers and expression needed to call a registered sorter
+    auto sorter_type(const std::string& name)
+        -> std::string
+    {
+        for (std::string adapter: { "indirect", "schwartz" }) {
+            auto prefix = adapter + '_';
+            if (name.compare(0, prefix.size(), prefix) == 0) {
+                return "cppsort::" + adapter + "_adapter<cppsort::" + name.substr(prefix.size()) + "er>";
+            }
+        }
+        return "cppsort::" + name + "er";
+    }
+
+    auto sorter_code(const std::string& name, std::vector<std::string>& headers)
+        -> std::string
+    {
+        for (std::string adapter: { "indirect", "schwartz" }) {
+            auto prefix = adapter + '_';
+            if (name.compare(0, prefix.size(), prefix) == 0) {
+                headers.push_back("cpp-sort/adapters/" + adapter + "_adapter.h");
+                headers.push_back("cpp-sort/sorters/" + name.substr(prefix.size()) + "er.h");
+                return sorter_type(name) + "{}";
+            }
+        }
+        headers.push_back("cpp-sort/sorters/" + name + "er.h");
+        return "cppsort::" + name;
+    }
+
+    auto write_call(std::ostream& out, const std::string& indent,
+                    const std::string& sorter, bool with_return)
+        -> void
+    {
+        auto call = sorter + "(";
+        out << indent << call << "std::move(first), std::move(last),\n"
+            << indent << std::string(call.size(), ' ') << "std::move(compare), std::move(projection));\n";
+        if (with_return) {
+            out << indent << "return;\n";
+        }
+    }
+
+    struct size_range
+    {
+        long long int upper_bound;  // Exclusive, 0 when unbounded
+        decision choice;
+    };
+
+    auto write_header(std::ostream& out, const options& opts, const std::vector<size_range>& ranges)
+        -> void
+    {
+        bool uses_probes = std::any_of(ranges.begin(), ranges.end(), [](const size_range& range) {
+            return dispatches(range.choice);
+        });
+
+        std::vector<std::string> headers = {
+            "cpp-sort/sorter_facade.h",
+            "cpp-sort/sorter_traits.h",
+            "cpp-sort/utility/functional.h",
+            "cpp-sort/utility/static_const.h"
+        };
+        if (uses_probes) {
+            headers.push_back("cpp-sort/probes/mono.h");
+            headers.push_back("cpp-sort/probes/runs.h");
+        }
+        std::vector<std::string> expressions;
+        std::vector<std::string> used_types;
+        for (std::size_t idx = 0 ; idx < opts.candidates.size() ; ++idx) {
+            std::vector<std::string> candidate_headers;
+            expressions.push_back(sorter_code(opts.candidates[idx], candidate_headers));
+            bool used = std::any_of(ranges.begin(), ranges.end(), [idx](const size_range& range) {
+                return std::find(range.choice.begin(), range.choice.end(), idx) != range.choice.end();
+            });
+            if (used) {
+                headers.insert(headers.end(), candidate_headers.begin(), candidate_headers.end());
+                used_types.push_back(sorter_type(opts.candidates[idx]));
+            }
+        }
+        std::sort(headers.begin(), headers.end());
+        headers.erase(std::unique(headers.begin(), headers.end()), headers.end());
+
+        std::string guard;
+        for (char c: (opts.name_space.empty() ? "" : opts.name_space + '_') + opts.name + "_H_") {
+            guard += std::isalnum(static_cast<unsigned char>(c))
+                ? static_cast<char>(std::toupper(static_cast<unsigned char>(c)))
+                : '_';
+        }
+
+        out << "/*\n"
+            << " * Generated by cpp-sort-autotune, do not edit\n"
+            << " *\n"
+            << " * cpp-sort " << library_version() << ", " << compiler_name() << '\n'
+            << " * Element type: " << opts.type << ", seed: " << opts.seed << '\n'
+            << " * Candidates:";
+        for (const auto& name: opts.candidates) {
+            out << ' ' << name;
+        }
+        out << "\n * Training data:";
+        for (const auto& name: opts.distributions) {
+            out << ' ' << name;
+        }
+        if (not opts.sample_file.empty()) {
+            out << " sample(" << opts.sample_file << ')';
+        }
+        out << "\n * Training sizes:";
+        for (auto size: opts.sizes) {
+            out << ' ' << size;
+        }
+        out << "\n */\n"
+            << "#ifndef " << guard << '\n'
+            << "#define " << guard << "\n\n"
+            << "#include <algorithm>\n"
+            << "#include <functional>\n"
+            << "#include <iterator>\n"
+            << "#include <type_traits>\n"
+            << "#include <utility>\n";
+        for (const auto& header: headers) {
+            out << "#include <" << header << ">\n";
+        }
+        out << '\n';
+
+        // Indent everything when there is a namespace
+        std::string ns = opts.name_space.empty() ? "" : "    ";
+        if (not opts.name_space.empty()) {
+            out << "namespace " << opts.name_space << "\n{\n";
+        }
+
+        out << ns << "struct " << opts.name << "_impl\n"
+            << ns << "{\n";
+        if (uses_probes) {
+            out << ns << "    enum class presortedness\n"
+                << ns << "    {\n";
+            for (int cls = 0 ; cls < nb_classes ; ++cls) {
+                out << ns << "        " << class_names[cls] << (cls + 1 < nb_classes ? ",\n" : "\n");
+            }
+            out << ns << "    };\n"
+                << '\n'
+                << ns << "    // Measure of presortedness divided by its maximum, big\n"
+                << ns << "    // collections are only probed on a few windows\n"
+                << ns << "    template<typename RandomAccessIterator, typename Difference,\n"
+                << ns << "             typename Probe, typename Compare, typename Projection>\n"
+                << ns << "    static auto probe_ratio(RandomAccessIterator first, Difference size,\n"
+                << ns << "                            const Probe& probe, Compare compare, Projection projection)\n"
+                << ns << "        -> double\n"
+                << ns << "    {\n"
+                << ns << "        if (size <= " << probe_nb_windows * probe_window_size << ") {\n"
+                << ns << "            return static_cast<double>(probe(first, first + size, compare, projection))\n"
+                << ns << "                 / static_cast<double>(std::max<Difference>(probe.max_for_size(size), 1));\n"
+                << ns << "        }\n"
+                << ns << "        Difference measure = 0;\n"
+                << ns << "        for (Difference idx = 0 ; idx < " << probe_nb_windows << " ; ++idx) {\n"
+                << ns << "            auto window = first + idx * (size / " << probe_nb_windows << ");\n"
+                << ns << "            measure += probe(window, window + " << probe_window_size << ", compare, projection);\n"
+                << ns << "        }\n"
+                << ns << "        return static_cast<double>(measure)\n"
+                << ns << "             / static_cast<double>(" << probe_nb_windows
+                      << " * probe.max_for_size(Difference(" << probe_window_size << ")));\n"
+                << ns << "    }\n"
+                << '\n'
+                << ns << "    // Classification of the collection with the Mono and Runs\n"
+                << ns << "    // measures of presortedness, as done by the autotuner\n"
+                << ns << "    template<typename RandomAccessIterator, typename Difference,\n"
+                << ns << "             typename Compare, typename Projection>\n"
+                << ns << "    static auto presortedness_class(RandomAccessIterator first, Difference size,\n"
+                << ns << "                                    Compare compare, Projection projection)\n"
+                << ns << "        -> presortedness\n"
+                << ns << "    {\n"
+                << ns << "        auto mono_ratio = probe_ratio(first, size, cppsort::probe::mono, compare, projection);\n"
+                << ns << "        if (mono_ratio >= " << some_runs_threshold << ") {\n"
+                << ns << "            return presortedness::" << class_names[3] << ";\n"
+                << ns << "        }\n"
+                << ns << "        if (mono_ratio >= " << few_runs_threshold << ") {\n"
+                << ns << "            return presortedness::" << class_names[2] << ";\n"
+                << ns << "        }\n"
+                << ns << "        auto runs_ratio = probe_ratio(first, size, cppsort::probe::runs, compare, projection);\n"
+                << ns << "        return runs_ratio >= " << descending_threshold << "\n"
+                << ns << "            ? presortedness::" << class_names[1] << '\n'
+                << ns << "            : presortedness::" << class_names[0] << ";\n"
+                << ns << "    }\n"
+                << '\n';
+        }
+
+        // Only accept the comparators and projections that every
+        // sorter picked by the autotuner can handle, radix sorts
+        // notably only handle std::less<> and its equivalents
+        out << ns << "    template<\n"
+            << ns << "        typename RandomAccessIterator,\n"
+            << ns << "        typename Compare = std::less<>,\n"
+            << ns << "        typename Projection = cppsort::utility::identity,\n"
+            << ns << "        typename = std::enable_if_t<\n"
+            << ns << "            cppsort::is_projection_iterator_v<Projection, RandomAccessIterator, Compare>";
+        for (const auto& type: used_types) {
+            out << " &&\n"
+                << ns << "            cppsort::is_comparison_projection_sorter_iterator_v<\n"
+                << ns << "                " << type << ", RandomAccessIterator, Compare, Projection\n"
+                << ns << "            >";
+        }
+        out << '\n'
+            << ns << "        >\n"
+            << ns << "    >\n"
+            << ns << "    auto operator()(RandomAccessIterator first, RandomAccessIterator last,\n"
+            << ns << "                    Compare compare={}, Projection projection={}) const\n"
+            << ns << "        -> void\n"
+            << ns << "    {\n";
+        if (ranges.size() > 1 || uses_probes) {
+            out << ns << "        auto size = last - first;\n";
+        }
+
+        for (const auto& range: ranges) {
+            std::string indent = ns + "        ";
+            out << '\n';
+            if (range.upper_bound != 0) {
+                out << indent << "if (size < " << range.upper_bound << ") {\n";
+                indent += "    ";
+            }
+
+            if (not dispatches(range.choice)) {
+                write_call(out, indent, expressions[range.choice.front()], range.upper_bound != 0);
+            } else {
+                out << indent << "switch (presortedness_class(first, size, compare, projection)) {\n";
+                std::vector<bool> done(nb_classes, false);
+                for (int cls = 0 ; cls < nb_classes ; ++cls) {
+                    if (done[cls]) continue;
+                    // Group the classes handled by the same sorter
+                    for (int other = cls ; other < nb_classes ; ++other) {
+                        if (range.choice[other] == range.choice[cls]) {
+                            out << indent << "    case presortedness::" << class_names[other] << ":\n";
+                            done[other] = true;
+                        }
+                    }
+                    write_call(out, indent + "        ", expressions[range.choice[cls]], true);
+                }
+                out << indent << "}\n";
+            }
+
+            if (range.upper_bound != 0) {
+                out << ns << "        }\n";
+            }
+        }
+
+        out << ns << "    }\n"
+            << '\n'
+            << ns << "    ////////////////////////////////////////////////////////////\n"
+            << ns << "    // Sorter traits\n"
+            << '\n'
+            << ns << "    using iterator_category = std::random_access_iterator_tag;\n"
+            << ns << "    using is_always_stable = std::false_type;\n"
+            << ns << "};\n"
+            << '\n'
+            << ns << "struct " << opts.name << ":\n"
+            << ns << "    cppsort::sorter_facade<" << opts.name << "_impl>\n"
+            << ns << "{};\n";
+
+        // Sort function named after the sorter, as in the library
+        const std::string suffix = "_sorter";
+        if (opts.name.size() > suffix.size() &&
+            opts.name.compare(opts.name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            out << '\n'
+                << ns << "namespace\n"
+                << ns << "{\n"
+                << ns << "    constexpr auto&& " << opts.name.substr(0, opts.name.size() - 2) << '\n'
+                << ns << "        = cppsort::utility::static_const<" << opts.name << ">::value;\n"
+                << ns << "}\n";
+        }
+
+        if (not opts.name_space.empty()) {
+            out << "}\n";
+        }
+        out << "\n#endif // " << guard << '\n';
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Autotuning
+
+    template<typename T>
+    auto autotune(options& opts)
+        -> std::vector<size_range>
+    {
+        auto sorters = names_of(make_sorters<T>());
+        for (const auto& name: opts.candidates) {
+            if (std::find(sorters.begin(), sorters.end(), name) == sorters.end()) {
+                throw std::invalid_argument("candidate " + name + " can't sort " + opts.type);
+            }
+        }
+
+        std::vector<T> sample;
+        if (not opts.sample_file.empty()) {
+            sample = read_sample<T>(opts.sample_file);
+        }
+
+        // Without distributions, the sample bounds the training sizes
+        if (opts.distributions.empty()) {
+            auto too_big = std::upper_bound(opts.sizes.begin(), opts.sizes.end(),
+                                            static_cast<long long int>(sample.size()));
+            if (too_big == opts.sizes.begin()) {
+                throw std::runtime_error("the sample is smaller than every training size");
+            }
+            if (too_big != opts.sizes.end()) {
+                std::cerr << "warning: the sample is too small to train on sizes bigger than "
+                          << sample.size() << ", ignoring them\n";
+                opts.sizes.erase(too_big, opts.sizes.end());
+            }
+        }
+
+        std::vector<size_range> ranges;
+        for (std::size_t idx = 0 ; idx < opts.sizes.size() ; ++idx) {
+            auto size = opts.sizes[idx];
+            auto results = train(opts, sample, size);
+            auto choice = decide(opts, size, results);
+
+            // Split the sizes between two training sizes in the
+            // middle of their logarithms
+            long long int upper_bound = 0;
+            if (idx + 1 < opts.sizes.size()) {
+                upper_bound = std::llround(std::sqrt(static_cast<double>(size)
+                                                     * static_cast<double>(opts.sizes[idx + 1])));
+            }
+
+            // Merge consecutive ranges using the same sorters
+            if (not ranges.empty() && ranges.back().choice == choice) {
+                ranges.back().upper_bound = upper_bound;
+            } else {
+                ranges.push_back({ upper_bound, choice });
+            }
+        }
+        return ranges;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    options opts;
+    try {
+        opts = parse_options(argc, argv);
+        if (opts.help) {
+            std::cout << usage;
+            return 0;
+        }
+
+        opts.candidates = resolve_names(opts.candidates, all_sorter_names(), "sorter");
+        opts.distributions = resolve_names(opts.distributions,
+                                           names_of(make_distributions<int>()),
+                                           "distribution");
+        if (opts.distributions.empty() && opts.sample_file.empty()) {
+            throw std::invalid_argument("no training data");
+        }
+        auto types = type_names();
+        if (std::find(types.begin(), types.end(), opts.type) == types.end()) {
+            throw std::invalid_argument("unknown type " + opts.type);
+        }
+    } catch (const std::exception& exc) {
+        std::cerr << "error: " << exc.what() << "\n\n" << usage;
+        return 2;
+    }
+
+    std::vector<size_range> ranges;
+    try {
+        visit_type(opts.type, [&](auto tag) {
+            using value_type = typename decltype(tag)::type;
+            ranges = autotune<value_type>(opts);
+        });
+    } catch (const std::exception& exc) {
+        std::cerr << "error: " << exc.what() << '\n';
+        return 1;
+    }
+
+    std::ofstream file;
+    if (not opts.output.empty()) {
+        file.open(opts.output);
+        if (not file) {
+            std::cerr << "error: can't open " << opts.output << '\n';
+            return 1;
+        }
+    }
+    write_header(opts.output.empty() ? std::cout : file, opts, ranges);
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <cpp-sort/version.h>
+#include "registry.h"
+
+////////////////////////////////////////////////////////////
+// Helpers shared by the benchmark driver and the autotuner
+
+namespace
+{
+    // Split a comma-separated list, ignoring empty items
+    auto split(const std::string& str)
+        -> std::vector<std::string>
+    {
+        std::vector<std::string> res;
+        std::istringstream stream(str);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (not item.empty()) {
+                res.push_back(item);
+            }
+        }
+        return res;
+    }
+
+    // Replace "all" by every available name and check that
+    // the requested names exist
+    auto resolve_names(const std::vector<std::string>& requested,
+                       const std::vector<std::string>& available,
+                       const std::string& kind)
+        -> std::vector<std::string>
+    {
+        if (requested.size() == 1 && requested.front() == "all") {
+            return available;
+        }
+        for (const auto& name: requested) {
+            if (std::find(available.begin(), available.end(), name) == available.end()) {
+                throw std::invalid_argument("unknown " + kind + " " + name);
+            }
+        }
+        return requested;
+    }
+
+    template<typename Entries>
+    auto names_of(const Entries& entries)
+        -> std::vector<std::string>
+    {
+        std::vector<std::string> res;
+        for (const auto& entry: entries) {
+            res.push_back(entry.name);
+        }
+        return res;
+    }
+
+    // Sorters registered for at least one element type
+    auto all_sorter_names()
+        -> std::vector<std::string>
+    {
+        std::vector<std::string> res;
+        for (const auto& type: type_names()) {
+            visit_type(type, [&](auto tag) {
+                using value_type = typename decltype(tag)::type;
+                for (const auto& name: names_of(make_sorters<value_type>())) {
+                    if (std::find(res.begin(), res.end(), name) == res.end()) {
+                        res.push_back(name);
+                    }
+                }
+            });
+        }
+        return res;
+    }
+
+    auto library_version()
+        -> std::string
+    {
+        return std::to_string(CPPSORT_VERSION_MAJOR) + '.'
+             + std::to_string(CPPSORT_VERSION_MINOR) + '.'
+             + std::to_string(CPPSORT_VERSION_PATCH);
+    }
+
+    auto compiler_name()
+        -> std::string
+    {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    // Always use a steady clock
+    using clock_type = std::conditional_t<
+        std::chrono::high_resolution_clock::is_steady,
+        std::chrono::high_resolution_clock,
+        std::chrono::steady_clock
+    >;
+}
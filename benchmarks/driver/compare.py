@@ -0,0 +1,192 @@
+# -*- coding: utf-8 -*-
+
+# Copyright (c) 2021 Morwenn
+# SPDX-License-Identifier: MIT
+
+"""
+Compare two JSON result files produced by cpp-sort-bench, typically
+generated from two commits or with two compilers, and flag the
+benchmarks where the candidate is significantly slower than the
+baseline.
+
+For every (sorter, distribution, type, size) cell present in both
+files, the raw timings are compared with a two-sided Mann-Whitney U
+test, and a bootstrap confidence interval is computed for the relative
+change of the median time. A cell is a regression when the test is
+significant and the median time grew by more than the threshold, and
+an improvement in the symmetric case. The exit status is 1 when at
+least one regression was found, which makes the script usable as a
+performance gate in CI.
+
+Only the Python standard library is required.
+"""
+
+import argparse
+import json
+import math
+import random
+import statistics
+import sys
+
+
+def load_results(path):
+    with open(path) as fd:
+        data = json.load(fd)
+    results = {}
+    for res in data['results']:
+        key = (res['sorter'], res['distribution'], res['type'], res['size'])
+        results[key] = res['time_ns'].get('samples', [])
+    return data['context'], results
+
+
+def mann_whitney_exact_cdf(n1, n2):
+    """
+    Distribution of the U statistic without ties: counts[u] is the number
+    of arrangements of n1 + n2 elements for which U == u.
+    """
+    # counts[m][u] for the current number of elements of the second sample
+    prev = [[1] + [0] * (n1 * n2) for _ in range(n1 + 1)]
+    for n in range(1, n2 + 1):
+        cur = [[1] + [0] * (n1 * n2)]
+        for m in range(1, n1 + 1):
+            row = [0] * (n1 * n2 + 1)
+            for u in range(m * n + 1):
+                # The biggest element belongs to either the first sample,
+                # adding n to U, or to the second one
+                row[u] = prev[m][u] + (cur[m - 1][u - n] if u >= n else 0)
+            cur.append(row)
+        prev = cur
+    return prev[n1]
+
+
+def mann_whitney_u(sample1, sample2):
+    """
+    Two-sided Mann-Whitney U test, returns the p-value. The exact
+    distribution is used for small samples without ties, the normal
+    approximation with tie and continuity corrections otherwise.
+    """
+    n1, n2 = len(sample1), len(sample2)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+
+    # Rank the pooled samples, averaging the ranks of ties
+    pooled = sorted([(value, 0) for value in sample1] + [(value, 1) for value in sample2])
+    ranks = [0.0] * len(pooled)
+    tie_term = 0
+    idx = 0
+    while idx < len(pooled):
+        end = idx
+        while end + 1 < len(pooled) and pooled[end + 1][0] == pooled[idx][0]:
+            end += 1
+        for pos in range(idx, end + 1):
+            ranks[pos] = (idx + end) / 2.0 + 1.0
+        ties = end - idx + 1
+        tie_term += ties ** 3 - ties
+        idx = end + 1
+
+    rank_sum1 = sum(rank for rank, (_, origin) in zip(ranks, pooled) if origin == 0)
+    u1 = rank_sum1 - n1 * (n1 + 1) / 2.0
+    mean_u = n1 * n2 / 2.0
+
+    if tie_term == 0 and n1 <= 20 and n2 <= 20:
+        counts = mann_whitney_exact_cdf(n1, n2)
+        total = sum(counts)
+        u = int(round(u1))
+        lower = sum(counts[:u + 1]) / total
+        upper = sum(counts[u:]) / total
+        return min(1.0, 2.0 * min(lower, upper))
+
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0.0:
+        # Every value is the same
+        return 1.0
+    z = (abs(u1 - mean_u) - 0.5) / math.sqrt(variance)
+    return math.erfc(max(z, 0.0) / math.sqrt(2.0))
+
+
+def bootstrap_median_change(baseline, candidate, confidence, iterations, rng):
+    """
+    Percentile bootstrap confidence interval of the relative change of
+    the median, median(candidate) / median(baseline) - 1.
+    """
+    changes = []
+    for _ in range(iterations):
+        base = statistics.median(rng.choices(baseline, k=len(baseline)))
+        cand = statistics.median(rng.choices(candidate, k=len(candidate)))
+        changes.append(cand / base - 1.0)
+    changes.sort()
+    tail = (1.0 - confidence) / 2.0
+    lower = changes[int(tail * (iterations - 1))]
+    upper = changes[int(math.ceil((1.0 - tail) * (iterations - 1)))]
+    return lower, upper
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two result files of cpp-sort-bench.")
+    parser.add_argument('baseline', help="JSON results of the reference version")
+    parser.add_argument('candidate', help="JSON results of the version to check")
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help="minimal change of the median time to report, in percent (default: 5)")
+    parser.add_argument('--alpha', type=float, default=0.01,
+                        help="significance level of the tests, the confidence intervals "
+                             "are computed at the level 1 - alpha (default: 0.01)")
+    parser.add_argument('--bootstrap', type=int, default=2000,
+                        help="number of bootstrap resamplings (default: 2000)")
+    parser.add_argument('--seed', type=int, default=0,
+                        help="seed of the bootstrap resampling (default: 0)")
+    args = parser.parse_args()
+
+    base_context, base_results = load_results(args.baseline)
+    cand_context, cand_results = load_results(args.candidate)
+    print(f"baseline:  cpp-sort {base_context['library_version']}, {base_context['compiler']}")
+    print(f"candidate: cpp-sort {cand_context['library_version']}, {cand_context['compiler']}")
+    print()
+
+    rng = random.Random(args.seed)
+    threshold = args.threshold / 100.0
+    header = (f"{'sorter':<22} {'distribution':<22} {'type':<7} {'size':>10} "
+              f"{'baseline':>14} {'candidate':>14} {'change':>8} {'interval':>19} {'p-value':>8}  verdict")
+    print(header)
+    print('-' * len(header))
+
+    nb_regressions = 0
+    nb_improvements = 0
+    for key in sorted(base_results.keys() & cand_results.keys()):
+        baseline, candidate = base_results[key], cand_results[key]
+        if not baseline or not candidate:
+            print(f"{key[0]:<22} {key[1]:<22} {key[2]:<7} {key[3]:>10}  no timing samples")
+            continue
+
+        base_median = statistics.median(baseline)
+        cand_median = statistics.median(candidate)
+        change = cand_median / base_median - 1.0
+        lower, upper = bootstrap_median_change(baseline, candidate, 1.0 - args.alpha,
+                                               args.bootstrap, rng)
+        p_value = mann_whitney_u(baseline, candidate)
+
+        verdict = ''
+        if p_value < args.alpha and change > threshold:
+            verdict = 'REGRESSION'
+            nb_regressions += 1
+        elif p_value < args.alpha and change < -threshold:
+            verdict = 'improvement'
+            nb_improvements += 1
+
+        interval = f"[{lower * 100:+.1f}%, {upper * 100:+.1f}%]"
+        print(f"{key[0]:<22} {key[1]:<22} {key[2]:<7} {key[3]:>10} "
+              f"{base_median:>14.0f} {cand_median:>14.0f} {change * 100:>+7.1f}% "
+              f"{interval:>19} {p_value:>8.4f}  {verdict}")
+
+    for key in sorted(base_results.keys() ^ cand_results.keys()):
+        origin = 'baseline' if key in base_results else 'candidate'
+        print(f"{key[0]:<22} {key[1]:<22} {key[2]:<7} {key[3]:>10}  only in {origin}")
+
+    print()
+    print(f"{nb_regressions} regression(s), {nb_improvements} improvement(s) "
+          f"with a threshold of {args.threshold}% at alpha = {args.alpha}")
+    sys.exit(1 if nb_regressions > 0 else 0)
+
+
+if __name__ == '__main__':
+    main()
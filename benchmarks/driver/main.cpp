@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "common.h"
+#include "counters.h"
+#include "rdtsc.h"
+#include "report.h"
+
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Command line options
+
+    struct options
+    {
+        std::vector<std::string> sorters = { "pdq_sort", "std_sort" };
+        std::vector<std::string> distributions = { "shuffled" };
+        std::vector<long long int> sizes = { 1'000'000 };
+        std::vector<std::string> types = { "int32" };
+        std::vector<std::string> counters = { "all" };
+        std::size_t repetitions = 100;
+        double max_time_s = 5.0;
+        unsigned long long seed = static_cast<unsigned long long>(std::time(nullptr));
+        std::string format = "json";
+        std::string output;
+        bool list = false;
+        bool help = false;
+    };
+
+    constexpr const char* usage =
+        "Usage: cpp-sort-bench [options]\n"
+        "\n"
+        "Benchmarks every combination of the selected sorters, distributions,\n"
+        "sizes and element types, and writes the results as JSON or CSV.\n"
+        "\n"
+        "Options:\n"
+        "  --sorters a,b,...        sorters to benchmark (default: pdq_sort,std_sort)\n"
+        "  --distributions a,b,...  distributions to sort (default: shuffled)\n"
+        "  --sizes n,m,...          sizes of the collections (default: 1000000)\n"
+        "  --types a,b,...          types of the elements (default: int32)\n"
+        "  --counters a,b,...|none  performance counters to read (default: all)\n"
+        "  --repetitions n          maximum number of runs per benchmark (default: 100)\n"
+        "  --max-time s             maximum time in seconds per benchmark (default: 5)\n"
+        "  --seed n                 seed of the distributions (default: current time)\n"
+        "  --format json|csv        output format (default: json)\n"
+        "  --output file            output file (default: standard output)\n"
+        "  --list                   list the available sorters, distributions and types\n"
+        "  --help                   display this message\n"
+        "\n"
+        "The value \"all\" selects every available sorter, distribution, type or\n"
+        "performance counter. Performance counters are reported per element and\n"
+        "only on Linux, when perf_event_open can access them.\n";
+
+    auto parse_options(int argc, char* argv[])
+        -> options
+    {
+        options opts;
+        for (int idx = 1 ; idx < argc ; ++idx) {
+            std::string arg = argv[idx];
+            if (arg == "--help") {
+                opts.help = true;
+                continue;
+            }
+            if (arg == "--list") {
+                opts.list = true;
+                continue;
+            }
+
+            if (idx + 1 == argc) {
+                throw std::invalid_argument("missing value for option " + arg);
+            }
+            std::string value = argv[++idx];
+
+            if (arg == "--sorters") {
+                opts.sorters = split(value);
+            } else if (arg == "--distributions") {
+                opts.distributions = split(value);
+            } else if (arg == "--sizes") {
+                opts.sizes.clear();
+                for (const auto& size: split(value)) {
+                    opts.sizes.push_back(std::stoll(size));
+                    if (opts.sizes.back() <= 0) {
+                        throw std::invalid_argument("sizes must be positive");
+                    }
+                }
+            } else if (arg == "--types") {
+                opts.types = split(value);
+            } else if (arg == "--counters") {
+                opts.counters = split(value);
+            } else if (arg == "--repetitions") {
+                opts.repetitions = std::stoul(value);
+            } else if (arg == "--max-time") {
+                opts.max_time_s = std::stod(value);
+            } else if (arg == "--seed") {
+                opts.seed = std::stoull(value);
+            } else if (arg == "--format") {
+                if (value != "json" && value != "csv") {
+                    throw std::invalid_argument("unknown output format " + value);
+                }
+                opts.format = value;
+            } else if (arg == "--output") {
+                opts.output = value;
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+        return opts;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Benchmark loop
+
+    template<typename T>
+    auto run_benchmarks(const options& opts, const std::string& type,
+                        performance_counters& counters,
+                        std::vector<benchmark_result>& results)
+        -> bool
+    {
+        auto sorters = make_sorters<T>();
+        auto distributions = make_distributions<T>();
+        bool success = true;
+
+        for (const auto& distribution_name: opts.distributions) {
+            auto distribution = std::find_if(
+                distributions.begin(), distributions.end(),
+                [&](const auto& entry) { return entry.name == distribution_name; }
+            );
+
+            for (const auto& sorter_name: opts.sorters) {
+                auto sorter = std::find_if(
+                    sorters.begin(), sorters.end(),
+                    [&](const auto& entry) { return entry.name == sorter_name; }
+                );
+                if (sorter == sorters.end()) {
+                    std::cerr << "skipping " << sorter_name << ": can't sort " << type << '\n';
+                    continue;
+                }
+
+                for (auto size: opts.sizes) {
+                    // Seed the distribution manually to ensure that all algorithms
+                    // sort the same collections when there is randomness
+                    distributions_prng.seed(opts.seed);
+
+                    std::vector<double> times;
+                    std::vector<double> cycles;
+                    std::vector<std::vector<double>> counts(counters.names().size());
+                    auto max_time = std::chrono::duration<double>(opts.max_time_s);
+                    auto total_start = clock_type::now();
+                    bool sorted = true;
+                    try {
+                        do {
+                            std::vector<T> collection;
+                            collection.reserve(static_cast<std::size_t>(size));
+                            distribution->generate(collection, size);
+
+                            counters.start();
+                            auto start = clock_type::now();
+                            std::uint64_t cycles_start = rdtsc();
+                            sorter->sort(collection);
+                            std::uint64_t cycles_end = rdtsc();
+                            auto end = clock_type::now();
+                            auto counter_values = counters.stop();
+
+                            times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+                            cycles.push_back(static_cast<double>(cycles_end - cycles_start));
+                            for (std::size_t idx = 0 ; idx < counter_values.size() ; ++idx) {
+                                // Multiplexed counters might not have run at all
+                                if (std::isfinite(counter_values[idx])) {
+                                    counts[idx].push_back(counter_values[idx] / static_cast<double>(size));
+                                }
+                            }
+
+                            sorted = std::is_sorted(collection.begin(), collection.end());
+                        } while (sorted && times.size() < opts.repetitions &&
+                                 clock_type::now() - total_start < max_time);
+                    } catch (const std::exception& exc) {
+                        // Some sorters can't handle some inputs, for example
+                        // counting_sort with a huge range of values
+                        std::cerr << "skipping " << sorter_name << " with " << distribution_name
+                                  << " (" << type << ", " << size << "): " << exc.what() << '\n';
+                        continue;
+                    }
+
+                    if (not sorted) {
+                        std::cerr << "error: " << sorter_name << " failed to sort " << distribution_name
+                                  << " (" << type << ", " << size << ")\n";
+                        success = false;
+                        continue;
+                    }
+
+                    benchmark_result res;
+                    res.sorter = sorter_name;
+                    res.distribution = distribution_name;
+                    res.type = type;
+                    res.size = size;
+                    res.runs = times.size();
+                    res.time_ns = summarize(times);
+                    res.time_samples_ns = times;
+                    res.cycles = summarize(cycles);
+                    for (const auto& values: counts) {
+                        res.counters.push_back(summarize(values));
+                    }
+                    results.push_back(res);
+
+                    std::cerr << type << ", " << distribution_name << ", " << sorter_name
+                              << ", " << size << ": " << std::fixed << std::setprecision(0)
+                              << res.time_ns.median << " ns ("
+                              << res.runs << " runs)\n";
+                }
+            }
+        }
+        return success;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    options opts;
+    try {
+        opts = parse_options(argc, argv);
+        if (opts.help) {
+            std::cout << usage;
+            return 0;
+        }
+
+        auto sorter_names = all_sorter_names();
+        auto distribution_names = names_of(make_distributions<int>());
+        if (opts.list) {
+            std::cout << "sorters:";
+            for (const auto& name: sorter_names) std::cout << ' ' << name;
+            std::cout << "\ndistributions:";
+            for (const auto& name: distribution_names) std::cout << ' ' << name;
+            std::cout << "\ntypes:";
+            for (const auto& name: type_names()) std::cout << ' ' << name;
+            std::cout << "\ncounters:";
+            for (const auto& name: counter_names()) std::cout << ' ' << name;
+            std::cout << '\n';
+            return 0;
+        }
+
+        opts.sorters = resolve_names(opts.sorters, sorter_names, "sorter");
+        opts.distributions = resolve_names(opts.distributions, distribution_names, "distribution");
+        opts.types = resolve_names(opts.types, type_names(), "type");
+        if (opts.counters.size() == 1 && opts.counters.front() == "none") {
+            opts.counters.clear();
+        }
+        opts.counters = resolve_names(opts.counters, counter_names(), "counter");
+    } catch (const std::exception& exc) {
+        std::cerr << "error: " << exc.what() << "\n\n" << usage;
+        return 2;
+    }
+
+    benchmark_context context;
+    context.library_version = library_version();
+    context.compiler = compiler_name();
+#if RDTSC_IS_CYCLE_COUNTER
+    context.cycle_counter = "rdtsc";
+#endif
+    context.seed = opts.seed;
+    context.repetitions = opts.repetitions;
+    context.max_time_s = opts.max_time_s;
+
+    performance_counters counters(opts.counters);
+    for (const auto& name: counters.unavailable()) {
+        std::cerr << "counter unavailable: " << name << '\n';
+    }
+    context.counters = counters.names();
+
+    std::vector<benchmark_result> results;
+    bool success = true;
+    for (const auto& type: opts.types) {
+        visit_type(type, [&](auto tag) {
+            using value_type = typename decltype(tag)::type;
+            success &= run_benchmarks<value_type>(opts, type, counters, results);
+        });
+    }
+
+    std::ofstream file;
+    if (not opts.output.empty()) {
+        file.open(opts.output);
+        if (not file) {
+            std::cerr << "error: can't open " << opts.output << '\n';
+            return 1;
+        }
+    }
+    std::ostream& out = opts.output.empty() ? std::cout : file;
+
+    if (opts.format == "json") {
+        write_json(out, context, results);
+    } else {
+        write_csv(out, context, results);
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/adapters/indirect_adapter.h>
+#include <cpp-sort/adapters/schwartz_adapter.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/sorters.h>
+#include <cpp-sort/utility/functional.h>
+#include "distributions.h"
+#include "records.h"
+
+////////////////////////////////////////////////////////////
+// Element types
+//
+// Arithmetic types are generated and sorted directly, while
+// records are created from the generated values and sorted
+// on their key with a projection, which notably allows to
+// sort them with radix sorts.
+
+template<typename T>
+struct element_traits
+{
+    using make_value = cppsort::utility::identity;
+    using projection = cppsort::utility::identity;
+
+    template<typename Sorter>
+    static constexpr auto can_sort()
+        -> bool
+    {
+        return cppsort::is_sorter_v<Sorter, std::vector<T>>;
+    }
+
+    template<typename Sorter>
+    static auto sort(const Sorter& sorter, std::vector<T>& collection)
+        -> void
+    {
+        sorter(collection);
+    }
+};
+
+template<std::size_t Size>
+struct element_traits<record<Size>>
+{
+    using make_value = make_record<record<Size>>;
+    using projection = record_key;
+
+    template<typename Sorter>
+    static constexpr auto can_sort()
+        -> bool
+    {
+        return cppsort::is_projection_sorter_v<Sorter, std::vector<record<Size>>, projection>;
+    }
+
+    template<typename Sorter>
+    static auto sort(const Sorter& sorter, std::vector<record<Size>>& collection)
+        -> void
+    {
+        sorter(collection, projection{});
+    }
+};
+
+////////////////////////////////////////////////////////////
+// Named sorters
+//
+// Every sorter is registered under the name of its sort
+// function, and only for the element types it can sort.
+// A few adapted sorters are registered too in order to
+// measure the trade-off between moves and comparisons.
+
+template<typename T>
+struct sorter_entry
+{
+    std::string name;
+    std::function<void(std::vector<T>&)> sort;
+};
+
+template<typename T, typename Sorter>
+auto add_sorter(std::vector<sorter_entry<T>>& sorters, const char* name, Sorter sorter)
+    -> std::enable_if_t<element_traits<T>::template can_sort<Sorter>()>
+{
+    sorters.push_back({
+        name,
+        [sorter](std::vector<T>& collection) { element_traits<T>::sort(sorter, collection); }
+    });
+}
+
+template<typename T, typename Sorter>
+auto add_sorter(std::vector<sorter_entry<T>>&, const char*, Sorter)
+    -> std::enable_if_t<not element_traits<T>::template can_sort<Sorter>()>
+{}
+
+template<typename T>
+auto make_sorters()
+    -> std::vector<sorter_entry<T>>
+{
+    std::vector<sorter_entry<T>> sorters;
+    add_sorter<T>(sorters, "block_sort",            cppsort::block_sort);
+    add_sorter<T>(sorters, "cartesian_tree_sort",   cppsort::cartesian_tree_sort);
+    add_sorter<T>(sorters, "counting_sort",         cppsort::counting_sort);
+    add_sorter<T>(sorters, "drop_merge_sort",       cppsort::drop_merge_sort);
+    add_sorter<T>(sorters, "grail_sort",            cppsort::grail_sort);
+    add_sorter<T>(sorters, "heap_sort",             cppsort::heap_sort);
+    add_sorter<T>(sorters, "insertion_sort",        cppsort::insertion_sort);
+    add_sorter<T>(sorters, "lsd_radix_sort",        cppsort::lsd_radix_sort);
+    add_sorter<T>(sorters, "mel_sort",              cppsort::mel_sort);
+    add_sorter<T>(sorters, "merge_insertion_sort",  cppsort::merge_insertion_sort);
+    add_sorter<T>(sorters, "merge_sort",            cppsort::merge_sort);
+    add_sorter<T>(sorters, "parallel_merge_sort",   cppsort::parallel_merge_sort);
+    add_sorter<T>(sorters, "parallel_pdq_sort",     cppsort::parallel_pdq_sort);
+    add_sorter<T>(sorters, "parallel_ska_sort",     cppsort::parallel_ska_sort);
+    add_sorter<T>(sorters, "pdq_sort",              cppsort::pdq_sort);
+    add_sorter<T>(sorters, "poplar_sort",           cppsort::poplar_sort);
+    add_sorter<T>(sorters, "quick_merge_sort",      cppsort::quick_merge_sort);
+    add_sorter<T>(sorters, "quick_sort",            cppsort::quick_sort);
+    add_sorter<T>(sorters, "selection_sort",        cppsort::selection_sort);
+    add_sorter<T>(sorters, "simd_quick_sort",       cppsort::simd_quick_sort);
+    add_sorter<T>(sorters, "ska_sort",              cppsort::ska_sort);
+    add_sorter<T>(sorters, "slab_sort",             cppsort::slab_sort);
+    add_sorter<T>(sorters, "smooth_sort",           cppsort::smooth_sort);
+    add_sorter<T>(sorters, "spin_sort",             cppsort::spin_sort);
+    add_sorter<T>(sorters, "split_sort",            cppsort::split_sort);
+    add_sorter<T>(sorters, "spread_sort",           cppsort::spread_sort);
+    add_sorter<T>(sorters, "std_sort",              cppsort::std_sort);
+    add_sorter<T>(sorters, "tim_sort",              cppsort::tim_sort);
+    add_sorter<T>(sorters, "verge_sort",            cppsort::verge_sort);
+
+    add_sorter<T>(sorters, "indirect_pdq_sort",     cppsort::indirect_adapter<cppsort::pdq_sorter>{});
+    add_sorter<T>(sorters, "indirect_spin_sort",    cppsort::indirect_adapter<cppsort::spin_sorter>{});
+    add_sorter<T>(sorters, "schwartz_pdq_sort",     cppsort::schwartz_adapter<cppsort::pdq_sorter>{});
+    add_sorter<T>(sorters, "schwartz_spin_sort",    cppsort::schwartz_adapter<cppsort::spin_sorter>{});
+    return sorters;
+}
+
+////////////////////////////////////////////////////////////
+// Named distributions
+
+template<typename T>
+struct distribution_entry
+{
+    std::string name;
+    std::function<void(std::vector<T>&, long long int)> generate;
+};
+
+template<typename T, typename Distribution>
+auto make_distribution(const char* name, Distribution distribution)
+    -> distribution_entry<T>
+{
+    return {
+        name,
+        [distribution](std::vector<T>& collection, long long int size) {
+            using make_value = typename element_traits<T>::make_value;
+            distribution(std::back_inserter(collection), size, make_value{});
+        }
+    };
+}
+
+template<typename T>
+auto make_distributions()
+    -> std::vector<distribution_entry<T>>
+{
+    return {
+        make_distribution<T>("shuffled",                dist::shuffled{}),
+        make_distribution<T>("shuffled_16_values",      dist::shuffled_16_values{}),
+        make_distribution<T>("all_equal",               dist::all_equal{}),
+        make_distribution<T>("ascending",               dist::ascending{}),
+        make_distribution<T>("descending",              dist::descending{}),
+        make_distribution<T>("pipe_organ",              dist::pipe_organ{}),
+        make_distribution<T>("push_front",              dist::push_front{}),
+        make_distribution<T>("push_middle",             dist::push_middle{}),
+        make_distribution<T>("ascending_sawtooth",      dist::ascending_sawtooth{}),
+        make_distribution<T>("descending_sawtooth",     dist::descending_sawtooth{}),
+        make_distribution<T>("alternating",             dist::alternating{}),
+        make_distribution<T>("reversed_alternating",    dist::reversed_alternating{}),
+        make_distribution<T>("descending_plateau",      dist::descending_plateau{}),
+        make_distribution<T>("inversions_1",            dist::inversions(0.01)),
+        make_distribution<T>("inversions_10",           dist::inversions(0.1)),
+        make_distribution<T>("vergesort_killer",        dist::vergesort_killer{}),
+        make_distribution<T>("zipf_1.0",                dist::zipf(1.0)),
+        make_distribution<T>("zipf_1.5",                dist::zipf(1.5)),
+        make_distribution<T>("bounded_disorder_16",     dist::bounded_disorder(16)),
+        make_distribution<T>("bounded_disorder_4096",   dist::bounded_disorder(4096)),
+        make_distribution<T>("clustered",               dist::clustered(16)),
+    };
+}
+
+////////////////////////////////////////////////////////////
+// Named element types
+//
+// The benchmark code is a generic function object called
+// with a tag corresponding to the type of the elements to
+// sort: only the types below are instantiated.
+
+template<typename T>
+struct type_tag
+{
+    using type = T;
+};
+
+inline auto type_names()
+    -> std::vector<std::string>
+{
+    return { "int32", "int64", "uint32", "uint64", "float", "double", "record64", "record256" };
+}
+
+template<typename Func>
+auto visit_type(const std::string& name, Func&& func)
+    -> bool
+{
+    if (name == "int32") {
+        func(type_tag<std::int32_t>{});
+    } else if (name == "int64") {
+        func(type_tag<std::int64_t>{});
+    } else if (name == "uint32") {
+        func(type_tag<std::uint32_t>{});
+    } else if (name == "uint64") {
+        func(type_tag<std::uint64_t>{});
+    } else if (name == "float") {
+        func(type_tag<float>{});
+    } else if (name == "double") {
+        func(type_tag<double>{});
+    } else if (name == "record64") {
+        func(type_tag<record<64>>{});
+    } else if (name == "record256") {
+        func(type_tag<record<256>>{});
+    } else {
+        return false;
+    }
+    return true;
+}
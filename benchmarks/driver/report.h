@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstddef>
+#include <cstdio>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "statistics.h"
+
+////////////////////////////////////////////////////////////
+// Benchmark results
+
+// Robust summary of a series of measures
+struct summary
+{
+    double median = 0.0;
+    double mad = 0.0;
+    double min = 0.0;
+};
+
+template<typename Iterable>
+auto summarize(const Iterable& values)
+    -> summary
+{
+    summary res;
+    res.median = median(values);
+    res.mad = median_absolute_deviation(values, res.median);
+    res.min = minimum(values);
+    return res;
+}
+
+struct benchmark_result
+{
+    std::string sorter;
+    std::string distribution;
+    std::string type;
+    long long int size = 0;
+    std::size_t runs = 0;
+    summary time_ns;
+    // Raw timings, needed to compare results statistically
+    std::vector<double> time_samples_ns;
+    // Only meaningful when the context has a cycle counter
+    summary cycles;
+    // Performance counters divided by the size of the collection,
+    // in the same order as the counters of the context
+    std::vector<summary> counters;
+};
+
+// Description of the conditions under which the results
+// were produced, required to compare results across
+// releases and toolchains
+struct benchmark_context
+{
+    std::string library_version;
+    std::string compiler;
+    std::string cycle_counter;  // Empty when there is none
+    std::vector<std::string> counters;
+    unsigned long long seed = 0;
+    std::size_t repetitions = 0;
+    double max_time_s = 0.0;
+};
+
+////////////////////////////////////////////////////////////
+// JSON output
+
+inline auto json_string(const std::string& str)
+    -> std::string
+{
+    std::string res = "\"";
+    for (char c: str) {
+        switch (c) {
+            case '"':  res += "\\\""; break;
+            case '\\': res += "\\\\"; break;
+            case '\n': res += "\\n";  break;
+            case '\t': res += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof buffer, "\\u%04x", static_cast<unsigned>(c));
+                    res += buffer;
+                } else {
+                    res += c;
+                }
+        }
+    }
+    res += '"';
+    return res;
+}
+
+inline auto write_json_summary(std::ostream& out, const summary& sum,
+                               const std::vector<double>* samples=nullptr)
+    -> void
+{
+    out << "{ \"median\": " << sum.median
+        << ", \"mad\": " << sum.mad
+        << ", \"min\": " << sum.min;
+    if (samples) {
+        out << ", \"samples\": [";
+        for (std::size_t idx = 0 ; idx < samples->size() ; ++idx) {
+            out << (idx == 0 ? "" : ", ") << (*samples)[idx];
+        }
+        out << ']';
+    }
+    out << " }";
+}
+
+inline auto write_json(std::ostream& out, const benchmark_context& context,
+                       const std::vector<benchmark_result>& results)
+    -> void
+{
+    bool has_cycles = not context.cycle_counter.empty();
+
+    // Avoid the scientific notation for large timings, and keep
+    // enough decimals for small counts per element
+    out << std::fixed << std::setprecision(3);
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"library_version\": " << json_string(context.library_version) << ",\n"
+        << "    \"compiler\": " << json_string(context.compiler) << ",\n"
+        << "    \"cycle_counter\": "
+            << (has_cycles ? json_string(context.cycle_counter) : "null") << ",\n"
+        << "    \"counters\": [";
+    for (std::size_t idx = 0 ; idx < context.counters.size() ; ++idx) {
+        out << (idx == 0 ? "" : ", ") << json_string(context.counters[idx]);
+    }
+    out << "],\n"
+        << "    \"seed\": " << context.seed << ",\n"
+        << "    \"repetitions\": " << context.repetitions << ",\n"
+        << "    \"max_time_s\": " << context.max_time_s << "\n"
+        << "  },\n"
+        << "  \"results\": [";
+
+    for (std::size_t idx = 0 ; idx < results.size() ; ++idx) {
+        const auto& res = results[idx];
+        out << (idx == 0 ? "\n" : ",\n")
+            << "    {\n"
+            << "      \"sorter\": " << json_string(res.sorter) << ",\n"
+            << "      \"distribution\": " << json_string(res.distribution) << ",\n"
+            << "      \"type\": " << json_string(res.type) << ",\n"
+            << "      \"size\": " << res.size << ",\n"
+            << "      \"runs\": " << res.runs << ",\n"
+            << "      \"time_ns\": ";
+        write_json_summary(out, res.time_ns, &res.time_samples_ns);
+        out << ",\n"
+            << "      \"cycles\": ";
+        if (has_cycles) {
+            write_json_summary(out, res.cycles);
+        } else {
+            out << "null";
+        }
+        out << ",\n"
+            << "      \"counters_per_element\": {";
+        for (std::size_t counter = 0 ; counter < res.counters.size() ; ++counter) {
+            out << (counter == 0 ? "\n" : ",\n")
+                << "        " << json_string(context.counters[counter]) << ": ";
+            write_json_summary(out, res.counters[counter]);
+        }
+        out << (res.counters.empty() ? "}" : "\n      }")
+            << "\n    }";
+    }
+    out << (results.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
+
+////////////////////////////////////////////////////////////
+// CSV output
+//
+// The context doesn't fit in a CSV table, so it is written
+// as comment lines at the beginning of the file. Cycle
+// columns are left empty when there is no cycle counter.
+
+inline auto write_csv(std::ostream& out, const benchmark_context& context,
+                      const std::vector<benchmark_result>& results)
+    -> void
+{
+    bool has_cycles = not context.cycle_counter.empty();
+
+    out << std::fixed << std::setprecision(3);
+    out << "# library_version: " << context.library_version << '\n'
+        << "# compiler: " << context.compiler << '\n'
+        << "# cycle_counter: " << (has_cycles ? context.cycle_counter : "none") << '\n'
+        << "# counters:";
+    for (const auto& name: context.counters) {
+        out << ' ' << name;
+    }
+    out << '\n'
+        << "# seed: " << context.seed << '\n'
+        << "sorter,distribution,type,size,runs,"
+           "time_median_ns,time_mad_ns,time_min_ns,"
+           "cycles_median,cycles_mad,cycles_min";
+    for (const auto& name: context.counters) {
+        out << ',' << name << "_per_element_median"
+            << ',' << name << "_per_element_mad"
+            << ',' << name << "_per_element_min";
+    }
+    out << '\n';
+
+    for (const auto& res: results) {
+        out << res.sorter << ','
+            << res.distribution << ','
+            << res.type << ','
+            << res.size << ','
+            << res.runs << ','
+            << res.time_ns.median << ','
+            << res.time_ns.mad << ','
+            << res.time_ns.min << ',';
+        if (has_cycles) {
+            out << res.cycles.median << ','
+                << res.cycles.mad << ','
+                << res.cycles.min;
+        } else {
+            out << ",,";
+        }
+        for (const auto& sum: res.counters) {
+            out << ',' << sum.median << ',' << sum.mad << ',' << sum.min;
+        }
+        out << '\n';
+    }
+}
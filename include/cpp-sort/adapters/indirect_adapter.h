@@ -60,7 +60,7 @@ namespace cppsort
             // Indirectly sort the iterators
 
             std::unique_ptr<RandomAccessIterator, operator_deleter> iterators(
-                static_cast<RandomAccessIterator*>(::operator new(size * sizeof(RandomAccessIterator))),
+                static_cast<RandomAccessIterator*>(allocate_bytes(size * sizeof(RandomAccessIterator))),
                 operator_deleter(size * sizeof(RandomAccessIterator))
             );
             destruct_n<RandomAccessIterator> d(0);
@@ -84,7 +84,7 @@ namespace cppsort
                 ////////////////////////////////////////////////////////////
                 // Move the values according the iterator's positions
 
-                std::vector<bool> sorted(last - first, false);
+                std::vector<bool, resource_allocator<bool>> sorted(last - first, false);
 
                 // Element where the current cycle starts
                 auto start = first;
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_ADAPTERS_MEMORY_RESOURCE_ADAPTER_H_
+#define CPPSORT_ADAPTERS_MEMORY_RESOURCE_ADAPTER_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/fwd.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/adapter_storage.h>
+#include <cpp-sort/utility/memory_resource.h>
+#include "../detail/checkers.h"
+
+namespace cppsort
+{
+    ////////////////////////////////////////////////////////////
+    // Adapter
+
+    namespace detail
+    {
+        template<typename Sorter>
+        struct memory_resource_adapter_impl:
+            utility::adapter_storage<Sorter>,
+            check_iterator_category<Sorter>,
+            check_is_always_stable<Sorter>
+        {
+            utility::memory_resource* resource = utility::new_delete_resource();
+
+            memory_resource_adapter_impl() = default;
+
+            constexpr memory_resource_adapter_impl(Sorter&& sorter, utility::memory_resource* resource):
+                utility::adapter_storage<Sorter>(std::move(sorter)),
+                resource(resource)
+            {}
+
+            template<typename... Args>
+            auto operator()(Args&&... args) const
+                -> decltype(this->get()(std::forward<Args>(args)...))
+            {
+                utility::detail::memory_resource_guard guard(resource);
+                return this->get()(std::forward<Args>(args)...);
+            }
+        };
+    }
+
+    template<typename Sorter>
+    struct memory_resource_adapter:
+        sorter_facade<detail::memory_resource_adapter_impl<Sorter>>
+    {
+        memory_resource_adapter() = default;
+
+        constexpr explicit memory_resource_adapter(utility::memory_resource* resource):
+            sorter_facade<detail::memory_resource_adapter_impl<Sorter>>(Sorter{}, resource)
+        {}
+
+        constexpr memory_resource_adapter(Sorter sorter, utility::memory_resource* resource):
+            sorter_facade<detail::memory_resource_adapter_impl<Sorter>>(std::move(sorter), resource)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////
+    // is_stable specialization
+
+    template<typename Sorter, typename... Args>
+    struct is_stable<memory_resource_adapter<Sorter>(Args...)>:
+        is_stable<Sorter(Args...)>
+    {};
+}
+
+#endif // CPPSORT_ADAPTERS_MEMORY_RESOURCE_ADAPTER_H_
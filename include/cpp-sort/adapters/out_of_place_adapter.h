@@ -40,7 +40,7 @@ namespace cppsort
 
             // Copy the collection into contiguous memory buffer
             std::unique_ptr<rvalue_type, operator_deleter> buffer(
-                static_cast<rvalue_type*>(::operator new(size * sizeof(rvalue_type))),
+                static_cast<rvalue_type*>(allocate_bytes(size * sizeof(rvalue_type))),
                 operator_deleter(size * sizeof(rvalue_type))
             );
             destruct_n<rvalue_type> d(0);
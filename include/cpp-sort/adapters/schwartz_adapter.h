@@ -79,7 +79,7 @@ namespace cppsort
 
             // Collection of projected elements
             std::unique_ptr<value_t, operator_deleter> projected(
-                static_cast<value_t*>(::operator new(size * sizeof(value_t))),
+                static_cast<value_t*>(allocate_bytes(size * sizeof(value_t))),
                 operator_deleter(size * sizeof(value_t))
             );
             destruct_n<value_t> d(0);
@@ -10,12 +10,16 @@
 ////////////////////////////////////////////////////////////
 #include <array>
 #include <cstddef>
+#include <iterator>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <cpp-sort/sorter_facade.h>
 #include <cpp-sort/sorter_traits.h>
 #include "../detail/any_all.h"
 #include "../detail/is_in_pack.h"
+#include "../detail/iterator_traits.h"
+#include "../detail/small_array_batch.h"
 #include "../detail/type_traits.h"
 
 namespace cppsort
@@ -94,6 +98,37 @@ namespace cppsort
         {
             return FixedSizeSorter<N>{}(array, std::forward<Args>(args)...);
         }
+
+        ////////////////////////////////////////////////////////////
+        // Sort every array of a collection of small arrays
+
+        template<
+            typename RandomAccessIterator,
+            typename... Args,
+            typename Array = detail::value_type_t<RandomAccessIterator>,
+            std::size_t N = std::tuple_size<Array>::value
+        >
+        auto sort_each(RandomAccessIterator first, RandomAccessIterator last, Args&&... args) const
+            -> std::enable_if_t<detail::is_in_pack<N, Indices...>>
+        {
+            detail::small_array_batch_sorter<FixedSizeSorter>::template sort<N>(
+                std::move(first), std::move(last), std::forward<Args>(args)...
+            );
+        }
+
+        template<
+            typename RandomAccessIterable,
+            typename... Args,
+            typename Array = detail::value_type_t<decltype(std::begin(std::declval<RandomAccessIterable&>()))>,
+            std::size_t N = std::tuple_size<Array>::value
+        >
+        auto sort_each(RandomAccessIterable& iterable, Args&&... args) const
+            -> std::enable_if_t<detail::is_in_pack<N, Indices...>>
+        {
+            detail::small_array_batch_sorter<FixedSizeSorter>::template sort<N>(
+                std::begin(iterable), std::end(iterable), std::forward<Args>(args)...
+            );
+        }
     };
 
     template<template<std::size_t> class FixedSizeSorter>
@@ -125,6 +160,37 @@ namespace cppsort
         {
             return FixedSizeSorter<N>{}(array, std::forward<Args>(args)...);
         }
+
+        ////////////////////////////////////////////////////////////
+        // Sort every array of a collection of small arrays
+
+        template<
+            typename RandomAccessIterator,
+            typename... Args,
+            typename Array = detail::value_type_t<RandomAccessIterator>,
+            std::size_t N = std::tuple_size<Array>::value
+        >
+        auto sort_each(RandomAccessIterator first, RandomAccessIterator last, Args&&... args) const
+            -> void
+        {
+            detail::small_array_batch_sorter<FixedSizeSorter>::template sort<N>(
+                std::move(first), std::move(last), std::forward<Args>(args)...
+            );
+        }
+
+        template<
+            typename RandomAccessIterable,
+            typename... Args,
+            typename Array = detail::value_type_t<decltype(std::begin(std::declval<RandomAccessIterable&>()))>,
+            std::size_t N = std::tuple_size<Array>::value
+        >
+        auto sort_each(RandomAccessIterable& iterable, Args&&... args) const
+            -> void
+        {
+            detail::small_array_batch_sorter<FixedSizeSorter>::template sort<N>(
+                std::begin(iterable), std::end(iterable), std::forward<Args>(args)...
+            );
+        }
     };
 
     ////////////////////////////////////////////////////////////
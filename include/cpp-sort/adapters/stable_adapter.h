@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020 Morwenn
+ * Copyright (c) 2016-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_ADAPTERS_STABLE_ADAPTER_H_
@@ -8,9 +8,11 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -22,9 +24,13 @@
 #include <cpp-sort/utility/size.h>
 #include "../detail/associate_iterator.h"
 #include "../detail/checkers.h"
+#include "../detail/functional.h"
+#include "../detail/index_packed_sort.h"
 #include "../detail/iterator_traits.h"
 #include "../detail/memory.h"
 #include "../detail/sized_iterator.h"
+#include "../detail/three_way_compare.h"
+#include "../detail/type_traits.h"
 
 namespace cppsort
 {
@@ -32,6 +38,12 @@ namespace cppsort
     {
         ////////////////////////////////////////////////////////////
         // Stable comparison function
+        //
+        // Elements are projected once per comparison, and the
+        // comparator goes through three_way_compare when it is
+        // empty: the standard comparators can then compare some
+        // types such as std::string with a single operation
+        // instead of two calls to the comparator.
 
         template<
             typename Compare,
@@ -41,14 +53,40 @@ namespace cppsort
         {
             private:
 
-                using projection_t = decltype(utility::as_function(std::declval<Projection&>()));
-                using compare_t = decltype(utility::as_function(std::declval<Compare&>()));
+                using projection_t = std::decay_t<decltype(utility::as_function(std::declval<Projection&>()))>;
+                using compare_t = std::decay_t<decltype(utility::as_function(std::declval<Compare&>()))>;
                 std::tuple<compare_t, projection_t> data;
 
+                using has_three_way_compare = std::integral_constant<bool,
+                    std::is_empty<compare_t>::value &&
+                    std::is_default_constructible<compare_t>::value
+                >;
+
+                template<typename T, typename U>
+                auto compare_projected(T&& lhs, U&& rhs, std::true_type)
+                    -> int
+                {
+                    return three_way_compare<compare_t>(std::get<0>(data))(
+                        std::forward<T>(lhs), std::forward<U>(rhs)
+                    );
+                }
+
+                template<typename T, typename U>
+                auto compare_projected(T&& lhs, U&& rhs, std::false_type)
+                    -> int
+                {
+                    auto&& comp = std::get<0>(data);
+                    if (comp(lhs, rhs)) {
+                        return -1;
+                    }
+                    return comp(rhs, lhs);
+                }
+
             public:
 
                 stable_compare(Compare compare, Projection projection={}):
-                    data(utility::as_function(compare), utility::as_function(projection))
+                    data(utility::as_function(std::move(compare)),
+                         utility::as_function(std::move(projection)))
                 {}
 
                 auto compare() const
@@ -67,17 +105,10 @@ namespace cppsort
                 auto operator()(T&& lhs, U&& rhs)
                     -> bool
                 {
-                    if (std::get<0>(data)(std::get<1>(data)(std::forward<T>(lhs).get()),
-                                          std::get<1>(data)(std::forward<U>(rhs).get())))
-                    {
-                        return true;
-                    }
-                    if (std::get<0>(data)(std::get<1>(data)(std::forward<U>(rhs).get()),
-                                          std::get<1>(data)(std::forward<T>(lhs).get())))
-                    {
-                        return false;
-                    }
-                    return lhs.data < rhs.data;
+                    auto&& proj = std::get<1>(data);
+                    int res = compare_projected(proj(lhs.get()), proj(rhs.get()),
+                                                has_three_way_compare{});
+                    return res < 0 || (res == 0 && lhs.data < rhs.data);
                 }
         };
 
@@ -98,7 +129,8 @@ namespace cppsort
             typename Sorter
         >
         auto make_stable_and_sort(ForwardIterator first, difference_type_t<ForwardIterator> size,
-                                  Compare&& compare, Projection&& projection, Sorter&& sorter)
+                                  Compare&& compare, Projection&& projection, Sorter&& sorter,
+                                  std::false_type /* index packing */)
             -> decltype(auto)
         {
             using difference_type = difference_type_t<ForwardIterator>;
@@ -108,7 +140,7 @@ namespace cppsort
             // Bind index to iterator
 
             std::unique_ptr<value_t, operator_deleter> iterators(
-                static_cast<value_t*>(::operator new(size * sizeof(value_t))),
+                static_cast<value_t*>(allocate_bytes(size * sizeof(value_t))),
                 operator_deleter(size * sizeof(value_t))
             );
             destruct_n<value_t> d(0);
@@ -133,6 +165,139 @@ namespace cppsort
             );
         }
 
+        // Whether the sorter can sort associate iterators with a stable
+        // comparator, which is notably not the case of radix sorts
+
+        template<typename ForwardIterator, typename Compare, typename Projection, typename Sorter>
+        struct is_associate_sortable:
+            is_invocable<
+                Sorter,
+                associate_iterator<association<ForwardIterator, difference_type_t<ForwardIterator>>*>,
+                associate_iterator<association<ForwardIterator, difference_type_t<ForwardIterator>>*>,
+                stable_compare<Compare, Projection>
+            >
+        {};
+
+        // Collections too big for their positions to be packed fall back
+        // to associate iterators when the sorter can handle them
+
+        template<
+            typename RandomAccessIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto make_stable_and_sort_unpacked(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                                           Compare&& compare, Projection&& projection, Sorter&& sorter,
+                                           std::true_type /* comparison sorter */)
+            -> void
+        {
+            make_stable_and_sort(first, size,
+                                 std::move(compare), std::move(projection),
+                                 std::forward<Sorter>(sorter), std::false_type{});
+        }
+
+        template<
+            typename RandomAccessIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto make_stable_and_sort_unpacked(RandomAccessIterator, difference_type_t<RandomAccessIterator>,
+                                           Compare&&, Projection&&, Sorter&&,
+                                           std::false_type /* comparison sorter */)
+            -> void
+        {
+            throw std::length_error("stable_adapter: too many elements to pack their positions, "
+                                    "and the sorter doesn't accept a comparator");
+        }
+
+        template<
+            typename RandomAccessIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto make_stable_and_sort(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                                  Compare&& compare, Projection&& projection, Sorter&& sorter,
+                                  std::true_type /* index packing */)
+            -> void
+        {
+            using is_comparison_sorter = is_associate_sortable<
+                RandomAccessIterator,
+                std::decay_t<Compare>,
+                std::decay_t<Projection>,
+                Sorter
+            >;
+
+            constexpr int direction = comparison_direction<
+                std::decay_t<Compare>,
+                projected_t<RandomAccessIterator, std::decay_t<Projection>>
+            >::value;
+
+            if (static_cast<std::uint64_t>(size) > 0x100000000u) {
+                // Too many elements to store their positions
+                // in the lower half of a 64-bit integer
+                make_stable_and_sort_unpacked(first, size,
+                                              std::move(compare), std::move(projection),
+                                              std::forward<Sorter>(sorter), is_comparison_sorter{});
+                return;
+            }
+            index_packed_sort<direction>(first, size, std::move(projection),
+                                         std::forward<Sorter>(sorter));
+        }
+
+        // When the comparator is a standard one and the projected
+        // elements are small numbers, the elements are sorted via
+        // integers packing their keys and their positions instead
+        // of going through associate iterators, provided that the
+        // sorter can sort such integers and returns nothing
+
+        template<typename Sorter, typename=void>
+        struct is_index_packed_sorter:
+            std::false_type
+        {};
+
+        template<typename Sorter>
+        struct is_index_packed_sorter<Sorter, void_t<
+            invoke_result_t<Sorter, std::uint64_t*, std::uint64_t*>
+        >>:
+            std::is_void<invoke_result_t<Sorter, std::uint64_t*, std::uint64_t*>>
+        {};
+
+        template<typename Iterator, typename Compare, typename Projection, typename Sorter>
+        struct is_index_packed_sortable:
+            conjunction<
+                std::is_base_of<std::random_access_iterator_tag, iterator_category_t<Iterator>>,
+                is_index_packable<projected_t<Iterator, Projection>>,
+                std::integral_constant<bool,
+                    comparison_direction<Compare, projected_t<Iterator, Projection>>::value != 0
+                >,
+                is_index_packed_sorter<Sorter>
+            >
+        {};
+
+        template<
+            typename ForwardIterator,
+            typename Compare,
+            typename Projection,
+            typename Sorter
+        >
+        auto make_stable_and_sort(ForwardIterator first, difference_type_t<ForwardIterator> size,
+                                  Compare&& compare, Projection&& projection, Sorter&& sorter)
+            -> decltype(auto)
+        {
+            using sortable = is_index_packed_sortable<
+                ForwardIterator,
+                std::decay_t<Compare>,
+                std::decay_t<Projection>,
+                Sorter
+            >;
+            return make_stable_and_sort(first, size,
+                                        std::move(compare), std::move(projection),
+                                        std::forward<Sorter>(sorter), sortable{});
+        }
+
         template<
             typename ForwardIterator,
             typename Compare,
@@ -150,6 +315,14 @@ namespace cppsort
                                         std::move(sorter));
         }
 
+        template<typename ForwardIterator, typename Compare, typename Projection, typename Sorter>
+        struct is_stable_sortable:
+            disjunction<
+                is_index_packed_sortable<ForwardIterator, Compare, Projection, Sorter>,
+                is_associate_sortable<ForwardIterator, Compare, Projection, Sorter>
+            >
+        {};
+
         ////////////////////////////////////////////////////////////
         // make_stable_impl
 
@@ -168,9 +341,13 @@ namespace cppsort
                 typename ForwardIterable,
                 typename Compare = std::less<>,
                 typename Projection = utility::identity,
-                typename = std::enable_if_t<
-                    is_projection_v<Projection, ForwardIterable, Compare>
-                >
+                typename = std::enable_if_t<conjunction<
+                    is_projection<Projection, ForwardIterable, Compare>,
+                    is_stable_sortable<
+                        remove_cvref_t<decltype(std::begin(std::declval<ForwardIterable&>()))>,
+                        Compare, Projection, Sorter
+                    >
+                >::value>
             >
             auto operator()(ForwardIterable&& iterable,
                             Compare compare={}, Projection projection={}) const
@@ -185,9 +362,10 @@ namespace cppsort
                 typename ForwardIterator,
                 typename Compare = std::less<>,
                 typename Projection = utility::identity,
-                typename = std::enable_if_t<
-                    is_projection_iterator_v<Projection, ForwardIterator, Compare>
-                >
+                typename = std::enable_if_t<conjunction<
+                    is_projection_iterator<Projection, ForwardIterator, Compare>,
+                    is_stable_sortable<ForwardIterator, Compare, Projection, Sorter>
+                >::value>
             >
             auto operator()(ForwardIterator first, ForwardIterator last,
                             Compare compare={}, Projection projection={}) const
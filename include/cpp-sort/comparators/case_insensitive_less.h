@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_COMPARATORS_CASE_INSENSITIVE_LESS_H_
@@ -9,11 +9,17 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <locale>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/static_const.h>
+#include "../detail/ascii_case_insensitive.h"
 #include "../detail/type_traits.h"
 
 namespace cppsort
@@ -269,6 +275,168 @@ namespace cppsort
         }
     }
 
+    namespace detail
+    {
+        ////////////////////////////////////////////////////////////
+        // Case-folded collation key
+        //
+        // The sequence is folded with a single call to tolower,
+        // then every character is stored as big endian bytes
+        // after flipping the sign bit of signed character types,
+        // so that comparing the unsigned bytes of two keys gives
+        // the same result as case_insensitive_less.
+
+        template<typename CharT>
+        auto append_case_folded_char(std::string& key, CharT c)
+            -> void
+        {
+            constexpr int bits = CHAR_BIT * static_cast<int>(sizeof(CharT));
+            constexpr std::uintmax_t mask = (std::uintmax_t(1) << bits) - 1;
+
+            auto value = static_cast<std::uintmax_t>(c) & mask;
+            if (std::is_signed<CharT>::value) {
+                value ^= std::uintmax_t(1) << (bits - 1);
+            }
+            for (int shift = bits - CHAR_BIT ; shift >= 0 ; shift -= CHAR_BIT) {
+                key.push_back(static_cast<char>((value >> shift) & 0xFF));
+            }
+        }
+
+        template<typename T>
+        auto case_insensitive_sort_key_impl(const T& value, const std::locale& loc)
+            -> std::string
+        {
+            using char_type = remove_cvref_t<decltype(*std::begin(value))>;
+            const auto& ct = std::use_facet<std::ctype<char_type>>(loc);
+
+            std::basic_string<char_type> folded(std::begin(value), std::end(value));
+            if (folded.empty()) {
+                return {};
+            }
+            ct.tolower(&folded[0], &folded[0] + folded.size());
+
+            std::string key;
+            key.reserve(folded.size() * sizeof(char_type));
+            for (auto c: folded) {
+                append_case_folded_char(key, c);
+            }
+            return key;
+        }
+
+        struct case_insensitive_sort_key_locale_fn:
+            utility::projection_base
+        {
+            private:
+
+                std::locale loc;
+
+            public:
+
+                explicit case_insensitive_sort_key_locale_fn(const std::locale& loc):
+                    loc(loc)
+                {}
+
+                template<typename T>
+                auto operator()(const T& value) const
+                    -> std::string
+                {
+                    return case_insensitive_sort_key_impl(value, loc);
+                }
+        };
+
+        struct case_insensitive_sort_key_fn:
+            utility::projection_base
+        {
+            template<typename T>
+            auto operator()(const T& value) const
+                -> std::string
+            {
+                return case_insensitive_sort_key_impl(value, std::locale());
+            }
+
+            inline auto operator()(const std::locale& loc) const
+                -> case_insensitive_sort_key_locale_fn
+            {
+                return case_insensitive_sort_key_locale_fn(loc);
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // ASCII case-insensitive comparison
+
+        template<typename T, typename=void>
+        struct is_char_sequence:
+            std::false_type
+        {};
+
+        template<typename T>
+        struct is_char_sequence<T, std::enable_if_t<
+            std::is_same<remove_cvref_t<decltype(*std::begin(std::declval<const T&>()))>, char>::value
+        >>:
+            std::true_type
+        {};
+
+        template<typename T, typename=void>
+        struct is_contiguous_char_sequence:
+            std::false_type
+        {};
+
+        template<typename T>
+        struct is_contiguous_char_sequence<T, std::enable_if_t<
+            std::is_same<decltype(std::declval<const T&>().data()), const char*>::value &&
+            std::is_convertible<decltype(std::declval<const T&>().size()), std::size_t>::value
+        >>:
+            std::true_type
+        {};
+
+        struct ascii_case_insensitive_less_fn
+        {
+            private:
+
+                template<typename T, typename U>
+                static auto compare(const T& lhs, const U& rhs, std::true_type)
+                    -> bool
+                {
+                    return ascii_case_insensitive_less(lhs.data(), lhs.size(),
+                                                       rhs.data(), rhs.size());
+                }
+
+                template<typename T, typename U>
+                static auto compare(const T& lhs, const U& rhs, std::false_type)
+                    -> bool
+                {
+                    return std::lexicographical_compare(
+                        std::begin(lhs), std::end(lhs),
+                        std::begin(rhs), std::end(rhs),
+                        [](char lhs_char, char rhs_char) {
+                            return ascii_tolower(lhs_char) < ascii_tolower(rhs_char);
+                        }
+                    );
+                }
+
+            public:
+
+                template<
+                    typename T,
+                    typename U,
+                    typename = std::enable_if_t<
+                        is_char_sequence<T>::value && is_char_sequence<U>::value
+                    >
+                >
+                auto operator()(const T& lhs, const U& rhs) const
+                    -> bool
+                {
+                    using contiguous = std::integral_constant<bool,
+                        is_contiguous_char_sequence<T>::value &&
+                        is_contiguous_char_sequence<U>::value
+                    >;
+                    return compare(lhs, rhs, contiguous{});
+                }
+
+                using is_transparent = void;
+        };
+    }
+
     using case_insensitive_less_t = detail::case_insensitive_less_fn;
 
     namespace
@@ -277,6 +445,24 @@ namespace cppsort
             detail::case_insensitive_less_fn
         >::value;
     }
+
+    using case_insensitive_sort_key_t = detail::case_insensitive_sort_key_fn;
+
+    namespace
+    {
+        constexpr auto&& case_insensitive_sort_key = utility::static_const<
+            detail::case_insensitive_sort_key_fn
+        >::value;
+    }
+
+    using ascii_case_insensitive_less_t = detail::ascii_case_insensitive_less_fn;
+
+    namespace
+    {
+        constexpr auto&& ascii_case_insensitive_less = utility::static_const<
+            detail::ascii_case_insensitive_less_fn
+        >::value;
+    }
 }
 
 #endif // CPPSORT_COMPARATORS_CASE_INSENSITIVE_LESS_H_
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019 Morwenn
+ * Copyright (c) 2016-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_COMPARATORS_NATURAL_LESS_H_
@@ -9,8 +9,12 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cctype>
+#include <cstdint>
 #include <iterator>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <cpp-sort/utility/functional.h>
 #include <cpp-sort/utility/static_const.h>
 
 namespace cppsort
@@ -20,6 +24,12 @@ namespace cppsort
         ////////////////////////////////////////////////////////////
         // Natural order for char sequences
 
+        inline auto natural_isdigit(char c)
+            -> bool
+        {
+            return std::isdigit(static_cast<unsigned char>(c));
+        }
+
         template<typename ForwardIterator1, typename ForwardIterator2>
         auto natural_less_impl(ForwardIterator1 begin1, ForwardIterator1 end1,
                                ForwardIterator2 begin2, ForwardIterator2 end2)
@@ -29,11 +39,11 @@ namespace cppsort
                 auto last1 = begin1;
                 auto last2 = begin2;
                 do {
-                    if (not std::isdigit(*last1)) break;
+                    if (not natural_isdigit(*last1)) break;
                     ++last1;
                 } while (last1 != end1);
                 do {
-                    if (not std::isdigit(*last2)) break;
+                    if (not natural_isdigit(*last2)) break;
                     ++last2;
                 } while (last2 != end2);
 
@@ -54,25 +64,16 @@ namespace cppsort
                     if (size1 != size2) {
                         return size1 < size2;
                     }
-                    if (size1 == 0) {
-                        return false;
-                    }
 
-                    // Sizes are equal and not 0
-                    while (begin1 != end1) {
+                    // Sizes are equal, compare the digits
+                    for (; begin1 != last1 ; ++begin1, ++begin2) {
                         if (*begin1 != *begin2) {
                             return *begin1 < *begin2;
                         }
-                        ++begin1;
-                        ++begin2;
                     }
-                }
 
-                if (begin1 == end1) {
-                    return begin2 != end2;
-                }
-                if (begin2 == end2) {
-                    return false;
+                    // Numbers are equal, compare what follows them
+                    continue;
                 }
 
                 if (*begin1 != *begin2) {
@@ -111,6 +112,78 @@ namespace cppsort
         };
     }
 
+    namespace detail
+    {
+        ////////////////////////////////////////////////////////////
+        // Natural order collation key
+        //
+        // Every character that is not a digit is encoded as a
+        // byte that compares like the original char, and every
+        // number is encoded as the byte of '0' - digits all
+        // compare the same way against other characters -,
+        // followed by the number of digits that remain once
+        // leading zeros are stripped and by those digits: plain
+        // lexicographical comparison of the unsigned bytes of
+        // two keys gives the same result as natural_less.
+
+        inline auto natural_key_byte(char c)
+            -> char
+        {
+            constexpr unsigned char sign_flip = std::is_signed<char>::value ? 0x80 : 0x00;
+            return static_cast<char>(static_cast<unsigned char>(c) ^ sign_flip);
+        }
+
+        template<typename ForwardIterator>
+        auto natural_sort_key_impl(ForwardIterator first, ForwardIterator last)
+            -> std::string
+        {
+            std::string key;
+            while (first != last) {
+                if (not natural_isdigit(*first)) {
+                    key.push_back(natural_key_byte(*first));
+                    ++first;
+                    continue;
+                }
+
+                // Skip leading zeros
+                while (first != last && *first == '0') {
+                    ++first;
+                }
+                auto digits_end = first;
+                while (digits_end != last && natural_isdigit(*digits_end)) {
+                    ++digits_end;
+                }
+
+                // Encode the size, sizes greater than 254 are
+                // stored on 8 more big endian bytes
+                key.push_back(natural_key_byte('0'));
+                auto size = static_cast<std::uint64_t>(std::distance(first, digits_end));
+                if (size < 0xFF) {
+                    key.push_back(static_cast<char>(size));
+                } else {
+                    key.push_back(static_cast<char>(0xFF));
+                    for (int shift = 56 ; shift >= 0 ; shift -= 8) {
+                        key.push_back(static_cast<char>((size >> shift) & 0xFF));
+                    }
+                }
+                key.append(first, digits_end);
+                first = digits_end;
+            }
+            return key;
+        }
+
+        struct natural_sort_key_fn:
+            utility::projection_base
+        {
+            template<typename T>
+            auto operator()(const T& value) const
+                -> std::string
+            {
+                return natural_sort_key_impl(std::begin(value), std::end(value));
+            }
+        };
+    }
+
     using natural_less_t = detail::natural_less_fn;
 
     namespace
@@ -119,6 +192,15 @@ namespace cppsort
             detail::natural_less_fn
         >::value;
     }
+
+    using natural_sort_key_t = detail::natural_sort_key_fn;
+
+    namespace
+    {
+        constexpr auto&& natural_sort_key = utility::static_const<
+            detail::natural_sort_key_fn
+        >::value;
+    }
 }
 
 #endif // CPPSORT_COMPARATORS_NATURAL_LESS_H_
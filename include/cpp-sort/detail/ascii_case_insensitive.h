@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_ASCII_CASE_INSENSITIVE_H_
+#define CPPSORT_DETAIL_ASCII_CASE_INSENSITIVE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include "attributes.h"
+#include "bitops.h"
+#include "config.h"
+
+#if CPPSORT_SSE2_AVAILABLE
+#   include <emmintrin.h>
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // ASCII case folding
+    //
+    // Only the characters in [A, Z] are changed, which gives the
+    // same results as std::tolower with the classic "C" locale.
+
+    constexpr auto ascii_tolower(char c)
+        -> char
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+#if CPPSORT_SSE2_AVAILABLE
+    inline auto ascii_tolower(__m128i chars)
+        -> __m128i
+    {
+        // Bytes greater than 0x7F are negative and never in
+        // [A, Z], whether char is signed or not
+        auto upper = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('A' - 1)),
+                                   _mm_cmplt_epi8(chars, _mm_set1_epi8('Z' + 1)));
+        return _mm_or_si128(chars, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+    }
+#endif
+
+    ////////////////////////////////////////////////////////////
+    // Case-insensitive lexicographical comparison of two
+    // contiguous sequences of char, the folded characters
+    // compare like char does
+
+    CPPSORT_ATTRIBUTE_NOINLINE
+    auto ascii_case_insensitive_less(const char* lhs, std::size_t lhs_size,
+                                     const char* rhs, std::size_t rhs_size)
+        -> bool
+    {
+        auto size = (std::min)(lhs_size, rhs_size);
+        std::size_t idx = 0;
+
+#if CPPSORT_SSE2_AVAILABLE
+        // Find the first mismatch 16 characters at a time
+        for (; idx + 16 <= size ; idx += 16) {
+            auto x = ascii_tolower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + idx)));
+            auto y = ascii_tolower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + idx)));
+            auto mismatch = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) ^ 0xFFFFu;
+            if (mismatch != 0) {
+                idx += countr_zero(mismatch);
+                return ascii_tolower(lhs[idx]) < ascii_tolower(rhs[idx]);
+            }
+        }
+#endif
+
+        for (; idx < size ; ++idx) {
+            auto lhs_char = ascii_tolower(lhs[idx]);
+            auto rhs_char = ascii_tolower(rhs[idx]);
+            if (lhs_char != rhs_char) {
+                return lhs_char < rhs_char;
+            }
+        }
+        return lhs_size < rhs_size;
+    }
+}}
+
+#endif // CPPSORT_DETAIL_ASCII_CASE_INSENSITIVE_H_
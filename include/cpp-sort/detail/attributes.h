@@ -35,4 +35,24 @@
 #   define CPPSORT_ATTRIBUTE_FALLTHROUGH (void)0
 #endif
 
+// CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define CPPSORT_ATTRIBUTE_ALWAYS_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+#   define CPPSORT_ATTRIBUTE_ALWAYS_INLINE __forceinline
+#else
+#   define CPPSORT_ATTRIBUTE_ALWAYS_INLINE inline
+#endif
+
+// CPPSORT_ATTRIBUTE_NOINLINE
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define CPPSORT_ATTRIBUTE_NOINLINE [[gnu::noinline]] inline
+#elif defined(_MSC_VER)
+#   define CPPSORT_ATTRIBUTE_NOINLINE __declspec(noinline) inline
+#else
+#   define CPPSORT_ATTRIBUTE_NOINLINE inline
+#endif
+
 #endif // CPPSORT_DETAIL_ATTRIBUTES_H_
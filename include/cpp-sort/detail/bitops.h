@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018 Morwenn
+ * Copyright (c) 2015-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
 #ifndef CPPSORT_DETAIL_BITOPS_H_
@@ -61,6 +61,27 @@ namespace detail
         return log;
     }
 
+    // Returns the number of trailing zero bits, assumes n > 0
+
+#if defined(__GNUC__) || defined(__clang__)
+    constexpr auto countr_zero(unsigned int n)
+        -> unsigned int
+    {
+        return static_cast<unsigned int>(__builtin_ctz(n));
+    }
+#else
+    constexpr auto countr_zero(unsigned int n)
+        -> unsigned int
+    {
+        unsigned int count = 0;
+        while ((n & 1u) == 0) {
+            n >>= 1;
+            ++count;
+        }
+        return count;
+    }
+#endif
+
     // Halves a positive number, using unsigned division if possible
 
     template<typename Integer>
@@ -69,7 +69,7 @@ namespace detail
             explicit cartesian_tree(Iterator first, Iterator last, Compare compare, Projection projection):
                 // Allocate enough space to store N nodes
                 size_(last - first),
-                buffer_(static_cast<node_type*>(::operator new(size_ * sizeof(node_type))),
+                buffer_(static_cast<node_type*>(allocate_bytes(size_ * sizeof(node_type))),
                         operator_deleter(size_ * sizeof(node_type))),
                 root_(buffer_.get()) // Original root is first element
             {
@@ -168,7 +168,7 @@ namespace detail
         }
 
         tree_type tree(first, last, compare, projection);
-        std::vector<node_type*> pq; // Priority queue
+        std::vector<node_type*, resource_allocator<node_type*>> pq; // Priority queue
         pq.push_back(tree.root());
 
         auto&& comp = invert(compare);
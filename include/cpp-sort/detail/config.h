@@ -39,6 +39,63 @@
 #   endif
 #endif
 
+////////////////////////////////////////////////////////////
+// SIMD instruction sets
+
+// Some algorithms have vectorized code paths that are only
+// enabled when the corresponding instruction sets are known
+// to be available at compile time, they can all be disabled
+// by defining CPPSORT_DISABLE_SIMD
+
+#if !defined(CPPSORT_DISABLE_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define CPPSORT_SSE2_AVAILABLE 1
+#else
+#   define CPPSORT_SSE2_AVAILABLE 0
+#endif
+
+#if !defined(CPPSORT_DISABLE_SIMD) && (defined(__SSE4_1__) || defined(__AVX__))
+#   define CPPSORT_SSE41_AVAILABLE 1
+#else
+#   define CPPSORT_SSE41_AVAILABLE 0
+#endif
+
+#if !defined(CPPSORT_DISABLE_SIMD) && defined(__AVX__)
+#   define CPPSORT_AVX_AVAILABLE 1
+#else
+#   define CPPSORT_AVX_AVAILABLE 0
+#endif
+
+#if !defined(CPPSORT_DISABLE_SIMD) && defined(__AVX2__)
+#   define CPPSORT_AVX2_AVAILABLE 1
+#else
+#   define CPPSORT_AVX2_AVAILABLE 0
+#endif
+
+// Algorithms can also have code paths compiled for instruction
+// sets unknown at compile time, picked at runtime after checking
+// what the processor supports: this relies on GCC extensions
+
+#if !defined(CPPSORT_DISABLE_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#   define CPPSORT_SIMD_DISPATCH_AVAILABLE 1
+#else
+#   define CPPSORT_SIMD_DISPATCH_AVAILABLE 0
+#endif
+
+////////////////////////////////////////////////////////////
+// Memory-mapped files
+
+// Files can only be sorted in place through a memory mapping
+// on systems that provide the POSIX mmap family of functions
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && \
+    __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#   define CPPSORT_MMAP_AVAILABLE 1
+#else
+#   define CPPSORT_MMAP_AVAILABLE 0
+#endif
+
 ////////////////////////////////////////////////////////////
 // CPPSORT_ASSUME
 
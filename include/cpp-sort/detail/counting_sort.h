@@ -12,6 +12,7 @@
 #include <functional>
 #include <vector>
 #include "iterator_traits.h"
+#include "memory.h"
 #include "minmax_element_and_is_sorted.h"
 
 namespace cppsort
@@ -28,7 +29,7 @@ namespace detail
         using difference_type = difference_type_t<ForwardIterator>;
         auto min = *info.min;
         auto max = *info.max;
-        std::vector<difference_type> counts(max - min + 1, 0);
+        std::vector<difference_type, resource_allocator<difference_type>> counts(max - min + 1, 0);
 
         for (auto it = first ; it != last ; ++it)
         {
@@ -51,7 +52,7 @@ namespace detail
         using difference_type = difference_type_t<ForwardIterator>;
         auto min = *info.max;
         auto max = *info.min;
-        std::vector<difference_type> counts(max - min + 1, 0);
+        std::vector<difference_type, resource_allocator<difference_type>> counts(max - min + 1, 0);
 
         for (auto it = first ; it != last ; ++it)
         {
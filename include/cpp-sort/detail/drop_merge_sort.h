@@ -34,6 +34,7 @@
 #include <cpp-sort/utility/as_function.h>
 #include <cpp-sort/utility/iter_move.h>
 #include "iterator_traits.h"
+#include "memory.h"
 #include "pdqsort.h"
 #include "type_traits.h"
 
@@ -59,7 +60,7 @@ namespace detail
 
         using difference_type = difference_type_t<BidirectionalIterator>;
         using rvalue_type = rvalue_type_t<BidirectionalIterator>;
-        std::vector<rvalue_type> dropped;
+        std::vector<rvalue_type, resource_allocator<rvalue_type>> dropped;
 
         difference_type num_dropped_in_row = 0;
         auto write = begin;
@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_EXTERNAL_SORT_H_
+#define CPPSORT_DETAIL_EXTERNAL_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include "attributes.h"
+#include "config.h"
+#include "file_error.h"
+#include "iterator_traits.h"
+#include "loser_tree.h"
+#include "memory.h"
+
+#if !defined(_WIN32) && __has_include(<sys/types.h>) && __has_include(<unistd.h>)
+#   include <sys/types.h>
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Temporary files
+    //
+    // Files created with std::tmpfile are removed by the system
+    // once they are closed, even when the program crashes. Files
+    // created in a given directory are removed once closed.
+
+    struct file_closer
+    {
+        std::string path;
+
+        auto operator()(std::FILE* file) const noexcept
+            -> void
+        {
+            std::fclose(file);
+            if (not path.empty()) {
+                std::remove(path.c_str());
+            }
+        }
+    };
+
+    using temporary_file = std::unique_ptr<std::FILE, file_closer>;
+
+    CPPSORT_ATTRIBUTE_NOINLINE
+    auto make_temporary_file(const std::string& directory)
+        -> temporary_file
+    {
+        if (directory.empty()) {
+            temporary_file file(std::tmpfile());
+            if (not file) {
+                throw_file_error("cpp-sort: could not create a temporary file");
+            }
+            return file;
+        }
+
+        // Try new names until one of them doesn't exist yet, the
+        // files are opened in exclusive mode to avoid races
+        static std::atomic<unsigned long long> counter(0);
+        for (int attempt = 0 ; attempt < 100 ; ++attempt) {
+            auto id = static_cast<unsigned long long>(
+                std::chrono::steady_clock::now().time_since_epoch().count()
+            ) + counter.fetch_add(1, std::memory_order_relaxed);
+            auto path = directory + "/cpp-sort-" + std::to_string(id) + ".tmp";
+            errno = 0;
+            if (std::FILE* file = std::fopen(path.c_str(), "w+bx")) {
+                return temporary_file(file, file_closer{ std::move(path) });
+            }
+            if (errno != EEXIST) {
+                break;
+            }
+        }
+        throw_file_error("cpp-sort: could not create a temporary file");
+    }
+
+    // Position a file at a byte offset that might not fit in a long
+    CPPSORT_ATTRIBUTE_NOINLINE
+    auto seek_file(std::FILE* file, std::uint64_t offset)
+        -> void
+    {
+#if defined(_WIN32)
+        int res = _fseeki64(file, static_cast<__int64>(offset), SEEK_SET);
+#elif __has_include(<sys/types.h>) && __has_include(<unistd.h>)
+        int res = fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#else
+        int res = std::fseek(file, static_cast<long>(offset), SEEK_SET);
+#endif
+        if (res != 0) {
+            throw_file_error("cpp-sort: could not seek in a temporary file");
+        }
+    }
+
+    template<typename T>
+    auto write_records(std::FILE* file, const T* records, std::size_t count)
+        -> void
+    {
+        if (count != 0 && std::fwrite(records, sizeof(T), count, file) != count) {
+            throw_file_error("cpp-sort: could not write to a temporary file");
+        }
+    }
+
+    template<typename T>
+    auto read_records(std::FILE* file, T* records, std::size_t count)
+        -> std::size_t
+    {
+        if (count != 0 && std::fread(records, sizeof(T), count, file) != count) {
+            throw_file_error("cpp-sort: could not read from a temporary file");
+        }
+        return count;
+    }
+
+    // Uninitialized memory for trivially copyable records
+    template<typename T>
+    auto make_record_buffer(std::size_t count)
+        -> std::unique_ptr<T, operator_deleter>
+    {
+        return std::unique_ptr<T, operator_deleter>(
+            static_cast<T*>(allocate_bytes(count * sizeof(T))),
+            operator_deleter(count * sizeof(T))
+        );
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Sorted runs stored in a temporary file
+    //
+    // The runs of a merge pass are stored one after the other in
+    // a single file so that the number of open files does not grow
+    // with the number of runs. Readers of several runs can share
+    // the file: every read seeks to its run under the mutex.
+
+    struct external_run
+    {
+        // Position and size in records
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct spill_file
+    {
+        explicit spill_file(const std::string& directory):
+            file(make_temporary_file(directory))
+        {}
+
+        temporary_file file;
+        std::mutex mutex;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Double-buffered run reader
+    //
+    // While the records of one half of its buffer are consumed,
+    // the next block of the run is read into the other half by
+    // another thread.
+
+    template<typename T>
+    class run_reader
+    {
+        public:
+
+            run_reader(spill_file& spill, const external_run& run, std::size_t block_size):
+                spill(&spill),
+                position(run.offset),
+                remaining(run.size),
+                block_size(block_size),
+                buffer(make_record_buffer<T>(2 * block_size))
+            {
+                schedule_read(buffer.get());
+                refill();
+            }
+
+            ~run_reader()
+            {
+                // Don't free the buffer while a block is read into it
+                if (pending.valid()) {
+                    pending.wait();
+                }
+            }
+
+            auto empty() const noexcept
+                -> bool
+            {
+                return current == current_end;
+            }
+
+            auto front() noexcept
+                -> T&
+            {
+                return *current;
+            }
+
+            auto pop()
+                -> void
+            {
+                if (++current == current_end) {
+                    refill();
+                }
+            }
+
+        private:
+
+            auto schedule_read(T* block)
+                -> void
+            {
+                auto count = static_cast<std::size_t>((std::min)(remaining, std::uint64_t(block_size)));
+                auto offset = position;
+                position += count;
+                remaining -= count;
+                pending_block = block;
+                pending = std::async(std::launch::async, [spill=spill, block, offset, count] {
+                    std::lock_guard<std::mutex> lock(spill->mutex);
+                    seek_file(spill->file.get(), offset * sizeof(T));
+                    return read_records(spill->file.get(), block, count);
+                });
+            }
+
+            auto refill()
+                -> void
+            {
+                if (not pending.valid()) {
+                    return;
+                }
+                auto count = pending.get();
+                current = pending_block;
+                current_end = current + count;
+                if (remaining != 0) {
+                    auto other_block = (current == buffer.get()) ? buffer.get() + block_size : buffer.get();
+                    schedule_read(other_block);
+                }
+            }
+
+            spill_file* spill;
+            std::uint64_t position;
+            std::uint64_t remaining;
+            std::size_t block_size;
+            std::unique_ptr<T, operator_deleter> buffer;
+            T* current = nullptr;
+            T* current_end = nullptr;
+            T* pending_block = nullptr;
+            std::future<std::size_t> pending;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Double-buffered run writer
+
+    template<typename T>
+    class run_writer
+    {
+        public:
+
+            run_writer(std::FILE* file, std::size_t block_size):
+                file(file),
+                block_size(block_size),
+                buffer(make_record_buffer<T>(2 * block_size)),
+                current(buffer.get()),
+                position(buffer.get())
+            {}
+
+            ~run_writer()
+            {
+                // Don't free the buffer while a block is written from it
+                if (pending.valid()) {
+                    pending.wait();
+                }
+            }
+
+            auto push(const T& record)
+                -> void
+            {
+                ::new(position) T(record);
+                if (++position == current + block_size) {
+                    flush();
+                }
+            }
+
+            auto finish()
+                -> void
+            {
+                flush();
+                wait();
+                if (std::fflush(file) != 0) {
+                    throw_file_error("cpp-sort: could not write to a temporary file");
+                }
+            }
+
+        private:
+
+            auto wait()
+                -> void
+            {
+                if (pending.valid()) {
+                    pending.get();
+                }
+            }
+
+            auto flush()
+                -> void
+            {
+                auto count = static_cast<std::size_t>(position - current);
+                if (count == 0) {
+                    return;
+                }
+                wait();
+                pending = std::async(std::launch::async, [file=file, block=current, count] {
+                    write_records(file, block, count);
+                });
+                current = (current == buffer.get()) ? buffer.get() + block_size : buffer.get();
+                position = current;
+            }
+
+            std::FILE* file;
+            std::size_t block_size;
+            std::unique_ptr<T, operator_deleter> buffer;
+            T* current;
+            T* position;
+            std::future<void> pending;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Merge runs
+    //
+    // The readers are merged with a loser tree, ties are broken
+    // by the order of the runs so that the merge is stable.
+
+    template<typename T, typename Compare, typename Projection, typename Sink>
+    auto merge_external_runs(spill_file& spill, const external_run* first, const external_run* last,
+                             std::size_t block_size, Compare compare, Projection projection, Sink sink)
+        -> void
+    {
+        auto&& comp = utility::as_function(compare);
+        auto&& proj = utility::as_function(projection);
+
+        // run_reader isn't movable, a deque never moves its elements
+        std::deque<run_reader<T>> readers;
+        for (; first != last ; ++first) {
+            readers.emplace_back(spill, *first, block_size);
+        }
+        if (readers.empty()) return;
+
+        auto tree = make_loser_tree(readers.size(), [&](std::size_t lhs, std::size_t rhs) {
+            if (readers[rhs].empty()) {
+                return not readers[lhs].empty() || lhs < rhs;
+            }
+            if (readers[lhs].empty()) {
+                return false;
+            }
+            if (lhs < rhs) {
+                return not comp(proj(readers[rhs].front()), proj(readers[lhs].front()));
+            }
+            return bool(comp(proj(readers[lhs].front()), proj(readers[rhs].front())));
+        });
+
+        while (true) {
+            auto& reader = readers[tree.top()];
+            if (reader.empty()) {
+                // All the runs are exhausted
+                return;
+            }
+            sink(reader.front());
+            reader.pop();
+            tree.replay();
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // External merge sort
+    //
+    // Runs of half the memory budget are read from the input,
+    // sorted with the given sorter and written to a temporary
+    // file, the writing of a run overlapping the reading of the
+    // next one. Groups of consecutive runs are then merged into
+    // a new file until there are few enough of them to be merged
+    // directly into the output with blocks of a reasonable size.
+
+    // Smallest amount of memory worth reading at once
+    constexpr std::size_t external_min_block_bytes = 64 * 1024;
+    constexpr std::size_t external_max_fan_in = 64;
+
+    template<typename T>
+    auto external_block_size(std::size_t memory_budget, std::size_t nb_runs)
+        -> std::size_t
+    {
+        // Every merged run and the output need two blocks
+        auto block_size = memory_budget / (2 * (nb_runs + 1) * sizeof(T));
+        return (std::max)(block_size, std::size_t(1));
+    }
+
+    template<
+        typename InputIterator,
+        typename OutputIterator,
+        typename Compare,
+        typename Projection,
+        typename Sorter
+    >
+    auto external_sort(InputIterator first, InputIterator last, OutputIterator out,
+                       std::size_t memory_budget, const std::string& directory,
+                       Compare compare, Projection projection, Sorter&& sorter)
+        -> OutputIterator
+    {
+        using value_type = value_type_t<InputIterator>;
+        static_assert(std::is_trivially_copyable<value_type>::value,
+                      "external sorting only works with trivially copyable records");
+
+        ////////////////////////////////////////////////////////////
+        // Produce sorted runs
+
+        auto run_capacity = (std::max)(memory_budget / (2 * sizeof(value_type)), std::size_t(1));
+        std::unique_ptr<spill_file> spill;
+        std::vector<external_run> runs;
+        {
+            auto buffer = make_record_buffer<value_type>(2 * run_capacity);
+            std::future<void> pending_write;
+
+            for (auto run_buffer = buffer.get() ; first != last ; ) {
+                std::size_t size = 0;
+                for (; size != run_capacity && first != last ; ++first, ++size) {
+                    ::new(run_buffer + size) value_type(*first);
+                }
+                sorter(run_buffer, run_buffer + size, compare, projection);
+
+                if (runs.empty() && first == last) {
+                    // Everything fits in memory
+                    return std::copy(run_buffer, run_buffer + size, out);
+                }
+
+                if (pending_write.valid()) {
+                    pending_write.get();
+                }
+                if (not spill) {
+                    spill = std::make_unique<spill_file>(directory);
+                }
+                auto offset = runs.empty() ? 0 : runs.back().offset + runs.back().size;
+                runs.push_back({ offset, size });
+                pending_write = std::async(std::launch::async, [file=spill->file.get(), run_buffer, size] {
+                    write_records(file, run_buffer, size);
+                });
+
+                run_buffer = (run_buffer == buffer.get()) ? buffer.get() + run_capacity : buffer.get();
+            }
+
+            if (pending_write.valid()) {
+                pending_write.get();
+            }
+        }
+        if (runs.empty()) {
+            return out;
+        }
+        if (std::fflush(spill->file.get()) != 0) {
+            throw_file_error("cpp-sort: could not write to a temporary file");
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Merge groups of runs into bigger runs
+
+        // Every merged run and the output need two blocks
+        auto max_blocks = memory_budget / (2 * external_min_block_bytes);
+        auto fan_in = (max_blocks > 1) ? max_blocks - 1 : 1;
+        fan_in = (std::max)(std::size_t(2), (std::min)(fan_in, external_max_fan_in));
+        while (runs.size() > fan_in) {
+            // A lone last run is copied too since the
+            // file of the previous pass is closed
+            auto merged_spill = std::make_unique<spill_file>(directory);
+            std::vector<external_run> merged_runs;
+            std::uint64_t offset = 0;
+            for (std::size_t idx = 0 ; idx < runs.size() ; idx += fan_in) {
+                auto group_size = (std::min)(fan_in, runs.size() - idx);
+                auto block_size = external_block_size<value_type>(memory_budget, group_size);
+                external_run merged = { offset, 0 };
+                run_writer<value_type> writer(merged_spill->file.get(), block_size);
+                merge_external_runs<value_type>(
+                    *spill, runs.data() + idx, runs.data() + idx + group_size, block_size,
+                    compare, projection,
+                    [&](const value_type& record) {
+                        writer.push(record);
+                    }
+                );
+                writer.finish();
+                for (auto it = runs.begin() + idx ; it != runs.begin() + idx + group_size ; ++it) {
+                    merged.size += it->size;
+                }
+                offset += merged.size;
+                merged_runs.push_back(merged);
+            }
+            runs = std::move(merged_runs);
+            spill = std::move(merged_spill);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Merge the remaining runs into the output
+
+        auto block_size = external_block_size<value_type>(memory_budget, runs.size());
+        merge_external_runs<value_type>(
+            *spill, runs.data(), runs.data() + runs.size(), block_size,
+            std::move(compare), std::move(projection),
+            [&out](const value_type& record) {
+                *out = record;
+                ++out;
+            }
+        );
+        return out;
+    }
+}}
+
+#endif // CPPSORT_DETAIL_EXTERNAL_SORT_H_
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_FILE_ERROR_H_
+#define CPPSORT_DETAIL_FILE_ERROR_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cerrno>
+#include <system_error>
+#include "attributes.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Report a failed file operation with the error stored in
+    // errno, or with a generic I/O error when errno was not set
+
+    [[noreturn]] CPPSORT_ATTRIBUTE_NOINLINE
+    auto throw_file_error(const char* what)
+        -> void
+    {
+        auto code = errno;
+        if (code == 0) {
+            throw std::system_error(std::make_error_code(std::errc::io_error), what);
+        }
+        throw std::system_error(code, std::generic_category(), what);
+    }
+}}
+
+#endif // CPPSORT_DETAIL_FILE_ERROR_H_
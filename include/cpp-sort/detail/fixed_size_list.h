@@ -118,7 +118,7 @@ namespace detail
 
             explicit fixed_size_list_node_pool(std::ptrdiff_t capacity):
                 // Allocate enough space to store N nodes
-                buffer_(static_cast<node_type*>(::operator new(capacity * sizeof(node_type))),
+                buffer_(static_cast<node_type*>(allocate_bytes(capacity * sizeof(node_type))),
                        operator_deleter(capacity * sizeof(node_type))),
                 first_free_(buffer_.get()),
                 capacity_(capacity)
@@ -398,7 +398,7 @@ namespace detail
                 node_destructor_(node_destructor)
             {}
 
-            constexpr fixed_size_list(fixed_size_list&& other) noexcept:
+            fixed_size_list(fixed_size_list&& other) noexcept:
                 node_pool_(other.node_pool_),
                 sentinel_node_(std::exchange(other.sentinel_node_.prev, &other.sentinel_node_),
                                std::exchange(other.sentinel_node_.next, &other.sentinel_node_)),
@@ -8,6 +8,7 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <functional>
 #include <type_traits>
 #include <utility>
 #include <cpp-sort/utility/as_function.h>
@@ -100,6 +101,49 @@ namespace detail
         return invert_t<std::decay_t<Predicate>>(std::forward<Predicate>(pred));
     }
 
+    ////////////////////////////////////////////////////////////
+    // Direction of the standard comparison function objects:
+    // 1 for std::less, -1 for std::greater, 0 for any other
+    // comparator, used by algorithms that can replace the
+    // comparisons by cheaper operations
+
+    template<typename Compare, typename T>
+    struct comparison_direction:
+        std::integral_constant<int, 0>
+    {};
+
+    template<typename T>
+    struct comparison_direction<std::less<>, T>:
+        std::integral_constant<int, 1>
+    {};
+
+    template<typename T>
+    struct comparison_direction<std::less<T>, T>:
+        std::integral_constant<int, 1>
+    {};
+
+    template<typename T>
+    struct comparison_direction<std::greater<>, T>:
+        std::integral_constant<int, -1>
+    {};
+
+    template<typename T>
+    struct comparison_direction<std::greater<T>, T>:
+        std::integral_constant<int, -1>
+    {};
+
+#ifdef __cpp_lib_ranges
+    template<typename T>
+    struct comparison_direction<std::ranges::less, T>:
+        std::integral_constant<int, 1>
+    {};
+
+    template<typename T>
+    struct comparison_direction<std::ranges::greater, T>:
+        std::integral_constant<int, -1>
+    {};
+#endif
+
     ////////////////////////////////////////////////////////////
     // indirect
 
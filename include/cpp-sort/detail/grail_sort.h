@@ -734,7 +734,7 @@ namespace grail
             }
 
             combine_blocks(first, ptr, last - ptr, cbuf, lb,
-                           chavebuf, extbuf, chavebuf && lb <= LExtBuf,
+                           chavebuf, extbuf, chavebuf && LExtBuf > 0 && lb <= LExtBuf,
                            compare, projection);
         }
         insertion_sort(first, ptr, compare.base(), projection);
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_INDEX_PACKED_SORT_H_
+#define CPPSORT_DETAIL_INDEX_PACKED_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "config.h"
+#include "iterator_traits.h"
+#include "memcpy_cast.h"
+#include "memory.h"
+#include "move.h"
+#include "type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Keys that can be packed with an index
+    //
+    // Integers and floating point numbers of at most 32 bits
+    // can be mapped to unsigned 32-bit integers that compare
+    // the same way, the position of an element is stored in
+    // the 32 lower bits of a 64-bit integer next to its key:
+    // sorting such integers gives the same result as a stable
+    // sort of the original elements.
+
+    template<typename T, typename=void>
+    struct is_index_packable:
+        std::false_type
+    {};
+
+    template<typename T>
+    struct is_index_packable<T, std::enable_if_t<std::is_integral<T>::value>>:
+        std::integral_constant<bool, sizeof(T) <= sizeof(std::uint32_t)>
+    {};
+
+    template<>
+    struct is_index_packable<float>:
+        std::integral_constant<bool,
+            sizeof(float) == sizeof(std::uint32_t) &&
+            std::numeric_limits<float>::is_iec559
+        >
+    {};
+
+    template<typename T>
+    auto index_packed_key(T value)
+        -> std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value, std::uint32_t>
+    {
+        return static_cast<std::uint32_t>(value);
+    }
+
+    template<typename T>
+    auto index_packed_key(T value)
+        -> std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value, std::uint32_t>
+    {
+        // Flip the sign bit so that negative numbers come first
+        return static_cast<std::uint32_t>(static_cast<std::int32_t>(value)) ^ 0x80000000u;
+    }
+
+    template<typename T>
+    auto index_packed_key(T value)
+        -> std::enable_if_t<std::is_same<T, float>::value, std::uint32_t>
+    {
+        // -0.0 and 0.0 compare equivalent and must get the same key
+        auto u = memcpy_cast<std::uint32_t>(value == 0.0f ? 0.0f : value);
+        std::uint32_t sign_bit = 0u - (u >> 31);
+        return u ^ (sign_bit | 0x80000000u);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // index_packed_sort
+    //
+    // Stable sort of [first, first + size) with std::less<>
+    // when Direction is 1 and std::greater<> when Direction
+    // is -1: the keys are packed with their index and sorted
+    // with the given sorter, then the original elements are
+    // moved to their new positions through a buffer. The
+    // projection is called only once per element, and the
+    // sorter compares integers instead of the original
+    // elements.
+
+    template<int Direction, typename RandomAccessIterator, typename Projection, typename Sorter>
+    auto index_packed_sort(RandomAccessIterator first, difference_type_t<RandomAccessIterator> size,
+                           Projection projection, Sorter&& sorter)
+        -> void
+    {
+        using utility::iter_move;
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        using value_type = value_type_t<RandomAccessIterator>;
+        constexpr std::uint64_t index_mask = 0xFFFFFFFFu;
+        auto&& proj = utility::as_function(projection);
+
+        CPPSORT_ASSERT(static_cast<std::uint64_t>(size) <= index_mask + 1);
+        if (size < 2) return;
+
+        std::unique_ptr<std::uint64_t, operator_deleter> buffer(
+            static_cast<std::uint64_t*>(allocate_bytes(size * sizeof(std::uint64_t))),
+            operator_deleter(size * sizeof(std::uint64_t))
+        );
+        auto packed = buffer.get();
+
+        // Pack the keys with the positions of the elements
+        for (difference_type index = 0 ; index != size ; ++index) {
+            std::uint64_t key = index_packed_key(proj(first[index]));
+            if (Direction < 0) {
+                key = ~key & index_mask;
+            }
+            ::new(packed + index) std::uint64_t((key << 32) | static_cast<std::uint64_t>(index));
+        }
+
+        std::forward<Sorter>(sorter)(packed, packed + size);
+
+        // The lower bits of packed[index] now hold the original
+        // position of the element that belongs to index: gather
+        // the elements in a buffer, which is much faster than
+        // following the cycles of the permutation since the
+        // reads do not depend on each other, then move them back
+        std::unique_ptr<value_type, operator_deleter> values(
+            static_cast<value_type*>(allocate_bytes(size * sizeof(value_type))),
+            operator_deleter(size * sizeof(value_type))
+        );
+        destruct_n<value_type> d(0);
+        std::unique_ptr<value_type, destruct_n<value_type>&> h2(values.get(), d);
+
+        auto ptr = values.get();
+        for (difference_type index = 0 ; index != size ; ++index) {
+            auto source_index = static_cast<difference_type>(packed[index] & index_mask);
+            ::new(ptr + index) value_type(iter_move(first + source_index));
+            ++d;
+        }
+        detail::move(ptr, ptr + size, first);
+    }
+}}
+
+#endif // CPPSORT_DETAIL_INDEX_PACKED_SORT_H_
@@ -67,7 +67,7 @@ namespace detail
 
         using item_index_tuple = pointer_index_tuple<ForwardIterator, difference_type>;
         std::unique_ptr<item_index_tuple, operator_deleter> storage(
-            static_cast<item_index_tuple*>(::operator new(size * sizeof(item_index_tuple))),
+            static_cast<item_index_tuple*>(allocate_bytes(size * sizeof(item_index_tuple))),
             operator_deleter(size * sizeof(item_index_tuple))
         );
         destruct_n<item_index_tuple> d(0);
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_K_WAY_MERGE_H_
+#define CPPSORT_DETAIL_K_WAY_MERGE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "inplace_merge.h"
+#include "iterator_traits.h"
+#include "loser_tree.h"
+#include "move.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Merge sorted sources with a loser tree
+    //
+    // Every source is a pair of iterators [first, last), the
+    // iterator to the element that comes next is passed to the
+    // sink, and equivalent elements are taken from the sources
+    // in order, which makes the merge stable.
+
+    template<typename Iterator, typename Compare, typename Projection, typename Sink>
+    auto k_way_merge(std::vector<std::pair<Iterator, Iterator>>& sources,
+                     Compare compare, Projection projection, Sink sink)
+        -> void
+    {
+        if (sources.empty()) return;
+
+        auto&& comp = utility::as_function(compare);
+        auto&& proj = utility::as_function(projection);
+
+        auto tree = make_loser_tree(sources.size(), [&](std::size_t lhs, std::size_t rhs) {
+            const auto& lhs_source = sources[lhs];
+            const auto& rhs_source = sources[rhs];
+            if (rhs_source.first == rhs_source.second) {
+                return lhs_source.first != lhs_source.second || lhs < rhs;
+            }
+            if (lhs_source.first == lhs_source.second) {
+                return false;
+            }
+            // A single comparison is enough to break ties
+            // with the indices of the sources
+            if (lhs < rhs) {
+                return not comp(proj(*rhs_source.first), proj(*lhs_source.first));
+            }
+            return bool(comp(proj(*lhs_source.first), proj(*rhs_source.first)));
+        });
+
+        while (true) {
+            auto& source = sources[tree.top()];
+            if (source.first == source.second) {
+                // All the sources are exhausted
+                return;
+            }
+            sink(source.first);
+            ++source.first;
+            tree.replay();
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Merge consecutive sorted runs in place
+    //
+    // The runs are [bounds[i], bounds[i+1]). When the buffer is
+    // big enough to hold all the elements, the runs are merged
+    // into it at once then moved back, otherwise pairs of
+    // consecutive runs are merged with inplace_merge and the
+    // buffer until there is a single run left.
+
+    template<
+        typename BufferProvider,
+        typename RandomAccessIterator,
+        typename Compare,
+        typename Projection
+    >
+    auto k_way_inplace_merge(std::vector<RandomAccessIterator> bounds,
+                             Compare compare, Projection projection)
+        -> void
+    {
+        using utility::iter_move;
+        using rvalue_type = rvalue_type_t<RandomAccessIterator>;
+
+        if (bounds.size() < 3) return;
+        auto first = bounds.front();
+        auto size = bounds.back() - first;
+
+        typename BufferProvider::template buffer<rvalue_type> buffer(size);
+        auto buffer_size = static_cast<std::ptrdiff_t>(buffer.size());
+
+        if (buffer_size >= size) {
+            std::vector<std::pair<RandomAccessIterator, RandomAccessIterator>> sources;
+            sources.reserve(bounds.size() - 1);
+            for (std::size_t idx = 0 ; idx + 1 < bounds.size() ; ++idx) {
+                sources.emplace_back(bounds[idx], bounds[idx + 1]);
+            }
+
+            auto out = buffer.begin();
+            k_way_merge(sources, std::move(compare), std::move(projection),
+                        [&out](RandomAccessIterator it) {
+                            *out = iter_move(it);
+                            ++out;
+                        });
+            detail::move(buffer.begin(), buffer.begin() + size, first);
+            return;
+        }
+
+        while (bounds.size() > 2) {
+            std::size_t nb_bounds = 0;
+            std::size_t idx = 0;
+            for (; idx + 2 < bounds.size() ; idx += 2) {
+                detail::inplace_merge(bounds[idx], bounds[idx + 1], bounds[idx + 2],
+                                      compare, projection,
+                                      bounds[idx + 1] - bounds[idx],
+                                      bounds[idx + 2] - bounds[idx + 1],
+                                      buffer.begin(), buffer_size);
+                bounds[nb_bounds++] = bounds[idx];
+            }
+            // Keep the run left alone if any, and the end
+            for (; idx < bounds.size() ; ++idx) {
+                bounds[nb_bounds++] = bounds[idx];
+            }
+            bounds.resize(nb_bounds);
+        }
+    }
+}}
+
+#endif // CPPSORT_DETAIL_K_WAY_MERGE_H_
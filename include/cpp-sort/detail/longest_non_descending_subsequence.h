@@ -18,6 +18,7 @@
 #include <cpp-sort/utility/static_const.h>
 #include "functional.h"
 #include "iterator_traits.h"
+#include "memory.h"
 #include "upper_bound.h"
 
 namespace cppsort
@@ -62,7 +63,7 @@ namespace detail
         auto&& proj = utility::as_function(projection);
 
         // Top (smaller) elements in patience sorting stacks
-        std::vector<ForwardIterator> stack_tops;
+        std::vector<ForwardIterator, resource_allocator<ForwardIterator>> stack_tops;
 
         while (first != last) {
             auto it = detail::upper_bound(
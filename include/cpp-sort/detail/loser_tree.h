@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_LOSER_TREE_H_
+#define CPPSORT_DETAIL_LOSER_TREE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "config.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Loser tree
+    //
+    // Tournament tree used to merge k sorted sources: the leaves
+    // are the sources, every internal node remembers the loser
+    // of the match played there, and the root remembers the
+    // overall winner. When the winning source advances, only
+    // the matches on the path from its leaf to the root are
+    // replayed, which takes ceil(log2(k)) comparisons.
+    //
+    // The tree only handles source indices: less(i, j) tells
+    // whether the current element of source i comes before the
+    // current element of source j. It must be a strict total
+    // order, where exhausted sources come after all the others,
+    // usually obtained by breaking ties with the indices.
+
+    template<typename Less>
+    class loser_tree
+    {
+        public:
+
+            loser_tree(std::size_t size, Less less):
+                size(size),
+                less(std::move(less)),
+                nodes(size)
+            {
+                CPPSORT_ASSERT(size > 0);
+
+                // Play every match bottom-up: node n has children
+                // 2n and 2n+1, and the leaf of source i is node
+                // size + i
+                std::vector<std::size_t> winners(size);
+                for (auto node = size - 1 ; node > 0 ; --node) {
+                    auto lhs = winner_of(2 * node, winners);
+                    auto rhs = winner_of(2 * node + 1, winners);
+                    if (this->less(rhs, lhs)) {
+                        winners[node] = rhs;
+                        nodes[node] = lhs;
+                    } else {
+                        winners[node] = lhs;
+                        nodes[node] = rhs;
+                    }
+                }
+                nodes[0] = (size == 1) ? 0 : winners[1];
+            }
+
+            // Source whose current element comes first
+            auto top() const noexcept
+                -> std::size_t
+            {
+                return nodes[0];
+            }
+
+            // To call once the winning source has advanced
+            auto replay()
+                -> void
+            {
+                auto winner = nodes[0];
+                for (auto node = (winner + size) / 2 ; node > 0 ; node /= 2) {
+                    if (less(nodes[node], winner)) {
+                        std::swap(nodes[node], winner);
+                    }
+                }
+                nodes[0] = winner;
+            }
+
+        private:
+
+            auto winner_of(std::size_t node, const std::vector<std::size_t>& winners) const
+                -> std::size_t
+            {
+                return (node >= size) ? node - size : winners[node];
+            }
+
+            std::size_t size;
+            Less less;
+            // nodes[0] holds the winner, the other nodes hold losers
+            std::vector<std::size_t> nodes;
+    };
+
+    template<typename Less>
+    auto make_loser_tree(std::size_t size, Less less)
+        -> loser_tree<Less>
+    {
+        return loser_tree<Less>(size, std::move(less));
+    }
+}}
+
+#endif // CPPSORT_DETAIL_LOSER_TREE_H_
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_LSD_RADIX_SORT_H_
+#define CPPSORT_DETAIL_LSD_RADIX_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "insertion_sort.h"
+#include "iterator_traits.h"
+#include "merge_sort.h"
+#include "move.h"
+#include "ska_sort.h"
+#include "type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Whether a type is sortable with lsd_radix_sort
+    //
+    // LSD radix sort reuses the ska_sort machinery to map keys to
+    // unsigned integers, but only handles keys made of a single
+    // fixed-width sub key: integers, floating point numbers and
+    // pointers, but neither booleans, nor lists, nor pairs.
+    //
+
+    template<typename T>
+    struct is_lsd_radix_sortable_impl
+    {
+        using sub_key = SubKey<T>;
+        using sub_key_type = typename sub_key::sub_key_type;
+
+        static constexpr bool value =
+            std::is_same<typename sub_key::next, SubKey<void>>::value &&
+            is_unsigned<sub_key_type>::value &&
+            not std::is_same<sub_key_type, bool>::value;
+    };
+
+    template<typename T>
+    struct is_lsd_radix_sortable:
+        conjunction<
+            is_ska_sortable<T>,
+            is_lsd_radix_sortable_impl<T>
+        >
+    {};
+
+    template<typename T>
+    constexpr bool is_lsd_radix_sortable_v = is_lsd_radix_sortable<T>::value;
+
+    ////////////////////////////////////////////////////////////
+    // LSD radix sort
+    //
+    // Every pass distributes the elements according to one byte
+    // of their key, starting from the least significant one, and
+    // ping-pongs between the collection and a buffer of the same
+    // size. The histograms of every byte are computed at once in
+    // a single pass over the collection before distributing the
+    // elements, which also makes it possible to skip the passes
+    // where every key has the same byte.
+    //
+
+    // Collections smaller than this are sorted with insertion sort
+    constexpr std::ptrdiff_t lsd_radix_sort_insertion_limit = 64;
+
+    template<typename InputIterator, typename OutputIterator,
+             typename Projection, typename KeyFunction>
+    auto lsd_radix_pass(InputIterator first, InputIterator last, OutputIterator result,
+                        std::array<std::size_t, 256>& offsets, int shift,
+                        Projection projection, KeyFunction key)
+        -> void
+    {
+        auto&& proj = utility::as_function(projection);
+
+        for (; first != last ; ++first) {
+            auto byte = static_cast<std::uint8_t>(key(proj(*first)) >> shift);
+            using utility::iter_move;
+            result[offsets[byte]++] = iter_move(first);
+        }
+    }
+
+    template<typename BufferProvider, typename RandomAccessIterator, typename Projection>
+    auto lsd_radix_sort(RandomAccessIterator first, RandomAccessIterator last,
+                        Projection projection)
+        -> void
+    {
+        using rvalue_type = rvalue_type_t<RandomAccessIterator>;
+        using sub_key = SubKey<projected_t<RandomAccessIterator, Projection>>;
+        using unsigned_type = typename sub_key::sub_key_type;
+        constexpr std::size_t num_bytes = sizeof(unsigned_type);
+
+        auto size = last - first;
+        if (size < lsd_radix_sort_insertion_limit) {
+            insertion_sort(std::move(first), std::move(last),
+                           std::less<>{}, std::move(projection));
+            return;
+        }
+
+        // Fall back to a stable algorithm that doesn't need to
+        // allocate a buffer as big as the collection
+        typename BufferProvider::template buffer<rvalue_type> buffer(size);
+        if (static_cast<std::ptrdiff_t>(buffer.size()) < size) {
+            merge_sort(std::move(first), std::move(last), size,
+                       std::less<>{}, std::move(projection));
+            return;
+        }
+
+        auto&& proj = utility::as_function(projection);
+        auto key = [](auto&& value) -> unsigned_type {
+            return sub_key::sub_key(value, nullptr);
+        };
+
+        // Compute the histograms of every byte in a single pass, the
+        // elements alternate between two sets of histograms so that
+        // consecutive keys sharing a byte don't have to wait for the
+        // previous increment of the same counter
+        using histograms_t = std::array<std::array<std::size_t, 256>, num_bytes>;
+        histograms_t counts = {};
+        histograms_t counts2 = {};
+        auto count_key = [](histograms_t& histograms, unsigned_type value) {
+            for (std::size_t byte = 0 ; byte < num_bytes ; ++byte) {
+                ++histograms[byte][static_cast<std::uint8_t>(value >> (8 * byte))];
+            }
+        };
+
+        auto it = first;
+        for (; last - it > 1 ; it += 2) {
+            count_key(counts, key(proj(*it)));
+            count_key(counts2, key(proj(it[1])));
+        }
+        if (it != last) {
+            count_key(counts, key(proj(*it)));
+        }
+        for (std::size_t byte = 0 ; byte < num_bytes ; ++byte) {
+            for (std::size_t idx = 0 ; idx < 256 ; ++idx) {
+                counts[byte][idx] += counts2[byte][idx];
+            }
+        }
+
+        auto first_key = key(proj(*first));
+        bool in_buffer = false;
+        for (std::size_t byte = 0 ; byte < num_bytes ; ++byte) {
+            auto& offsets = counts[byte];
+            int shift = static_cast<int>(8 * byte);
+
+            // Skip the pass if every key has the same byte
+            if (offsets[static_cast<std::uint8_t>(first_key >> shift)] == std::size_t(size)) {
+                continue;
+            }
+
+            // Turn the histogram into starting offsets
+            std::size_t total = 0;
+            for (auto& count: offsets) {
+                auto tmp = count;
+                count = total;
+                total += tmp;
+            }
+
+            if (in_buffer) {
+                lsd_radix_pass(buffer.begin(), buffer.begin() + size, first,
+                               offsets, shift, projection, key);
+            } else {
+                lsd_radix_pass(first, last, buffer.begin(),
+                               offsets, shift, projection, key);
+            }
+            in_buffer = not in_buffer;
+        }
+
+        if (in_buffer) {
+            detail::move(buffer.begin(), buffer.begin() + size, first);
+        }
+    }
+}}
+
+#endif // CPPSORT_DETAIL_LSD_RADIX_SORT_H_
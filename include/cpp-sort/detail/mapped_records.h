@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_MAPPED_RECORDS_H_
+#define CPPSORT_DETAIL_MAPPED_RECORDS_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "config.h"
+
+#if CPPSORT_MMAP_AVAILABLE
+
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "file_error.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // File of fixed-size records mapped in memory
+    //
+    // The whole file is mapped with MAP_SHARED so that changes
+    // made to the records go straight to the page cache, and
+    // the file is unmapped and closed on destruction.
+
+    template<typename Record>
+    class mapped_records
+    {
+        static_assert(std::is_trivially_copyable<Record>::value,
+                      "only files of trivially copyable records can be mapped");
+
+        public:
+
+            explicit mapped_records(const char* path):
+                fd(::open(path, O_RDWR))
+            {
+                if (fd == -1) {
+                    throw_file_error("cpp-sort: could not open the file to sort");
+                }
+
+                struct ::stat info;
+                if (::fstat(fd, &info) == -1) {
+                    close_and_throw("cpp-sort: could not get the size of the file to sort");
+                }
+                auto bytes = static_cast<std::size_t>(info.st_size);
+                if (bytes % sizeof(Record) != 0) {
+                    errno = EINVAL;
+                    close_and_throw("cpp-sort: the size of the file is not a multiple of the size of a record");
+                }
+                nb_records = bytes / sizeof(Record);
+                if (nb_records == 0) {
+                    // Empty files can't be mapped
+                    return;
+                }
+
+                void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (address == MAP_FAILED) {
+                    close_and_throw("cpp-sort: could not map the file to sort");
+                }
+                records = static_cast<Record*>(address);
+            }
+
+            mapped_records(const mapped_records&) = delete;
+            mapped_records& operator=(const mapped_records&) = delete;
+
+            ~mapped_records()
+            {
+                if (records != nullptr) {
+                    ::munmap(records, nb_records * sizeof(Record));
+                }
+                ::close(fd);
+            }
+
+            auto begin() const noexcept
+                -> Record*
+            {
+                return records;
+            }
+
+            auto end() const noexcept
+                -> Record*
+            {
+                return records + nb_records;
+            }
+
+            auto size() const noexcept
+                -> std::size_t
+            {
+                return nb_records;
+            }
+
+            // Hints about the way the records are about to be
+            // accessed, failures are harmless and ignored
+            auto advise(int advice) const noexcept
+                -> void
+            {
+                if (records != nullptr) {
+                    ::posix_madvise(records, nb_records * sizeof(Record), advice);
+                }
+            }
+
+        private:
+
+            [[noreturn]] auto close_and_throw(const char* what)
+                -> void
+            {
+                auto code = errno;
+                ::close(fd);
+                errno = code;
+                throw_file_error(what);
+            }
+
+            int fd;
+            Record* records = nullptr;
+            std::size_t nb_records = 0;
+    };
+}}
+
+#endif // CPPSORT_MMAP_AVAILABLE
+
+#endif // CPPSORT_DETAIL_MAPPED_RECORDS_H_
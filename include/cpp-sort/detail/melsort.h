@@ -17,6 +17,7 @@
 #include "functional.h"
 #include "iterator_traits.h"
 #include "lower_bound.h"
+#include "memory.h"
 #include "merge_move.h"
 #include "move.h"
 #include "type_traits.h"
@@ -26,7 +27,7 @@ namespace cppsort
 namespace detail
 {
     template<typename ForwardIterator, typename NodeType, typename Compare, typename Projection>
-    auto merge_encroaching_lists(std::vector<fixed_size_list<NodeType>>& lists,
+    auto merge_encroaching_lists(std::vector<fixed_size_list<NodeType>, resource_allocator<fixed_size_list<NodeType>>>& lists,
                                  ForwardIterator first, bool extract_edges,
                                  Compare compare, Projection projection)
     {
@@ -136,7 +137,7 @@ namespace detail
         // Encroaching lists
         using node_type = list_node<rvalue_type_t<ForwardIterator>>;
         fixed_size_list_node_pool<node_type> node_pool(size);
-        std::vector<fixed_size_list<node_type>> lists;
+        std::vector<fixed_size_list<node_type>, resource_allocator<fixed_size_list<node_type>>> lists;
         // Ensure that there is always one list and that the last list
         // always has at least one element, this simplifies the rest
         // of the computations
@@ -21,6 +21,9 @@
 #include <limits>
 #include <new>
 #include <type_traits>
+#include <utility>
+#include <cpp-sort/utility/memory_resource.h>
+#include <cpp-sort/utility/static_const.h>
 #include "type_traits.h"
 
 namespace cppsort
@@ -40,33 +43,93 @@ namespace detail
     }
 
     ////////////////////////////////////////////////////////////
-    // Deleter for ::operator new(std::size_t)
+    // Allocate raw memory with the current memory resource
 
-    struct operator_deleter
+    struct allocate_bytes_fn
     {
-        operator_deleter() = default;
+        auto operator()(std::size_t size) const
+            -> void*
+        {
+            return utility::get_memory_resource()->allocate(size);
+        }
+    };
+
+    namespace
+    {
+        constexpr auto&& allocate_bytes
+            = utility::static_const<allocate_bytes_fn>::value;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Deleter for allocate_bytes(std::size_t)
 
-#ifdef __cpp_sized_deallocation
+    struct operator_deleter
+    {
         std::size_t size = 0;
+        utility::memory_resource* resource = utility::get_memory_resource();
 
-        constexpr explicit operator_deleter(std::size_t size) noexcept:
+        operator_deleter() = default;
+
+        explicit operator_deleter(std::size_t size) noexcept:
             size(size)
         {}
 
-        inline auto operator()(void* pointer) const noexcept
+        auto operator()(void* pointer) const noexcept
             -> void
         {
-            ::operator delete(pointer, size);
+            resource->deallocate(pointer, size);
         }
-#else
-        constexpr explicit operator_deleter(std::size_t) noexcept {}
+    };
 
-        inline auto operator()(void* pointer) const noexcept
-            -> void
-        {
-            ::operator delete(pointer);
-        }
-#endif
+    ////////////////////////////////////////////////////////////
+    // Standard allocator using the current memory resource
+
+    template<typename T>
+    class resource_allocator
+    {
+        public:
+
+            using value_type = T;
+
+            resource_allocator() noexcept:
+                resource(utility::get_memory_resource())
+            {}
+
+            template<typename U>
+            resource_allocator(const resource_allocator<U>& other) noexcept:
+                resource(other.resource)
+            {}
+
+            auto allocate(std::size_t count)
+                -> T*
+            {
+                return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+            }
+
+            auto deallocate(T* ptr, std::size_t count) noexcept
+                -> void
+            {
+                resource->deallocate(ptr, count * sizeof(T), alignof(T));
+            }
+
+            friend auto operator==(const resource_allocator& lhs, const resource_allocator& rhs) noexcept
+                -> bool
+            {
+                return *lhs.resource == *rhs.resource;
+            }
+
+            friend auto operator!=(const resource_allocator& lhs, const resource_allocator& rhs) noexcept
+                -> bool
+            {
+                return not (lhs == rhs);
+            }
+
+        private:
+
+            template<typename U>
+            friend class resource_allocator;
+
+            utility::memory_resource* resource;
     };
 
     ////////////////////////////////////////////////////////////
@@ -124,6 +187,7 @@ namespace detail
 
     /*
      * @brief std::get_temporary_buffer on hormones
+     * @param resource Memory resource used to allocate the buffer
      * @param count Desired number of objects
      * @param min_count Number of objects small enough to give up
      *
@@ -133,7 +197,8 @@ namespace detail
      * than \a min_size objects.
      */
     template<typename T>
-    auto get_temporary_buffer(std::ptrdiff_t count, std::ptrdiff_t min_count) noexcept
+    auto get_temporary_buffer(utility::memory_resource* resource,
+                              std::ptrdiff_t count, std::ptrdiff_t min_count) noexcept
         -> std::pair<T*, std::ptrdiff_t>
     {
         std::pair<T*, std::ptrdiff_t> res(nullptr, 0);
@@ -147,7 +212,11 @@ namespace detail
         // Try to gradually allocate less memory until we get a valid buffer
         // or until the amount of memory to allocate reaches 0
         while (count > min_count) {
-            res.first = static_cast<T*>(::operator new(count * sizeof(T), std::nothrow));
+            try {
+                res.first = static_cast<T*>(resource->allocate(count * sizeof(T)));
+            } catch (const std::bad_alloc&) {
+                res.first = nullptr;
+            }
             if (res.first) {
                 res.second = count;
                 break;
@@ -158,15 +227,13 @@ namespace detail
     }
 
     template<typename T>
-    auto return_temporary_buffer(T* ptr, std::size_t count) noexcept
+    auto return_temporary_buffer(utility::memory_resource* resource,
+                                 T* ptr, std::size_t count) noexcept
         -> void
     {
-#ifdef __cpp_sized_deallocation
-        ::operator delete(ptr, count * sizeof(T));
-#else
-        (void)count;
-        ::operator delete(ptr);
-#endif
+        if (ptr) {
+            resource->deallocate(ptr, count * sizeof(T));
+        }
     }
 
     ////////////////////////////////////////////////////////////
@@ -191,24 +258,25 @@ namespace detail
 
             temporary_buffer(temporary_buffer&& other) noexcept:
                 buffer(other.buffer),
-                buffer_size(other.buffer_size)
+                buffer_size(other.buffer_size),
+                resource(other.resource)
             {
                 other.buffer = nullptr;
                 other.buffer_size = 0;
             }
 
-            constexpr temporary_buffer(std::nullptr_t) noexcept {}
+            temporary_buffer(std::nullptr_t) noexcept {}
 
             explicit temporary_buffer(std::ptrdiff_t count) noexcept
             {
-                auto tmp = get_temporary_buffer<T>(count, 0);
+                auto tmp = get_temporary_buffer<T>(resource, count, 0);
                 buffer = tmp.first;
                 buffer_size = tmp.second;
             }
 
             ~temporary_buffer() noexcept
             {
-                return_temporary_buffer<T>(buffer, buffer_size);
+                return_temporary_buffer<T>(resource, buffer, buffer_size);
             }
 
             ////////////////////////////////////////////////////////////
@@ -222,6 +290,7 @@ namespace detail
                 using std::swap;
                 swap(buffer, other.buffer);
                 swap(buffer_size, other.buffer_size);
+                swap(resource, other.resource);
                 return *this;
             }
 
@@ -246,13 +315,13 @@ namespace detail
             auto try_grow(std::ptrdiff_t count) noexcept
                 -> bool
             {
-                auto tmp = get_temporary_buffer<T>(count, buffer_size);
+                auto tmp = get_temporary_buffer<T>(resource, count, buffer_size);
                 if (not tmp.first) {
                     // If it failed to allocate a bigger buffer, keep the old one
                     return false;
                 }
                 // If the allocated buffer is big enough, replace the previous one
-                return_temporary_buffer(buffer, buffer_size);
+                return_temporary_buffer(resource, buffer, buffer_size);
                 buffer = tmp.first;
                 buffer_size = tmp.second;
                 return true;
@@ -262,6 +331,8 @@ namespace detail
 
             T* buffer = nullptr;
             std::ptrdiff_t buffer_size = 0;
+            // Resource used to allocate and deallocate the buffer
+            utility::memory_resource* resource = utility::get_memory_resource();
     };
 }}
 
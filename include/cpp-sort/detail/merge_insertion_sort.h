@@ -332,7 +332,7 @@ namespace detail
         chain.push_back(std::next(first));
 
         // Upper bounds for the insertion of pend elements
-        std::vector<typename list_t::iterator> pend;
+        std::vector<typename list_t::iterator, resource_allocator<typename list_t::iterator>> pend;
         pend.reserve((size + 1) / 2 - 1);
 
         for (auto it = first + 2 ; it != end ; it += 2) {
@@ -406,7 +406,7 @@ namespace detail
 
         using rvalue_type = rvalue_type_t<RandomAccessIterator>;
         std::unique_ptr<rvalue_type, operator_deleter> cache(
-            static_cast<rvalue_type*>(::operator new(full_size * sizeof(rvalue_type))),
+            static_cast<rvalue_type*>(allocate_bytes(full_size * sizeof(rvalue_type))),
             operator_deleter(full_size * sizeof(rvalue_type))
         );
         destruct_n<rvalue_type> d(0);
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_MERGE_SORT_H_
+#define CPPSORT_DETAIL_PARALLEL_MERGE_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include "iterator_traits.h"
+#include "memory.h"
+#include "merge_move.h"
+#include "merge_sort.h"
+#include "move.h"
+#include "task_pool.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    // Subranges smaller than this are never split
+    // further across several tasks
+    constexpr std::ptrdiff_t parallel_merge_sort_grain = 4096;
+
+    ////////////////////////////////////////////////////////////
+    // Co-ranking
+    //
+    // Given two sorted ranges A and B and a position pos in the
+    // merged output, find the number of elements i of A such that
+    // A[0, i) and B[0, pos - i) are exactly the first pos elements
+    // of the stable merge of A and B. Equivalent elements of A are
+    // considered smaller than those of B to preserve stability.
+    //
+
+    template<typename RandomAccessIterator1, typename RandomAccessIterator2,
+             typename Compare, typename Projection>
+    auto merge_corank(RandomAccessIterator1 first1, difference_type_t<RandomAccessIterator1> size1,
+                      RandomAccessIterator2 first2, difference_type_t<RandomAccessIterator1> size2,
+                      difference_type_t<RandomAccessIterator1> pos,
+                      Compare compare, Projection projection)
+        -> difference_type_t<RandomAccessIterator1>
+    {
+        auto&& comp = utility::as_function(compare);
+        auto&& proj = utility::as_function(projection);
+
+        auto lo = std::max(pos - size2, decltype(pos)(0));
+        auto hi = std::min(pos, size1);
+        while (lo < hi) {
+            // Find the biggest i such that A[i-1] <= B[pos-i]
+            auto i = lo + (hi - lo + 1) / 2;
+            if (comp(proj(first2[pos - i]), proj(first1[i - 1]))) {
+                hi = i - 1;
+            } else {
+                lo = i;
+            }
+        }
+        return lo;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Parallel merge
+    //
+    // Splits the output into pieces of similar sizes, co-ranks
+    // the boundaries of every piece and merges the pieces in
+    // parallel; the output range must not overlap the inputs
+
+    template<typename RandomAccessIterator1, typename RandomAccessIterator2,
+             typename Compare, typename Projection>
+    auto parallel_merge_move(task_pool& pool,
+                             RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+                             RandomAccessIterator1 first2, RandomAccessIterator1 last2,
+                             RandomAccessIterator2 result,
+                             Compare compare, Projection projection)
+        -> void
+    {
+        using difference_type = difference_type_t<RandomAccessIterator1>;
+        auto size1 = last1 - first1;
+        auto size2 = last2 - first2;
+        auto size = size1 + size2;
+
+        auto nb_pieces = std::min(
+            size / parallel_merge_sort_grain,
+            static_cast<difference_type>(pool.size())
+        );
+        if (nb_pieces <= 1) {
+            merge_move(first1, last1, first2, last2, result,
+                       std::move(compare), projection, projection);
+            return;
+        }
+
+        // Co-rank every boundary before merging anything: merging moves
+        // elements out of the input ranges, which would otherwise make
+        // the co-ranking of the other pieces read moved-from elements
+        std::vector<difference_type> boundaries(nb_pieces + 1);
+        boundaries[nb_pieces] = size1;
+        for (difference_type piece = 1 ; piece < nb_pieces ; ++piece) {
+            boundaries[piece] = merge_corank(first1, size1, first2, size2,
+                                             size * piece / nb_pieces,
+                                             compare, projection);
+        }
+
+        parallel_for(pool, difference_type(0), nb_pieces, [&](difference_type piece) {
+            auto begin = size * piece / nb_pieces;
+            auto end = size * (piece + 1) / nb_pieces;
+            auto begin1 = boundaries[piece];
+            auto end1 = boundaries[piece + 1];
+            merge_move(first1 + begin1, first1 + end1,
+                       first2 + (begin - begin1), first2 + (end - end1),
+                       result + begin, compare, projection, projection);
+        });
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Parallel merge sort
+    //
+    // The sort ping-pongs between the collection and a buffer of
+    // the same size: parallel_merge_sort_inplace sorts a range in
+    // place by merging into it two halves sorted into the buffer,
+    // while parallel_merge_sort_to sorts a range into the buffer
+    // by merging two halves sorted in place. Subranges smaller
+    // than leaf_size are sorted sequentially with merge_sort.
+
+    template<typename RandomAccessIterator1, typename RandomAccessIterator2,
+             typename Compare, typename Projection>
+    auto parallel_merge_sort_to(task_pool& pool,
+                                RandomAccessIterator1 first, RandomAccessIterator2 buffer,
+                                difference_type_t<RandomAccessIterator1> size,
+                                difference_type_t<RandomAccessIterator1> leaf_size,
+                                Compare compare, Projection projection)
+        -> void;
+
+    template<typename RandomAccessIterator1, typename RandomAccessIterator2,
+             typename Compare, typename Projection>
+    auto parallel_merge_sort_inplace(task_pool& pool,
+                                     RandomAccessIterator1 first, RandomAccessIterator2 buffer,
+                                     difference_type_t<RandomAccessIterator1> size,
+                                     difference_type_t<RandomAccessIterator1> leaf_size,
+                                     Compare compare, Projection projection)
+        -> void
+    {
+        if (size <= leaf_size) {
+            merge_sort(first, first + size, size, std::move(compare), std::move(projection));
+            return;
+        }
+
+        auto half = size / 2;
+        parallel_invoke(pool,
+            [&] {
+                parallel_merge_sort_to(pool, first, buffer, half, leaf_size,
+                                       compare, projection);
+            },
+            [&] {
+                parallel_merge_sort_to(pool, first + half, buffer + half, size - half, leaf_size,
+                                       compare, projection);
+            }
+        );
+        parallel_merge_move(pool, buffer, buffer + half, buffer + half, buffer + size,
+                            first, std::move(compare), std::move(projection));
+    }
+
+    template<typename RandomAccessIterator1, typename RandomAccessIterator2,
+             typename Compare, typename Projection>
+    auto parallel_merge_sort_to(task_pool& pool,
+                                RandomAccessIterator1 first, RandomAccessIterator2 buffer,
+                                difference_type_t<RandomAccessIterator1> size,
+                                difference_type_t<RandomAccessIterator1> leaf_size,
+                                Compare compare, Projection projection)
+        -> void
+    {
+        if (size <= leaf_size) {
+            merge_sort(first, first + size, size, std::move(compare), std::move(projection));
+            detail::move(first, first + size, buffer);
+            return;
+        }
+
+        auto half = size / 2;
+        parallel_invoke(pool,
+            [&] {
+                parallel_merge_sort_inplace(pool, first, buffer, half, leaf_size,
+                                            compare, projection);
+            },
+            [&] {
+                parallel_merge_sort_inplace(pool, first + half, buffer + half, size - half, leaf_size,
+                                            compare, projection);
+            }
+        );
+        parallel_merge_move(pool, first, first + half, first + half, first + size,
+                            buffer, std::move(compare), std::move(projection));
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto parallel_merge_sort(RandomAccessIterator first, RandomAccessIterator last,
+                             Compare compare, Projection projection,
+                             std::size_t nb_threads)
+        -> void
+    {
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        using rvalue_type = rvalue_type_t<RandomAccessIterator>;
+        auto size = last - first;
+
+        // Don't spawn threads that wouldn't have enough work
+        nb_threads = std::min(
+            task_pool::default_nb_threads(nb_threads),
+            static_cast<std::size_t>(size / parallel_merge_sort_grain)
+        );
+        if (nb_threads <= 1) {
+            merge_sort(std::move(first), std::move(last), size,
+                       std::move(compare), std::move(projection));
+            return;
+        }
+
+        // The parallel algorithm needs a buffer as big as the collection,
+        // fall back to the memory-adaptive sequential one otherwise
+        temporary_buffer<rvalue_type> buffer(size);
+        if (buffer.size() < size) {
+            merge_sort(std::move(first), std::move(last), size,
+                       std::move(compare), std::move(projection));
+            return;
+        }
+
+        // Give every thread several subranges to sort for load balancing
+        auto leaf_size = std::max(
+            parallel_merge_sort_grain,
+            size / static_cast<difference_type>(8 * nb_threads)
+        );
+
+        task_pool pool(nb_threads);
+        if (std::is_trivial<rvalue_type>::value) {
+            // Trivial types can be assigned to raw memory, so we can use
+            // the buffer directly as scratch memory
+            parallel_merge_sort_inplace(pool, first, buffer.data(), size, leaf_size,
+                                        std::move(compare), std::move(projection));
+        } else {
+            // The ping-pong scheme only ever move-assigns, so move the
+            // elements to the buffer first to get live objects there,
+            // then sort them back into the original collection
+            destruct_n<rvalue_type> d(0);
+            std::unique_ptr<rvalue_type, destruct_n<rvalue_type>&> h2(buffer.data(), d);
+            uninitialized_move(first, last, buffer.data(), d);
+            parallel_merge_sort_to(pool, buffer.data(), first, size, leaf_size,
+                                   std::move(compare), std::move(projection));
+        }
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_MERGE_SORT_H_
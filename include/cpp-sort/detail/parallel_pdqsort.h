@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_PDQSORT_H_
+#define CPPSORT_DETAIL_PARALLEL_PDQSORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/branchless_traits.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "bitops.h"
+#include "heapsort.h"
+#include "iterator_traits.h"
+#include "iter_sort3.h"
+#include "pdqsort.h"
+#include "swap_ranges.h"
+#include "task_pool.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    // Default size under which subranges are sorted sequentially
+    constexpr std::size_t parallel_pdqsort_grain = 8192;
+
+    namespace pdqsort_detail
+    {
+        ////////////////////////////////////////////////////////////
+        // Sequential partition of a chunk for the parallel partition
+        //
+        // Both functions partition [first, last) so that elements
+        // smaller than the pivot come first, and return the partition
+        // point along with whether any element had to be moved. The
+        // branchless version is a Lomuto partition where the swap is
+        // unconditional, which suits cheap-to-swap elements.
+
+        template<typename RandomAccessIterator, typename T,
+                 typename Compare, typename Projection>
+        auto partition_chunk(RandomAccessIterator first, RandomAccessIterator last,
+                             const T& pivot_proj, Compare compare, Projection projection,
+                             std::false_type /* branchless */)
+            -> std::pair<RandomAccessIterator, bool>
+        {
+            using utility::iter_swap;
+            auto&& comp = utility::as_function(compare);
+            auto&& proj = utility::as_function(projection);
+
+            bool moved = false;
+            while (true) {
+                while (first != last && comp(proj(*first), pivot_proj)) {
+                    ++first;
+                }
+                do {
+                    if (first == last) {
+                        return { first, moved };
+                    }
+                    --last;
+                } while (not comp(proj(*last), pivot_proj));
+                iter_swap(first, last);
+                moved = true;
+                ++first;
+            }
+        }
+
+        template<typename RandomAccessIterator, typename T,
+                 typename Compare, typename Projection>
+        auto partition_chunk(RandomAccessIterator first, RandomAccessIterator last,
+                             const T& pivot_proj, Compare compare, Projection projection,
+                             std::true_type /* branchless */)
+            -> std::pair<RandomAccessIterator, bool>
+        {
+            using utility::iter_swap;
+            auto&& comp = utility::as_function(compare);
+            auto&& proj = utility::as_function(projection);
+
+            bool moved = false;
+            auto split = first;
+            for (; first != last ; ++first) {
+                bool smaller = comp(proj(*first), pivot_proj);
+                moved |= smaller & (split != first);
+                iter_swap(split, first);
+                split += smaller;
+            }
+            return { split, moved };
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Parallel partition
+        //
+        // Same contract as partition_right: partitions [begin, end)
+        // around the pivot *begin, puts the elements equal to the
+        // pivot in the right partition and returns the position of
+        // the pivot along with whether the sequence was already
+        // partitioned. Chunks of the collection are first partitioned
+        // in parallel, then the elements that ended on the wrong side
+        // of the global partition point are swapped in parallel.
+
+        template<bool Branchless, typename RandomAccessIterator,
+                 typename Compare, typename Projection>
+        auto parallel_partition_right(task_pool& pool,
+                                      RandomAccessIterator begin, RandomAccessIterator end,
+                                      Compare compare, Projection projection)
+            -> std::pair<RandomAccessIterator, bool>
+        {
+            using utility::iter_move;
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            using interval = std::pair<difference_type, difference_type>;
+            auto&& proj = utility::as_function(projection);
+
+            // The pivot stays at *begin during the whole partition
+            auto&& pivot_proj = proj(*begin);
+            auto first = begin + 1;
+            difference_type size = end - first;
+            auto nb_chunks = static_cast<difference_type>(pool.size());
+
+            // Partition every chunk independently
+            std::vector<difference_type> splits(nb_chunks);
+            std::vector<unsigned char> moved(nb_chunks);
+            parallel_for(pool, difference_type(0), nb_chunks, [&](difference_type chunk) {
+                auto res = partition_chunk(first + size * chunk / nb_chunks,
+                                           first + size * (chunk + 1) / nb_chunks,
+                                           pivot_proj, compare, projection,
+                                           std::integral_constant<bool, Branchless>{});
+                splits[chunk] = res.first - first;
+                moved[chunk] = res.second;
+            });
+
+            // Find the global partition point
+            difference_type mid = 0;
+            for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                mid += splits[chunk] - size * chunk / nb_chunks;
+            }
+
+            // Collect the intervals of elements that are on the wrong side
+            // of the partition point: there are as many big elements left
+            // of it as there are small elements right of it
+            std::vector<interval> misplaced_big;
+            std::vector<interval> misplaced_small;
+            difference_type nb_misplaced = 0;
+            for (difference_type chunk = 0 ; chunk < nb_chunks ; ++chunk) {
+                auto lo = size * chunk / nb_chunks;
+                auto hi = size * (chunk + 1) / nb_chunks;
+                auto split = splits[chunk];
+                if (split < mid && hi > split) {
+                    misplaced_big.emplace_back(split, (std::min)(hi, mid));
+                    nb_misplaced += misplaced_big.back().second - split;
+                }
+                if (split > mid && lo < split) {
+                    misplaced_small.emplace_back((std::max)(lo, mid), split);
+                }
+            }
+
+            bool already_partitioned = nb_misplaced == 0 &&
+                std::none_of(moved.begin(), moved.end(), [](unsigned char m) { return m; });
+
+            // Swap the misplaced elements pairwise, splitting the work in
+            // pieces that start at arbitrary positions in the intervals
+            if (nb_misplaced > 0) {
+                constexpr auto grain = static_cast<difference_type>(parallel_pdqsort_grain);
+                auto nb_pieces = (std::min)(nb_chunks, (nb_misplaced + grain - 1) / grain);
+                auto locate = [](const std::vector<interval>& intervals, difference_type pos) {
+                    std::size_t idx = 0;
+                    while (pos >= intervals[idx].second - intervals[idx].first) {
+                        pos -= intervals[idx].second - intervals[idx].first;
+                        ++idx;
+                    }
+                    return std::make_pair(idx, intervals[idx].first + pos);
+                };
+                parallel_for(pool, difference_type(0), nb_pieces, [&](difference_type piece) {
+                    auto piece_begin = nb_misplaced * piece / nb_pieces;
+                    auto count = nb_misplaced * (piece + 1) / nb_pieces - piece_begin;
+                    auto big = locate(misplaced_big, piece_begin);
+                    auto small = locate(misplaced_small, piece_begin);
+                    while (count > 0) {
+                        auto n = (std::min)({
+                            count,
+                            misplaced_big[big.first].second - big.second,
+                            misplaced_small[small.first].second - small.second
+                        });
+                        swap_ranges_inner(first + big.second, first + (big.second + n),
+                                          first + small.second);
+                        count -= n;
+                        big.second += n;
+                        small.second += n;
+                        if (big.second == misplaced_big[big.first].second && count > 0) {
+                            ++big.first;
+                            big.second = misplaced_big[big.first].first;
+                        }
+                        if (small.second == misplaced_small[small.first].second && count > 0) {
+                            ++small.first;
+                            small.second = misplaced_small[small.first].first;
+                        }
+                    }
+                });
+            }
+
+            // Put the pivot in the right place
+            auto pivot_pos = begin + mid;
+            if (pivot_pos != begin) {
+                auto pivot = iter_move(begin);
+                *begin = iter_move(pivot_pos);
+                *pivot_pos = std::move(pivot);
+            }
+
+            return std::make_pair(pivot_pos, already_partitioned);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Parallel pdqsort loop
+        //
+        // Same as pdqsort_loop except that both partitions are sorted
+        // in parallel and that big partitions are partitioned in
+        // parallel; subranges smaller than grain_size are handed to
+        // the sequential algorithm.
+
+        template<typename RandomAccessIterator, typename Compare, typename Projection,
+                 bool Branchless>
+        auto parallel_pdqsort_loop(task_pool& pool,
+                                   RandomAccessIterator begin, RandomAccessIterator end,
+                                   Compare compare, Projection projection,
+                                   int bad_allowed, bool leftmost,
+                                   difference_type_t<RandomAccessIterator> grain_size)
+            -> void
+        {
+            using utility::iter_swap;
+            using difference_type = difference_type_t<RandomAccessIterator>;
+            auto&& comp = utility::as_function(compare);
+            auto&& proj = utility::as_function(projection);
+
+            while (true) {
+                difference_type size = end - begin;
+
+                if (size <= grain_size) {
+                    pdqsort_loop<RandomAccessIterator, Compare, Projection, Branchless>(
+                        std::move(begin), std::move(end),
+                        std::move(compare), std::move(projection),
+                        bad_allowed, leftmost);
+                    return;
+                }
+
+                // Choose pivot as pseudomedian of 9.
+                difference_type s2 = size / 2;
+                iter_sort3(begin, begin + s2, end - 1, compare, projection);
+                iter_sort3(begin + 1, begin + (s2 - 1), end - 2, compare, projection);
+                iter_sort3(begin + 2, begin + (s2 + 1), end - 3, compare, projection);
+                iter_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), compare, projection);
+                iter_swap(begin, begin + s2);
+
+                // Equal elements go to the left partition, see pdqsort_loop
+                if (!leftmost && !comp(proj(*(begin - 1)), proj(*begin))) {
+                    begin = partition_left(begin, end, compare, projection) + 1;
+                    continue;
+                }
+
+                // Partition in parallel when every thread gets enough work
+                std::pair<RandomAccessIterator, bool> part_result =
+                    size / difference_type(pool.size()) >= grain_size ?
+                        parallel_partition_right<Branchless>(pool, begin, end, compare, projection) :
+                    Branchless ?
+                        partition_right_branchless(begin, end, compare, projection) :
+                        partition_right(begin, end, compare, projection);
+                RandomAccessIterator pivot_pos = part_result.first;
+                bool already_partitioned = part_result.second;
+
+                // Check for a highly unbalanced partition.
+                difference_type l_size = pivot_pos - begin;
+                difference_type r_size = end - (pivot_pos + 1);
+                bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+                // If we got a highly unbalanced partition we shuffle elements to break many patterns.
+                if (highly_unbalanced) {
+                    // If we had too many bad partitions, switch to heapsort to guarantee O(n log n).
+                    if (--bad_allowed == 0) {
+                        heapsort(std::move(begin), std::move(end),
+                                 std::move(compare), std::move(projection));
+                        return;
+                    }
+
+                    if (l_size >= insertion_sort_threshold) {
+                        iter_swap(begin,             begin + l_size / 4);
+                        iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+
+                        if (l_size > ninther_threshold) {
+                            iter_swap(begin + 1,         begin + (l_size / 4 + 1));
+                            iter_swap(begin + 2,         begin + (l_size / 4 + 2));
+                            iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                            iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                        }
+                    }
+
+                    if (r_size >= insertion_sort_threshold) {
+                        iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                        iter_swap(end - 1,                   end - r_size / 4);
+
+                        if (r_size > ninther_threshold) {
+                            iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                            iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                            iter_swap(end - 2,             end - (1 + r_size / 4));
+                            iter_swap(end - 3,             end - (2 + r_size / 4));
+                        }
+                    }
+                } else {
+                    // If we were decently balanced and we tried to sort an already partitioned
+                    // sequence try to use insertion sort.
+                    if (already_partitioned &&
+                        partial_insertion_sort(begin, pivot_pos, compare, projection) &&
+                        partial_insertion_sort(pivot_pos + 1, end, compare, projection)) {
+                        return;
+                    }
+                }
+
+                // Sort both partitions in parallel
+                parallel_invoke(pool,
+                    [&] {
+                        parallel_pdqsort_loop<RandomAccessIterator, Compare, Projection, Branchless>(
+                            pool, begin, pivot_pos, compare, projection,
+                            bad_allowed, leftmost, grain_size);
+                    },
+                    [&] {
+                        parallel_pdqsort_loop<RandomAccessIterator, Compare, Projection, Branchless>(
+                            pool, pivot_pos + 1, end, compare, projection,
+                            bad_allowed, false, grain_size);
+                    }
+                );
+                return;
+            }
+        }
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto parallel_pdqsort(RandomAccessIterator begin, RandomAccessIterator end,
+                          Compare compare, Projection projection,
+                          std::size_t nb_threads, std::size_t grain_size)
+        -> void
+    {
+        using difference_type = difference_type_t<RandomAccessIterator>;
+        using value_type = value_type_t<RandomAccessIterator>;
+        using projected_type = projected_t<RandomAccessIterator, Projection>;
+        constexpr bool is_branchless =
+            utility::is_probably_branchless_comparison_v<Compare, projected_type> &&
+            utility::is_probably_branchless_projection_v<Projection, value_type>;
+
+        auto size = end - begin;
+        if (size < 2) return;
+
+        // The parallel loop relies on the pseudomedian of 9
+        grain_size = (std::max)(grain_size, std::size_t(pdqsort_detail::ninther_threshold));
+
+        // Don't spawn threads that wouldn't have enough work
+        nb_threads = (std::min)(
+            task_pool::default_nb_threads(nb_threads),
+            static_cast<std::size_t>(size) / grain_size
+        );
+        if (nb_threads <= 1) {
+            pdqsort(std::move(begin), std::move(end),
+                    std::move(compare), std::move(projection));
+            return;
+        }
+
+        task_pool pool(nb_threads);
+        pdqsort_detail::parallel_pdqsort_loop<RandomAccessIterator, Compare, Projection, is_branchless>(
+            pool, std::move(begin), std::move(end),
+            std::move(compare), std::move(projection),
+            detail::log2(size), true, static_cast<difference_type>(grain_size));
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_PDQSORT_H_
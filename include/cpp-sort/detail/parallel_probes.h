@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_PROBES_H_
+#define CPPSORT_DETAIL_PARALLEL_PROBES_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "count_inversions.h"
+#include "functional.h"
+#include "iterator_traits.h"
+#include "memory.h"
+#include "move.h"
+#include "parallel_merge_sort.h"
+#include "parallel_pdqsort.h"
+#include "task_pool.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    // Ranges smaller than this are never split
+    // further across several tasks
+    constexpr std::ptrdiff_t parallel_probe_grain = 4096;
+
+    ////////////////////////////////////////////////////////////
+    // Number of threads worth spawning to analyze size elements,
+    // a result of 1 or less means that the sequential probe
+    // should be used instead
+
+    template<typename Difference>
+    auto parallel_probe_nb_threads(std::size_t nb_threads, Difference size) noexcept
+        -> std::size_t
+    {
+        return std::min(
+            task_pool::default_nb_threads(nb_threads),
+            static_cast<std::size_t>(size / parallel_probe_grain)
+        );
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Chunked parallel loops
+    //
+    // Split [0, size) into chunks of similar sizes, with a few
+    // chunks per thread for load balancing, and call func on
+    // every chunk in parallel. parallel_map_chunks additionally
+    // returns the results of func in the order of the chunks.
+
+    template<typename Func>
+    auto parallel_for_chunks(task_pool& pool, std::ptrdiff_t size, Func func)
+        -> std::ptrdiff_t
+    {
+        auto nb_chunks = std::max(
+            std::min(size / parallel_probe_grain, static_cast<std::ptrdiff_t>(8 * pool.size())),
+            std::ptrdiff_t(1)
+        );
+        parallel_for(pool, std::ptrdiff_t(0), nb_chunks, [&](std::ptrdiff_t idx) {
+            func(idx, size * idx / nb_chunks, size * (idx + 1) / nb_chunks);
+        });
+        return nb_chunks;
+    }
+
+    template<typename Result, typename Func>
+    auto parallel_map_chunks(task_pool& pool, std::ptrdiff_t size, Func func)
+        -> std::vector<Result>
+    {
+        // Don't use std::vector<bool> here, its elements can't
+        // be written concurrently
+        std::vector<Result> results(8 * pool.size());
+        auto nb_chunks = parallel_for_chunks(pool, size,
+            [&](std::ptrdiff_t idx, std::ptrdiff_t begin, std::ptrdiff_t end) {
+                results[static_cast<std::size_t>(idx)] = func(begin, end);
+            }
+        );
+        results.resize(static_cast<std::size_t>(nb_chunks));
+        return results;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Iterators to the elements of [first, last) sorted on the
+    // pointed values with a parallel sort
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto parallel_sort_iterators(RandomAccessIterator first, RandomAccessIterator last,
+                                 Compare compare, Projection projection,
+                                 std::size_t nb_threads)
+        -> std::vector<RandomAccessIterator, resource_allocator<RandomAccessIterator>>
+    {
+        std::vector<RandomAccessIterator, resource_allocator<RandomAccessIterator>> iterators;
+        iterators.reserve(last - first);
+        for (auto it = first ; it != last ; ++it) {
+            iterators.push_back(it);
+        }
+
+        parallel_pdqsort(iterators.begin(), iterators.end(),
+                         std::move(compare), indirect(std::move(projection)),
+                         nb_threads, parallel_pdqsort_grain);
+        return iterators;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Parallel inversion counting
+    //
+    // Same algorithm as count_inversions, except that both halves
+    // are handled in parallel and that big merges are split into
+    // pieces merged in parallel: the boundaries of the pieces are
+    // found with co-ranking, and every element taken from the right
+    // half adds the number of elements of the left half that it
+    // precedes in the merge. The results of both halves are merged
+    // into the cache then moved back in parallel.
+
+    template<
+        typename ResultType,
+        typename RandomAccessIterator1,
+        typename RandomAccessIterator2,
+        typename Compare,
+        typename Projection
+    >
+    auto parallel_count_inversions_merge(task_pool& pool,
+                                         RandomAccessIterator1 first, RandomAccessIterator1 middle,
+                                         RandomAccessIterator1 last, RandomAccessIterator2 cache,
+                                         Compare compare, Projection projection)
+        -> ResultType
+    {
+        using difference_type = difference_type_t<RandomAccessIterator1>;
+        auto size1 = middle - first;
+        auto size2 = last - middle;
+        auto size = size1 + size2;
+
+        auto counts = parallel_map_chunks<ResultType>(pool, size,
+            [&](difference_type begin_pos, difference_type end_pos) {
+                using utility::iter_move;
+                auto&& comp = utility::as_function(compare);
+                auto&& proj = utility::as_function(projection);
+
+                auto begin1 = merge_corank(first, size1, middle, size2, begin_pos, compare, projection);
+                auto end1 = merge_corank(first, size1, middle, size2, end_pos, compare, projection);
+                auto it1 = first + begin1;
+                auto last1 = first + end1;
+                auto it2 = middle + (begin_pos - begin1);
+                auto last2 = middle + (end_pos - end1);
+                auto out = cache + begin_pos;
+
+                ResultType inversions = 0;
+                for (; it1 != last1 && it2 != last2 ; ++out) {
+                    if (comp(proj(*it2), proj(*it1))) {
+                        *out = iter_move(it2);
+                        ++it2;
+                        inversions += middle - it1;
+                    } else {
+                        *out = iter_move(it1);
+                        ++it1;
+                    }
+                }
+                // Elements left in the right half of the piece precede
+                // all the elements of the left half from it1 onwards
+                inversions += (last2 - it2) * (middle - it1);
+                out = detail::move(it1, last1, out);
+                detail::move(it2, last2, out);
+                return inversions;
+            }
+        );
+
+        parallel_for_chunks(pool, size,
+            [&](std::ptrdiff_t, difference_type begin_pos, difference_type end_pos) {
+                detail::move(cache + begin_pos, cache + end_pos, first + begin_pos);
+            }
+        );
+
+        ResultType inversions = 0;
+        for (auto count: counts) {
+            inversions += count;
+        }
+        return inversions;
+    }
+
+    template<
+        typename ResultType,
+        typename RandomAccessIterator1,
+        typename RandomAccessIterator2,
+        typename Compare,
+        typename Projection
+    >
+    auto parallel_count_inversions(task_pool& pool,
+                                   RandomAccessIterator1 first, RandomAccessIterator1 last,
+                                   RandomAccessIterator2 cache,
+                                   difference_type_t<RandomAccessIterator1> leaf_size,
+                                   Compare compare, Projection projection)
+        -> ResultType
+    {
+        auto size = last - first;
+        if (size <= leaf_size) {
+            return count_inversions<ResultType>(first, last, cache,
+                                                std::move(compare), std::move(projection));
+        }
+
+        auto half = size / 2;
+        ResultType inversions_left = 0;
+        ResultType inversions_right = 0;
+        parallel_invoke(pool,
+            [&] {
+                inversions_left = parallel_count_inversions<ResultType>(
+                    pool, first, first + half, cache, leaf_size, compare, projection
+                );
+            },
+            [&] {
+                inversions_right = parallel_count_inversions<ResultType>(
+                    pool, first + half, last, cache + half, leaf_size, compare, projection
+                );
+            }
+        );
+
+        return inversions_left + inversions_right
+             + parallel_count_inversions_merge<ResultType>(pool, first, first + half, last, cache,
+                                                           std::move(compare), std::move(projection));
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_PROBES_H_
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARALLEL_SKA_SORT_H_
+#define CPPSORT_DETAIL_PARALLEL_SKA_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "iterator_traits.h"
+#include "memory.h"
+#include "move.h"
+#include "ska_sort.h"
+#include "task_pool.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    // Subranges smaller than this are never split
+    // further across several tasks
+    constexpr std::ptrdiff_t parallel_ska_sort_grain = 16384;
+
+    ////////////////////////////////////////////////////////////
+    // Parallel MSD radix sort
+    //
+    // The parallel passes are only used for sub keys that are
+    // unsigned integers, one byte at a time from the most
+    // significant one. Every pass splits the subrange into
+    // chunks, computes the histogram of every chunk in parallel,
+    // then uses a prefix sum of these histograms to give every
+    // chunk its own destination slots in every bucket, so that
+    // the chunks can be scattered in parallel without any
+    // synchronization. The scatter is done out-of-place and
+    // ping-pongs between the collection and a buffer of the same
+    // size. Passes where every element falls in the same bucket
+    // are skipped without moving anything. The buckets are then
+    // sorted in parallel on the task pool, and the ones smaller
+    // than the grain are sorted with the sequential ska_sort.
+    //
+
+    template<typename CurrentSubKey, std::size_t NumBytes, std::size_t Offset=0>
+    struct ParallelUnsignedSorter
+    {
+        using sequential_sorter = UnsignedInplaceSorter<128, 1024, CurrentSubKey, NumBytes, Offset>;
+        using next_sorter = ParallelUnsignedSorter<CurrentSubKey, NumBytes, Offset + 1>;
+
+        template<typename RandomAccessIterator, typename BufferIterator, typename Projection>
+        static auto sort(task_pool& pool, RandomAccessIterator first, BufferIterator buffer,
+                         std::ptrdiff_t size, bool in_buffer, Projection projection,
+                         void (*next_sort)(RandomAccessIterator, RandomAccessIterator, std::ptrdiff_t, Projection, void*))
+            -> void
+        {
+            if (size < parallel_ska_sort_grain) {
+                if (in_buffer) {
+                    detail::move(buffer, buffer + size, first);
+                }
+                if (not StdSortIfLessThanThreshold<128>(first, first + size, size, projection)) {
+                    sequential_sorter::sort(first, first + size, size, std::move(projection),
+                                            next_sort, nullptr);
+                }
+                return;
+            }
+
+            if (in_buffer) {
+                parallel_pass(pool, first, buffer, buffer, first, size, in_buffer,
+                              std::move(projection), next_sort);
+            } else {
+                parallel_pass(pool, first, buffer, first, buffer, size, in_buffer,
+                              std::move(projection), next_sort);
+            }
+        }
+
+        template<typename RandomAccessIterator, typename BufferIterator,
+                 typename SourceIterator, typename DestinationIterator,
+                 typename Projection>
+        static auto parallel_pass(task_pool& pool, RandomAccessIterator first, BufferIterator buffer,
+                                  SourceIterator source, DestinationIterator destination,
+                                  std::ptrdiff_t size, bool in_buffer, Projection projection,
+                                  void (*next_sort)(RandomAccessIterator, RandomAccessIterator, std::ptrdiff_t, Projection, void*))
+            -> void
+        {
+            using histogram = std::array<std::ptrdiff_t, 256>;
+            auto&& proj = utility::as_function(projection);
+
+            auto nb_chunks = std::min(
+                size / parallel_ska_sort_grain,
+                static_cast<std::ptrdiff_t>(pool.size())
+            );
+            auto chunk_begin = [&](std::ptrdiff_t chunk) {
+                return size * chunk / nb_chunks;
+            };
+
+            // Compute the histogram of every chunk
+            std::vector<histogram> counts(nb_chunks);
+            parallel_for(pool, std::ptrdiff_t(0), nb_chunks, [&](std::ptrdiff_t chunk) {
+                auto& count = counts[chunk];
+                count.fill(0);
+                auto it = source + chunk_begin(chunk);
+                auto last = source + chunk_begin(chunk + 1);
+                for (; it != last ; ++it) {
+                    ++count[sequential_sorter::current_byte(proj(*it), nullptr)];
+                }
+            });
+
+            // Prefix sum of the histograms: the slots of a bucket are
+            // given to the chunks in order, which means that every
+            // chunk knows where to write its elements
+            histogram bucket_ends;
+            std::ptrdiff_t total = 0;
+            int nb_buckets = 0;
+            for (int bucket = 0 ; bucket < 256 ; ++bucket) {
+                auto bucket_start = total;
+                for (auto& count: counts) {
+                    auto chunk_count = count[bucket];
+                    count[bucket] = total;
+                    total += chunk_count;
+                }
+                bucket_ends[bucket] = total;
+                nb_buckets += (total != bucket_start);
+            }
+
+            if (nb_buckets == 1) {
+                // Every element has the same byte, go to the next one
+                next_sorter::sort(pool, first, buffer, size, in_buffer,
+                                  std::move(projection), next_sort);
+                return;
+            }
+
+            // Scatter the chunks in parallel
+            parallel_for(pool, std::ptrdiff_t(0), nb_chunks, [&](std::ptrdiff_t chunk) {
+                auto& offsets = counts[chunk];
+                auto it = source + chunk_begin(chunk);
+                auto last = source + chunk_begin(chunk + 1);
+                for (; it != last ; ++it) {
+                    auto bucket = sequential_sorter::current_byte(proj(*it), nullptr);
+                    using utility::iter_move;
+                    destination[offsets[bucket]++] = iter_move(it);
+                }
+            });
+
+            // Sort the buckets in parallel
+            parallel_for(pool, 0, 256, [&](int bucket) {
+                auto bucket_start = bucket == 0 ? 0 : bucket_ends[bucket - 1];
+                auto bucket_size = bucket_ends[bucket] - bucket_start;
+                if (bucket_size == 0) {
+                    return;
+                }
+                next_sorter::sort(pool, first + bucket_start, buffer + bucket_start,
+                                  bucket_size, not in_buffer, projection, next_sort);
+            });
+        }
+    };
+
+    template<typename CurrentSubKey, std::size_t NumBytes>
+    struct ParallelUnsignedSorter<CurrentSubKey, NumBytes, NumBytes>
+    {
+        template<typename RandomAccessIterator, typename BufferIterator, typename Projection>
+        static auto sort(task_pool&, RandomAccessIterator first, BufferIterator buffer,
+                         std::ptrdiff_t size, bool in_buffer, Projection projection,
+                         void (*next_sort)(RandomAccessIterator, RandomAccessIterator, std::ptrdiff_t, Projection, void*))
+            -> void
+        {
+            // Every byte of the current sub key has been handled,
+            // sort the next sub key sequentially when there is one
+            if (in_buffer) {
+                detail::move(buffer, buffer + size, first);
+            }
+            if (next_sort && not StdSortIfLessThanThreshold<128>(first, first + size, size, projection)) {
+                next_sort(first, first + size, size, std::move(projection), nullptr);
+            }
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Dispatch on the type of the first sub key
+
+    template<typename CurrentSubKey, typename SubKeyType=typename CurrentSubKey::sub_key_type>
+    struct ParallelSortStarter
+    {
+        static constexpr std::size_t num_bytes = 0;
+    };
+
+    template<typename CurrentSubKey>
+    struct ParallelSortStarter<CurrentSubKey, std::uint8_t>
+    {
+        static constexpr std::size_t num_bytes = 1;
+    };
+
+    template<typename CurrentSubKey>
+    struct ParallelSortStarter<CurrentSubKey, std::uint16_t>
+    {
+        static constexpr std::size_t num_bytes = 2;
+    };
+
+    template<typename CurrentSubKey>
+    struct ParallelSortStarter<CurrentSubKey, std::uint32_t>
+    {
+        static constexpr std::size_t num_bytes = 4;
+    };
+
+    template<typename CurrentSubKey>
+    struct ParallelSortStarter<CurrentSubKey, std::uint64_t>
+    {
+        static constexpr std::size_t num_bytes = 8;
+    };
+
+#ifdef __SIZEOF_INT128__
+    template<typename CurrentSubKey>
+    struct ParallelSortStarter<CurrentSubKey, __uint128_t>
+    {
+        static constexpr std::size_t num_bytes = 16;
+    };
+#endif
+
+    template<typename CurrentSubKey, typename RandomAccessIterator, typename Projection>
+    auto parallel_ska_sort_impl(RandomAccessIterator first, RandomAccessIterator last,
+                                Projection projection, std::size_t nb_threads,
+                                std::true_type /* parallelizable */)
+        -> void
+    {
+        using rvalue_type = rvalue_type_t<RandomAccessIterator>;
+        constexpr std::size_t num_bytes = ParallelSortStarter<CurrentSubKey>::num_bytes;
+        auto size = last - first;
+
+        // The parallel passes need a buffer as big as the collection,
+        // fall back to the sequential in-place algorithm otherwise
+        temporary_buffer<rvalue_type> buffer(size);
+        if (buffer.size() < size) {
+            ska_sort(std::move(first), std::move(last), std::move(projection));
+            return;
+        }
+
+        using SortType = void (*)(RandomAccessIterator, RandomAccessIterator, std::ptrdiff_t, Projection, void*);
+        SortType next_sort = static_cast<SortType>(&SortStarter<128, 1024, typename CurrentSubKey::next>::sort);
+        if (next_sort == static_cast<SortType>(&SortStarter<128, 1024, SubKey<void>>::sort)) {
+            next_sort = nullptr;
+        }
+
+        task_pool pool(nb_threads);
+        if (std::is_trivial<rvalue_type>::value) {
+            // Trivial types can be assigned to raw memory, so we can use
+            // the buffer directly as scratch memory
+            ParallelUnsignedSorter<CurrentSubKey, num_bytes>::sort(
+                pool, first, buffer.data(), size, false, std::move(projection), next_sort
+            );
+        } else {
+            // The scatter passes only ever move-assign, so move the
+            // elements to the buffer first to get live objects there
+            destruct_n<rvalue_type> d(0);
+            std::unique_ptr<rvalue_type, destruct_n<rvalue_type>&> h2(buffer.data(), d);
+            uninitialized_move(first, last, buffer.data(), d);
+            ParallelUnsignedSorter<CurrentSubKey, num_bytes>::sort(
+                pool, first, buffer.data(), size, true, std::move(projection), next_sort
+            );
+        }
+    }
+
+    template<typename CurrentSubKey, typename RandomAccessIterator, typename Projection>
+    auto parallel_ska_sort_impl(RandomAccessIterator first, RandomAccessIterator last,
+                                Projection projection, std::size_t,
+                                std::false_type /* parallelizable */)
+        -> void
+    {
+        // Booleans and lists can't be split in bytes
+        ska_sort(std::move(first), std::move(last), std::move(projection));
+    }
+
+    template<typename RandomAccessIterator, typename Projection>
+    auto parallel_ska_sort(RandomAccessIterator first, RandomAccessIterator last,
+                           Projection projection, std::size_t nb_threads)
+        -> void
+    {
+        using CurrentSubKey = SubKey<projected_t<RandomAccessIterator, Projection>>;
+        auto size = last - first;
+
+        // Don't spawn threads that wouldn't have enough work
+        nb_threads = std::min(
+            task_pool::default_nb_threads(nb_threads),
+            static_cast<std::size_t>(size / parallel_ska_sort_grain)
+        );
+        if (nb_threads <= 1) {
+            ska_sort(std::move(first), std::move(last), std::move(projection));
+            return;
+        }
+
+        using parallelizable = std::integral_constant<bool,
+            ParallelSortStarter<CurrentSubKey>::num_bytes != 0
+        >;
+        parallel_ska_sort_impl<CurrentSubKey>(std::move(first), std::move(last),
+                                              std::move(projection), nb_threads,
+                                              parallelizable{});
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARALLEL_SKA_SORT_H_
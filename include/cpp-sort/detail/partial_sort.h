@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_PARTIAL_SORT_H_
+#define CPPSORT_DETAIL_PARTIAL_SORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <iterator>
+#include <utility>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/iter_move.h>
+#include "iterator_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Select the k smallest elements
+    //
+    // Puts the k smallest elements of [first, last) in
+    // [first, first + k) in no particular order, with select
+    // an nth_element-like function. When k is small compared to
+    // the size of the collection, a window of 2k elements is
+    // kept at the beginning of the collection: the elements
+    // smaller than the kth smallest one of the window are added
+    // to it during a single scan of the collection, and when it
+    // is full the k smallest elements of the window are selected
+    // again. Most elements are then rejected with a single
+    // comparison and never moved.
+
+    template<typename ForwardIterator, typename Compare, typename Projection, typename Select>
+    auto select_smallest(ForwardIterator first, ForwardIterator last,
+                         difference_type_t<ForwardIterator> k,
+                         difference_type_t<ForwardIterator> size,
+                         Compare compare, Projection projection, Select select)
+        -> void
+    {
+        using utility::iter_swap;
+
+        if (k <= 0 || k >= size) return;
+        if (k > size / 8) {
+            select(first, last, k - 1, size, std::move(compare), std::move(projection));
+            return;
+        }
+
+        auto&& comp = utility::as_function(compare);
+        auto&& proj = utility::as_function(projection);
+
+        auto window_size = 2 * k;
+        auto window_end = std::next(first, window_size);
+        auto kth = select(first, window_end, k - 1, window_size, compare, projection);
+
+        auto fill = std::next(kth);
+        auto fill_size = k;
+        for (auto it = window_end ; it != last ; ++it) {
+            if (comp(proj(*it), proj(*kth))) {
+                iter_swap(it, fill);
+                ++fill;
+                if (++fill_size == window_size) {
+                    kth = select(first, window_end, k - 1, window_size, compare, projection);
+                    fill = std::next(kth);
+                    fill_size = k;
+                }
+            }
+        }
+
+        if (fill_size > k) {
+            select(first, fill, k - 1, fill_size, std::move(compare), std::move(projection));
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Partial sort: select the k smallest elements, then sort
+    // them with the given sorter
+
+    template<
+        typename ForwardIterator,
+        typename Compare,
+        typename Projection,
+        typename Select,
+        typename Sorter
+    >
+    auto partial_sort(ForwardIterator first, ForwardIterator middle, ForwardIterator last,
+                      difference_type_t<ForwardIterator> k,
+                      difference_type_t<ForwardIterator> size,
+                      Compare compare, Projection projection,
+                      Select select, Sorter&& sorter)
+        -> void
+    {
+        if (k <= 0) return;
+        select_smallest(first, last, k, size, compare, projection, std::move(select));
+        std::forward<Sorter>(sorter)(first, middle, std::move(compare), std::move(projection));
+    }
+}}
+
+#endif // CPPSORT_DETAIL_PARTIAL_SORT_H_
@@ -17,6 +17,7 @@
 #include "bitops.h"
 #include "insertion_sort.h"
 #include "iterator_traits.h"
+#include "memory.h"
 
 namespace cppsort
 {
@@ -74,7 +75,7 @@ namespace detail
     }
 
     template<typename RandomAccessIterator, typename Compare, typename Projection>
-    auto relocate(const std::vector<poplar<RandomAccessIterator>>& poplars,
+    auto relocate(const std::vector<poplar<RandomAccessIterator>, resource_allocator<poplar<RandomAccessIterator>>>& poplars,
                   Compare compare, Projection projection)
         -> void
     {
@@ -132,7 +133,7 @@ namespace detail
         poplar_size_t size = last - first;
         if (size < 2) return;
 
-        std::vector<poplar<RandomAccessIterator>> poplars;
+        std::vector<poplar<RandomAccessIterator>, resource_allocator<poplar<RandomAccessIterator>>> poplars;
         // Harvey & Zatloukal, The Post-Order Heap:
         // [...] the number of trees, k, is at most floor(lg(n + 1)) + 1
         poplars.reserve(log2(size + 1) + 1);
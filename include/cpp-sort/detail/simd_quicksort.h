@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SIMD_QUICKSORT_H_
+#define CPPSORT_DETAIL_SIMD_QUICKSORT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/functional.h>
+#include "bitops.h"
+#include "config.h"
+#include "heapsort.h"
+#include "insertion_sort.h"
+#include "iter_sort3.h"
+#include "iterator_traits.h"
+#include "pdqsort.h"
+#include "sorting_network/simd.h"
+#include "type_traits.h"
+
+#if CPPSORT_SIMD_DISPATCH_AVAILABLE
+#   include <immintrin.h>
+#   define CPPSORT_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#   define CPPSORT_TARGET_AVX512 __attribute__((target("avx512f,popcnt")))
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Whether the vectorized quicksort can be used
+
+    template<typename T>
+    struct is_simd_quicksort_value:
+        std::integral_constant<bool,
+            (std::is_integral<T>::value && std::is_signed<T>::value &&
+             (sizeof(T) == 4 || sizeof(T) == 8)) ||
+            std::is_same<T, float>::value ||
+            std::is_same<T, double>::value
+        >
+    {};
+
+    template<typename Iterator, typename Compare, typename Projection,
+             typename T = value_type_t<Iterator>>
+    struct is_simd_quicksortable:
+        conjunction<
+            is_simd_quicksort_value<T>,
+            disjunction<
+                std::is_same<Iterator, T*>,
+                std::is_same<Iterator, typename std::vector<T>::iterator>
+            >,
+            is_simd_comparison<Compare, T>,
+            is_simd_projection<Projection>
+        >
+    {};
+
+    // Partitions below that size are sorted with an insertion
+    // sort, it has to be at least twice the number of lanes of
+    // the biggest vectors
+    constexpr std::ptrdiff_t simd_quicksort_insertion_threshold = 32;
+    constexpr std::ptrdiff_t simd_quicksort_ninther_threshold = 128;
+
+    // Partitions the elements that the vectorized loop couldn't
+    // handle: the ones put aside in the buffer and the ones left
+    // between left and right, the free space between l_store and
+    // r_store is exactly big enough for all of them
+    template<bool Inclusive, typename T>
+    auto simd_partition_remaining(T* l_store, T* r_store, T* left, T* right,
+                                  T* buffer, std::ptrdiff_t buffer_size, T pivot)
+        -> T*
+    {
+        auto buffer_end = std::copy(left, right, buffer + buffer_size);
+        for (auto it = buffer ; it != buffer_end ; ++it) {
+            // Write the element on both sides and only move the
+            // right store pointer, which avoids branches
+            T value = *it;
+            bool goes_left = Inclusive ? not (pivot < value) : value < pivot;
+            *l_store = value;
+            r_store[-1] = value;
+            l_store += goes_left;
+            r_store -= not goes_left;
+        }
+        return l_store;
+    }
+
+#if CPPSORT_SIMD_DISPATCH_AVAILABLE
+    ////////////////////////////////////////////////////////////
+    // AVX2 partitioning
+    //
+    // AVX2 has no compress instruction, so the lanes of a vector
+    // are permuted to put the elements that belong to the left
+    // partition first and the other ones after them, then the
+    // whole vector is stored on both sides of the partition.
+
+    template<typename T, typename=void>
+    struct avx2_lanes;
+
+    template<typename T>
+    struct avx2_lanes<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 4>>
+    {
+        static constexpr std::ptrdiff_t size = 8;
+
+        CPPSORT_TARGET_AVX2
+        static auto set1(T value) -> __m256i { return _mm256_set1_epi32(value); }
+
+        // Bit i of the mask is set when x[i] < y[i]
+        CPPSORT_TARGET_AVX2
+        static auto less_mask(__m256i x, __m256i y)
+            -> unsigned
+        {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(y, x))));
+        }
+    };
+
+    template<typename T>
+    struct avx2_lanes<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 8>>
+    {
+        static constexpr std::ptrdiff_t size = 4;
+
+        CPPSORT_TARGET_AVX2
+        static auto set1(T value) -> __m256i { return _mm256_set1_epi64x(value); }
+
+        CPPSORT_TARGET_AVX2
+        static auto less_mask(__m256i x, __m256i y)
+            -> unsigned
+        {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(y, x))));
+        }
+    };
+
+    template<>
+    struct avx2_lanes<float>
+    {
+        static constexpr std::ptrdiff_t size = 8;
+
+        CPPSORT_TARGET_AVX2
+        static auto set1(float value) -> __m256i { return _mm256_castps_si256(_mm256_set1_ps(value)); }
+
+        CPPSORT_TARGET_AVX2
+        static auto less_mask(__m256i x, __m256i y)
+            -> unsigned
+        {
+            auto res = _mm256_cmp_ps(_mm256_castsi256_ps(x), _mm256_castsi256_ps(y), _CMP_LT_OQ);
+            return static_cast<unsigned>(_mm256_movemask_ps(res));
+        }
+    };
+
+    template<>
+    struct avx2_lanes<double>
+    {
+        static constexpr std::ptrdiff_t size = 4;
+
+        CPPSORT_TARGET_AVX2
+        static auto set1(double value) -> __m256i { return _mm256_castpd_si256(_mm256_set1_pd(value)); }
+
+        CPPSORT_TARGET_AVX2
+        static auto less_mask(__m256i x, __m256i y)
+            -> unsigned
+        {
+            auto res = _mm256_cmp_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(y), _CMP_LT_OQ);
+            return static_cast<unsigned>(_mm256_movemask_pd(res));
+        }
+    };
+
+    // Every entry packs the eight 4-bit indices of the 32-bit lanes
+    // to pass to _mm256_permutevar8x32_epi32 for a given mask: the
+    // lanes whose bit is set in the mask come first
+    struct avx2_permutation_table
+    {
+        std::uint32_t indices[256];
+    };
+
+    template<int NbLanes>
+    constexpr auto make_avx2_permutation_table()
+        -> avx2_permutation_table
+    {
+        constexpr int width = 8 / NbLanes;
+        avx2_permutation_table res{};
+        for (unsigned mask = 0 ; mask < (1u << NbLanes) ; ++mask) {
+            std::uint32_t packed = 0;
+            int position = 0;
+            for (unsigned selected = 2 ; selected-- > 0 ;) {
+                for (int lane = 0 ; lane < NbLanes ; ++lane) {
+                    if (((mask >> lane) & 1u) != selected) continue;
+                    for (int i = 0 ; i < width ; ++i) {
+                        packed |= static_cast<std::uint32_t>(lane * width + i) << (4 * position);
+                        ++position;
+                    }
+                }
+            }
+            res.indices[mask] = packed;
+        }
+        return res;
+    }
+
+    // Partitions [first, last) so that the elements lesser than
+    // the pivot (or not greater than the pivot when Inclusive is
+    // true) come first, returns the partition point
+    template<bool Inclusive, typename T>
+    CPPSORT_TARGET_AVX2
+    auto avx2_partition(T* first, T* last, T pivot)
+        -> T*
+    {
+        using lanes = avx2_lanes<T>;
+        constexpr std::ptrdiff_t size = lanes::size;
+        constexpr unsigned full_mask = (1u << size) - 1;
+        static constexpr auto table = make_avx2_permutation_table<size>();
+
+        auto pivot_vec = lanes::set1(pivot);
+        auto shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+
+        // Put the first and last vectors aside, which ensures that
+        // there is always room for a whole vector on both sides
+        T buffer[3 * size];
+        std::copy(first, first + size, buffer);
+        std::copy(last - size, last, buffer + size);
+
+        T* left = first + size;
+        T* right = last - size;
+        T* l_store = first;
+        T* r_store = last;
+        while (right - left >= size) {
+            // Read from the side with the least free space
+            __m256i x;
+            if (left - l_store <= r_store - right) {
+                x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left));
+                left += size;
+            } else {
+                right -= size;
+                x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right));
+            }
+
+            unsigned mask = Inclusive ? ~lanes::less_mask(pivot_vec, x) & full_mask
+                                      : lanes::less_mask(x, pivot_vec);
+            auto indices = _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(table.indices[mask])), shifts);
+            x = _mm256_permutevar8x32_epi32(x, indices);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(l_store), x);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r_store - size), x);
+
+            auto nb_left = __builtin_popcount(mask);
+            l_store += nb_left;
+            r_store -= size - nb_left;
+        }
+        return simd_partition_remaining<Inclusive>(l_store, r_store, left, right,
+                                                   buffer, 2 * size, pivot);
+    }
+
+    struct avx2_kernel
+    {
+        template<bool Inclusive, typename T>
+        static auto partition(T* first, T* last, T pivot)
+            -> T*
+        {
+            return avx2_partition<Inclusive>(first, last, pivot);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // AVX-512 partitioning
+    //
+    // Same algorithm as above, except that the elements of every
+    // side of the partition are directly written with compress
+    // stores.
+
+    template<typename T, typename=void>
+    struct avx512_lanes;
+
+    template<typename T>
+    struct avx512_lanes<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 4>>
+    {
+        static constexpr std::ptrdiff_t size = 16;
+
+        CPPSORT_TARGET_AVX512
+        static auto set1(T value) -> __m512i { return _mm512_set1_epi32(value); }
+
+        CPPSORT_TARGET_AVX512
+        static auto less_mask(__m512i x, __m512i y)
+            -> unsigned
+        {
+            return _mm512_cmplt_epi32_mask(x, y);
+        }
+
+        CPPSORT_TARGET_AVX512
+        static auto compress_store(T* ptr, unsigned mask, __m512i x)
+            -> void
+        {
+            _mm512_mask_compressstoreu_epi32(ptr, static_cast<__mmask16>(mask), x);
+        }
+    };
+
+    template<typename T>
+    struct avx512_lanes<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 8>>
+    {
+        static constexpr std::ptrdiff_t size = 8;
+
+        CPPSORT_TARGET_AVX512
+        static auto set1(T value) -> __m512i { return _mm512_set1_epi64(value); }
+
+        CPPSORT_TARGET_AVX512
+        static auto less_mask(__m512i x, __m512i y)
+            -> unsigned
+        {
+            return _mm512_cmplt_epi64_mask(x, y);
+        }
+
+        CPPSORT_TARGET_AVX512
+        static auto compress_store(T* ptr, unsigned mask, __m512i x)
+            -> void
+        {
+            _mm512_mask_compressstoreu_epi64(ptr, static_cast<__mmask8>(mask), x);
+        }
+    };
+
+    template<>
+    struct avx512_lanes<float>
+    {
+        static constexpr std::ptrdiff_t size = 16;
+
+        CPPSORT_TARGET_AVX512
+        static auto set1(float value) -> __m512i { return _mm512_castps_si512(_mm512_set1_ps(value)); }
+
+        CPPSORT_TARGET_AVX512
+        static auto less_mask(__m512i x, __m512i y)
+            -> unsigned
+        {
+            return _mm512_cmp_ps_mask(_mm512_castsi512_ps(x), _mm512_castsi512_ps(y), _CMP_LT_OQ);
+        }
+
+        CPPSORT_TARGET_AVX512
+        static auto compress_store(float* ptr, unsigned mask, __m512i x)
+            -> void
+        {
+            _mm512_mask_compressstoreu_epi32(ptr, static_cast<__mmask16>(mask), x);
+        }
+    };
+
+    template<>
+    struct avx512_lanes<double>
+    {
+        static constexpr std::ptrdiff_t size = 8;
+
+        CPPSORT_TARGET_AVX512
+        static auto set1(double value) -> __m512i { return _mm512_castpd_si512(_mm512_set1_pd(value)); }
+
+        CPPSORT_TARGET_AVX512
+        static auto less_mask(__m512i x, __m512i y)
+            -> unsigned
+        {
+            return _mm512_cmp_pd_mask(_mm512_castsi512_pd(x), _mm512_castsi512_pd(y), _CMP_LT_OQ);
+        }
+
+        CPPSORT_TARGET_AVX512
+        static auto compress_store(double* ptr, unsigned mask, __m512i x)
+            -> void
+        {
+            _mm512_mask_compressstoreu_epi64(ptr, static_cast<__mmask8>(mask), x);
+        }
+    };
+
+    template<bool Inclusive, typename T>
+    CPPSORT_TARGET_AVX512
+    auto avx512_partition(T* first, T* last, T pivot)
+        -> T*
+    {
+        using lanes = avx512_lanes<T>;
+        constexpr std::ptrdiff_t size = lanes::size;
+        constexpr unsigned full_mask = (1u << size) - 1;
+
+        auto pivot_vec = lanes::set1(pivot);
+
+        T buffer[3 * size];
+        std::copy(first, first + size, buffer);
+        std::copy(last - size, last, buffer + size);
+
+        T* left = first + size;
+        T* right = last - size;
+        T* l_store = first;
+        T* r_store = last;
+        while (right - left >= size) {
+            __m512i x;
+            if (left - l_store <= r_store - right) {
+                x = _mm512_loadu_si512(left);
+                left += size;
+            } else {
+                right -= size;
+                x = _mm512_loadu_si512(right);
+            }
+
+            unsigned mask = Inclusive ? ~lanes::less_mask(pivot_vec, x) & full_mask
+                                      : lanes::less_mask(x, pivot_vec);
+            auto nb_left = __builtin_popcount(mask);
+            lanes::compress_store(l_store, mask, x);
+            l_store += nb_left;
+            r_store -= size - nb_left;
+            lanes::compress_store(r_store, ~mask & full_mask, x);
+        }
+        return simd_partition_remaining<Inclusive>(l_store, r_store, left, right,
+                                                   buffer, 2 * size, pivot);
+    }
+
+    struct avx512_kernel
+    {
+        template<bool Inclusive, typename T>
+        static auto partition(T* first, T* last, T pivot)
+            -> T*
+        {
+            return avx512_partition<Inclusive>(first, last, pivot);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Runtime dispatch
+
+    enum struct simd_level
+    {
+        none,
+        avx2,
+        avx512
+    };
+
+    // Detected once, the first time a vectorized sort runs
+    struct simd_level_detector
+    {
+        static auto get()
+            -> simd_level
+        {
+            static const simd_level level = [] {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f")) {
+                    return simd_level::avx512;
+                }
+                if (__builtin_cpu_supports("avx2")) {
+                    return simd_level::avx2;
+                }
+                return simd_level::none;
+            }();
+            return level;
+        }
+    };
+#endif
+
+    ////////////////////////////////////////////////////////////
+    // Quicksort loop shared by every instruction set
+
+    template<typename Kernel, typename T>
+    auto simd_quicksort_loop(T* first, T* last, int bad_allowed)
+        -> void
+    {
+        // Use a while loop for tail recursion elimination
+        while (true) {
+            auto size = last - first;
+            if (size < simd_quicksort_insertion_threshold) {
+                insertion_sort(first, last, std::less<>{}, utility::identity{});
+                return;
+            }
+
+            // Choose pivot as median of 3 or pseudomedian of 9
+            auto s2 = size / 2;
+            if (size > simd_quicksort_ninther_threshold) {
+                iter_sort3(first, first + s2, last - 1, std::less<>{}, utility::identity{});
+                iter_sort3(first + 1, first + (s2 - 1), last - 2, std::less<>{}, utility::identity{});
+                iter_sort3(first + 2, first + (s2 + 1), last - 3, std::less<>{}, utility::identity{});
+                iter_sort3(first + (s2 - 1), first + s2, first + (s2 + 1), std::less<>{}, utility::identity{});
+                std::swap(*first, first[s2]);
+            } else {
+                iter_sort3(first + s2, first, last - 1, std::less<>{}, utility::identity{});
+            }
+            T pivot = *first;
+
+            T* middle = Kernel::template partition<false>(first, last, pivot);
+            if (middle == first) {
+                // No element is lesser than the pivot: put the elements
+                // equal to the pivot first, they are already sorted
+                first = Kernel::template partition<true>(first, last, pivot);
+                continue;
+            }
+
+            // Switch to heapsort after too many unbalanced partitions
+            auto l_size = middle - first;
+            auto r_size = last - middle;
+            if (l_size < size / 8 || r_size < size / 8) {
+                if (--bad_allowed == 0) {
+                    heapsort(first, last, std::less<>{}, utility::identity{});
+                    return;
+                }
+            }
+
+            // Recurse into the smallest partition
+            if (l_size < r_size) {
+                simd_quicksort_loop<Kernel>(first, middle, bad_allowed);
+                first = middle;
+            } else {
+                simd_quicksort_loop<Kernel>(middle, last, bad_allowed);
+                last = middle;
+            }
+        }
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto simd_quicksort(RandomAccessIterator first, RandomAccessIterator last,
+                        Compare compare, Projection projection, std::true_type)
+        -> void
+    {
+        auto size = last - first;
+        if (size < 2) return;
+
+#if CPPSORT_SIMD_DISPATCH_AVAILABLE
+        auto ptr = std::addressof(*first);
+        int bad_allowed = detail::log2(static_cast<std::size_t>(size));
+        switch (simd_level_detector::get()) {
+            case simd_level::avx512:
+                simd_quicksort_loop<avx512_kernel>(ptr, ptr + size, bad_allowed);
+                return;
+            case simd_level::avx2:
+                simd_quicksort_loop<avx2_kernel>(ptr, ptr + size, bad_allowed);
+                return;
+            case simd_level::none:
+                break;
+        }
+#endif
+        pdqsort(std::move(first), std::move(last),
+                std::move(compare), std::move(projection));
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto simd_quicksort(RandomAccessIterator first, RandomAccessIterator last,
+                        Compare compare, Projection projection, std::false_type)
+        -> void
+    {
+        pdqsort(std::move(first), std::move(last),
+                std::move(compare), std::move(projection));
+    }
+
+    template<typename RandomAccessIterator, typename Compare, typename Projection>
+    auto simd_quicksort(RandomAccessIterator first, RandomAccessIterator last,
+                        Compare compare, Projection projection)
+        -> void
+    {
+        using simd_sortable = is_simd_quicksortable<RandomAccessIterator, Compare, Projection>;
+        simd_quicksort(std::move(first), std::move(last),
+                       std::move(compare), std::move(projection),
+                       simd_sortable{});
+    }
+}}
+
+#if CPPSORT_SIMD_DISPATCH_AVAILABLE
+#   undef CPPSORT_TARGET_AVX2
+#   undef CPPSORT_TARGET_AVX512
+#endif
+
+#endif // CPPSORT_DETAIL_SIMD_QUICKSORT_H_
@@ -13,6 +13,7 @@
 #include <utility>
 #include <vector>
 #include <cpp-sort/adapters/stable_adapter.h>
+#include <cpp-sort/utility/iter_move.h>
 #include "bitops.h"
 #include "fixed_size_list.h"
 #include "functional.h"
@@ -100,6 +101,7 @@ namespace detail
                             Compare compare, Projection projection)
         -> void
     {
+        using utility::iter_swap;
         auto&& comp = utility::as_function(compare);
         auto&& proj = utility::as_function(projection);
 
@@ -123,6 +125,19 @@ namespace detail
 
         // Put the pivot back in its final position
         iter_swap(middle1, last_1);
+
+        // The caller splits the collection in two halves of the same size,
+        // but when the pivot has equivalent elements it ends up before the
+        // middle, and elements bigger than the pivot could remain in the
+        // left half: move the elements equivalent to the pivot right after
+        // it so that they span the middle of the collection
+        if (middle1 < first + (last - first) / 2) {
+            auto&& pivot2 = proj(*middle1);
+            detail::stable_partition(
+                std::next(middle1), last,
+                [&](auto&& elem) { return not comp(pivot2, proj(elem)); }
+            );
+        }
     }
 
     template<typename RandomAccessIterator, typename Compare, typename Projection>
@@ -143,7 +158,7 @@ namespace detail
         }
 
         // Encroaching lists
-        std::vector<fixed_size_list<node_type>> lists;
+        std::vector<fixed_size_list<node_type>, resource_allocator<fixed_size_list<node_type>>> lists;
         lists.emplace_back(node_pool, destroy_node_contents<RandomAccessIterator, node_type, &node_type::it>);
         lists.back().push_back([&first](node_type* node) {
             ::new (&node->it) RandomAccessIterator(first);
@@ -283,7 +298,7 @@ namespace detail
 
         // Allocate a buffer that will be used for median finding
         std::unique_ptr<RandomAccessIterator, operator_deleter> iterators_buffer(
-            static_cast<RandomAccessIterator*>(::operator new(size * sizeof(RandomAccessIterator))),
+            static_cast<RandomAccessIterator*>(allocate_bytes(size * sizeof(RandomAccessIterator))),
             operator_deleter(size * sizeof(RandomAccessIterator))
         );
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SMALL_ARRAY_BATCH_H_
+#define CPPSORT_DETAIL_SMALL_ARRAY_BATCH_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Sort every small array of a collection
+    //
+    // By default every array is sorted on its own with the
+    // fixed-size sorter, fixed-size sorters which can do better
+    // when they are given several arrays at once specialize
+    // this class template.
+
+    template<template<std::size_t> class FixedSizeSorter>
+    struct small_array_batch_sorter
+    {
+        template<std::size_t N, typename RandomAccessIterator, typename... Args>
+        static auto sort(RandomAccessIterator first, RandomAccessIterator last, Args&&... args)
+            -> void
+        {
+            for (; first != last ; ++first) {
+                FixedSizeSorter<N>{}(*first, args...);
+            }
+        }
+    };
+}}
+
+#endif // CPPSORT_DETAIL_SMALL_ARRAY_BATCH_H_
@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SORTING_NETWORK_BATCH_H_
+#define CPPSORT_DETAIL_SORTING_NETWORK_BATCH_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/fwd.h>
+#include <cpp-sort/utility/functional.h>
+#include "../attributes.h"
+#include "../config.h"
+#include "../functional.h"
+#include "../iterator_traits.h"
+#include "../small_array_batch.h"
+#include "../swap_if_n.h"
+#include "../type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Lanes of a sorting network
+    //
+    // When several arrays are sorted at once, the network runs
+    // on packs holding the element at the same position in every
+    // array, and every compare-exchange becomes a swap_if_n over
+    // the lanes of two packs. simd_lane_compare carries the
+    // comparison: its operator() is only declared so that the
+    // networks accept the packs, the compare-exchanges all go
+    // through the swap_if overload below.
+
+    template<typename T>
+    struct simd_lane_pack
+    {
+        T values[swap_if_lanes<T>::size];
+    };
+
+    template<typename Compare>
+    struct simd_lane_compare
+    {
+        template<typename T>
+        auto operator()(const simd_lane_pack<T>& lhs, const simd_lane_pack<T>& rhs) const
+            -> bool;
+    };
+
+    template<typename T, typename Compare, typename Projection>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto swap_if(simd_lane_pack<T>& lhs, simd_lane_pack<T>& rhs,
+                 simd_lane_compare<Compare>, Projection)
+        -> void
+    {
+        swap_if_n(lhs.values, rhs.values, swap_if_lanes<T>::size,
+                  Compare{}, utility::identity{});
+    }
+
+#if CPPSORT_SSE2_AVAILABLE
+    ////////////////////////////////////////////////////////////
+    // Transposition of blocks of elements
+    //
+    // Square blocks of 128 bits rows are transposed in registers:
+    // transposing 4x4 blocks of 32-bit elements or 2x2 blocks of
+    // 64-bit elements only moves bits around, so the same code
+    // works for integers and for floating point types. Wider packs
+    // are assembled from several transposed blocks.
+
+    template<std::size_t ElementSize>
+    struct simd_block_transposer;
+
+    template<>
+    struct simd_block_transposer<4>
+    {
+        static constexpr std::size_t size = 4;
+
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto transpose(__m128i* x)
+            -> void
+        {
+            auto ab_lo = _mm_unpacklo_epi32(x[0], x[1]);
+            auto cd_lo = _mm_unpacklo_epi32(x[2], x[3]);
+            auto ab_hi = _mm_unpackhi_epi32(x[0], x[1]);
+            auto cd_hi = _mm_unpackhi_epi32(x[2], x[3]);
+            x[0] = _mm_unpacklo_epi64(ab_lo, cd_lo);
+            x[1] = _mm_unpackhi_epi64(ab_lo, cd_lo);
+            x[2] = _mm_unpacklo_epi64(ab_hi, cd_hi);
+            x[3] = _mm_unpackhi_epi64(ab_hi, cd_hi);
+        }
+
+        template<std::size_t Col, typename Arrays>
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto load(Arrays arrays, __m128i* x)
+            -> void
+        {
+            x[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays[0].data() + Col));
+            x[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays[1].data() + Col));
+            x[2] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays[2].data() + Col));
+            x[3] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays[3].data() + Col));
+            transpose(x);
+        }
+
+        template<std::size_t Col, typename Arrays>
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto store(Arrays arrays, __m128i* x)
+            -> void
+        {
+            transpose(x);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(arrays[0].data() + Col), x[0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(arrays[1].data() + Col), x[1]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(arrays[2].data() + Col), x[2]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(arrays[3].data() + Col), x[3]);
+        }
+    };
+
+    template<>
+    struct simd_block_transposer<8>
+    {
+        static constexpr std::size_t size = 2;
+
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto transpose(__m128i* x)
+            -> void
+        {
+            auto lo = _mm_unpacklo_epi64(x[0], x[1]);
+            x[1] = _mm_unpackhi_epi64(x[0], x[1]);
+            x[0] = lo;
+        }
+
+        template<std::size_t Col, typename Arrays>
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto load(Arrays arrays, __m128i* x)
+            -> void
+        {
+            x[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays[0].data() + Col));
+            x[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays[1].data() + Col));
+            transpose(x);
+        }
+
+        template<std::size_t Col, typename Arrays>
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto store(Arrays arrays, __m128i* x)
+            -> void
+        {
+            transpose(x);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(arrays[0].data() + Col), x[0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(arrays[1].data() + Col), x[1]);
+        }
+    };
+
+    // Conversions between packs and their 128-bit halves, the
+    // second half being found Stride vectors after the first one
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_join_halves(const __m128i* x, __m128i& res) -> void { res = x[0]; }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_join_halves(const __m128i* x, __m128& res) -> void { res = _mm_castsi128_ps(x[0]); }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_join_halves(const __m128i* x, __m128d& res) -> void { res = _mm_castsi128_pd(x[0]); }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_split_halves(__m128i v, __m128i* x) -> void { x[0] = v; }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_split_halves(__m128 v, __m128i* x) -> void { x[0] = _mm_castps_si128(v); }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_split_halves(__m128d v, __m128i* x) -> void { x[0] = _mm_castpd_si128(v); }
+
+#if CPPSORT_AVX_AVAILABLE
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_join_halves(const __m128i* x, __m256i& res)
+        -> void
+    {
+        res = _mm256_insertf128_si256(_mm256_castsi128_si256(x[0]), x[Stride], 1);
+    }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_join_halves(const __m128i* x, __m256& res)
+        -> void
+    {
+        __m256i tmp;
+        simd_join_halves<Stride>(x, tmp);
+        res = _mm256_castsi256_ps(tmp);
+    }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_join_halves(const __m128i* x, __m256d& res)
+        -> void
+    {
+        __m256i tmp;
+        simd_join_halves<Stride>(x, tmp);
+        res = _mm256_castsi256_pd(tmp);
+    }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_split_halves(__m256i v, __m128i* x)
+        -> void
+    {
+        x[0] = _mm256_castsi256_si128(v);
+        x[Stride] = _mm256_extractf128_si256(v, 1);
+    }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_split_halves(__m256 v, __m128i* x)
+        -> void
+    {
+        simd_split_halves<Stride>(_mm256_castps_si256(v), x);
+    }
+
+    template<std::size_t Stride>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_split_halves(__m256d v, __m128i* x)
+        -> void
+    {
+        simd_split_halves<Stride>(_mm256_castpd_si256(v), x);
+    }
+#endif
+
+    template<std::size_t Stride, typename T>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_join_halves(const __m128i* x, simd_lane_pack<T>& pack)
+        -> void
+    {
+        typename swap_if_lanes<T>::type res;
+        simd_join_halves<Stride>(x, res);
+        swap_if_lanes<T>::store(pack.values, res);
+    }
+
+    template<std::size_t Stride, typename T>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_split_halves(const simd_lane_pack<T>& pack, __m128i* x)
+        -> void
+    {
+        simd_split_halves<Stride>(swap_if_lanes<T>::load(pack.values), x);
+    }
+
+    // Loads the packs from the arrays of a block, or stores them
+    // back into the arrays of the block; every step handles a
+    // square block of columns, or a single column when there are
+    // not enough columns left to fill a block. Everything is
+    // instantiated with the column indices so that the compiler
+    // can keep the packs in registers
+
+    template<bool Load, std::size_t Col, typename Arrays, typename T, std::size_t... Indices>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto transpose_block_step(Arrays arrays, simd_lane_pack<T>* packs,
+                              std::index_sequence<Indices...>)
+        -> void
+    {
+        using transposer = simd_block_transposer<sizeof(T)>;
+        constexpr std::size_t block_size = transposer::size;
+        constexpr std::size_t nb_halves = swap_if_lanes<T>::size / block_size;
+
+        // x[half * block_size + i] holds the half of the pack
+        // for the column Col + i
+        __m128i x[nb_halves * block_size];
+        if (Load) {
+            transposer::template load<Col>(arrays, x);
+            if (nb_halves > 1) {
+                transposer::template load<Col>(arrays + block_size, x + block_size);
+            }
+            (void) std::initializer_list<int>{
+                (simd_join_halves<block_size>(x + Indices, packs[Col + Indices]), 0)...
+            };
+        } else {
+            (void) std::initializer_list<int>{
+                (simd_split_halves<block_size>(packs[Col + Indices], x + Indices), 0)...
+            };
+            transposer::template store<Col>(arrays, x);
+            if (nb_halves > 1) {
+                transposer::template store<Col>(arrays + block_size, x + block_size);
+            }
+        }
+    }
+
+    template<bool Load, std::size_t Col, typename Arrays, typename T>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto transpose_column_step(Arrays arrays, simd_lane_pack<T>* packs)
+        -> void
+    {
+        using lanes = swap_if_lanes<T>;
+
+        for (std::size_t row = 0 ; row < lanes::size ; ++row) {
+            if (Load) {
+                packs[Col].values[row] = arrays[row][Col];
+            } else {
+                arrays[row][Col] = packs[Col].values[row];
+            }
+        }
+    }
+
+    template<
+        bool Load,
+        std::size_t BlockSize,
+        std::size_t FirstColumn,
+        typename Arrays,
+        typename T,
+        std::size_t... Blocks,
+        std::size_t... Columns
+    >
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto transpose_arrays(Arrays arrays, simd_lane_pack<T>* packs,
+                          std::index_sequence<Blocks...>, std::index_sequence<Columns...>)
+        -> void
+    {
+        (void) std::initializer_list<int>{
+            (transpose_block_step<Load, Blocks * BlockSize>(
+                arrays, packs, std::make_index_sequence<BlockSize>{}
+            ), 0)...
+        };
+        (void) std::initializer_list<int>{
+            (transpose_column_step<Load, FirstColumn + Columns>(arrays, packs), 0)...
+        };
+    }
+
+    template<std::size_t N, bool Load, typename Arrays, typename T>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto transpose_arrays(Arrays arrays, simd_lane_pack<T>* packs)
+        -> void
+    {
+        constexpr std::size_t block_size = simd_block_transposer<sizeof(T)>::size;
+        transpose_arrays<Load, block_size, N - N % block_size>(
+            arrays, packs,
+            std::make_index_sequence<N / block_size>{},
+            std::make_index_sequence<N % block_size>{}
+        );
+    }
+#endif
+
+    ////////////////////////////////////////////////////////////
+    // Sort several arrays at once
+    //
+    // Blocks of arrays are transposed so that every pack holds
+    // one element of each array of the block, then the network
+    // runs once for the whole block and the packs are transposed
+    // back into the arrays. Arrays left when there are not enough
+    // of them to fill a block are copied to a block padded with
+    // copies of the last one: that way every array goes through
+    // the same network, which matters for NaN and signed zeros.
+
+    template<
+        std::size_t N,
+        typename T,
+        typename Compare = std::less<>,
+        typename Projection = utility::identity
+    >
+    struct is_batch_network_sortable:
+        conjunction<
+            std::integral_constant<bool, (N > 1)>,
+            std::integral_constant<bool, (swap_if_lanes<T>::size > 1)>,
+            std::integral_constant<bool, comparison_direction<Compare, T>::value != 0>,
+            is_swap_if_n_projection<Projection>
+        >
+    {};
+
+    template<typename Compare = std::less<>, typename... Args>
+    struct batch_network_compare
+    {
+        using type = Compare;
+    };
+
+#if CPPSORT_SSE2_AVAILABLE
+    template<std::size_t N, typename RandomAccessIterator, typename... Args>
+    auto batch_sort_network(std::true_type, RandomAccessIterator first, RandomAccessIterator last,
+                            const Args&...)
+        -> void
+    {
+        using array_type = value_type_t<RandomAccessIterator>;
+        using value_type = typename array_type::value_type;
+        using compare_type = typename batch_network_compare<Args...>::type;
+        using lanes = swap_if_lanes<value_type>;
+        using pack_compare = simd_lane_compare<compare_type>;
+        constexpr std::size_t width = lanes::size;
+
+        simd_lane_pack<value_type> packs[N];
+        while (static_cast<std::size_t>(last - first) >= width) {
+            transpose_arrays<N, true>(first, packs);
+            sorting_network_sorter_impl<N>{}(packs, packs + N, pack_compare{}, utility::identity{});
+            transpose_arrays<N, false>(first, packs);
+            first += width;
+        }
+
+        auto nb_left = static_cast<std::size_t>(last - first);
+        if (nb_left != 0) {
+            array_type block[width];
+            for (std::size_t idx = 0 ; idx < width ; ++idx) {
+                block[idx] = first[static_cast<difference_type_t<RandomAccessIterator>>(
+                    (std::min)(idx, nb_left - 1)
+                )];
+            }
+            transpose_arrays<N, true>(block, packs);
+            sorting_network_sorter_impl<N>{}(packs, packs + N, pack_compare{}, utility::identity{});
+            transpose_arrays<N, false>(block, packs);
+            std::copy(block, block + nb_left, first);
+        }
+    }
+#endif
+
+    template<std::size_t N, typename RandomAccessIterator, typename... Args>
+    auto batch_sort_network(std::false_type, RandomAccessIterator first, RandomAccessIterator last,
+                            const Args&... args)
+        -> void
+    {
+        for (; first != last ; ++first) {
+            sorting_network_sorter<N>{}(*first, args...);
+        }
+    }
+
+    template<>
+    struct small_array_batch_sorter<sorting_network_sorter>
+    {
+        template<std::size_t N, typename RandomAccessIterator, typename... Args>
+        static auto sort(RandomAccessIterator first, RandomAccessIterator last, Args&&... args)
+            -> void
+        {
+            using value_type = typename value_type_t<RandomAccessIterator>::value_type;
+            batch_sort_network<N>(is_batch_network_sortable<N, value_type, std::decay_t<Args>...>{},
+                                  std::move(first), std::move(last), args...);
+        }
+    };
+}}
+
+#endif // CPPSORT_DETAIL_SORTING_NETWORK_BATCH_H_
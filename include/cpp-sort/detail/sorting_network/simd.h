@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SORTING_NETWORK_SIMD_H_
+#define CPPSORT_DETAIL_SORTING_NETWORK_SIMD_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/functional.h>
+#include "../attributes.h"
+#include "../config.h"
+#include "../iterator_traits.h"
+#include "../type_traits.h"
+
+#if CPPSORT_SSE41_AVAILABLE
+#   include <smmintrin.h>
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Vectors of four elements
+    //
+    // Every vector type provides the operations needed to run a
+    // bitonic sorting network on four lanes at once: lane-wise
+    // min and max, the shuffle_* functions which permute the lanes
+    // of a vector, and the blend_* functions which take the upper
+    // lanes of every group of 4 or 2 lanes from their second
+    // parameter. Like the scalar swap_if for arithmetic types,
+    // compare-exchanges are computed with min and max.
+    //
+
+    template<typename T, typename=void>
+    struct simd_vector4
+    {
+        static constexpr bool available = false;
+    };
+
+#if CPPSORT_SSE41_AVAILABLE
+    template<typename T>
+    struct simd_vector4<T, std::enable_if_t<
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4
+    >>
+    {
+        static constexpr bool available = true;
+        using type = __m128i;
+
+        static auto load(const T* ptr) -> type { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+        static auto store(T* ptr, type x) -> void { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), x); }
+        static auto min(type a, type b) -> type { return _mm_min_epi32(a, b); }
+        static auto max(type a, type b) -> type { return _mm_max_epi32(a, b); }
+        static auto reverse(type x) -> type { return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3)); }
+        static auto shuffle_2(type x) -> type { return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)); }
+        static auto shuffle_1(type x) -> type { return _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)); }
+        static auto blend_2(type a, type b) -> type { return _mm_blend_epi16(a, b, 0xF0); }
+        static auto blend_1(type a, type b) -> type { return _mm_blend_epi16(a, b, 0xCC); }
+    };
+
+    template<>
+    struct simd_vector4<float>
+    {
+        static constexpr bool available = true;
+        using type = __m128;
+
+        static auto load(const float* ptr) -> type { return _mm_loadu_ps(ptr); }
+        static auto store(float* ptr, type x) -> void { _mm_storeu_ps(ptr, x); }
+        static auto min(type a, type b) -> type { return _mm_min_ps(a, b); }
+        static auto max(type a, type b) -> type { return _mm_max_ps(a, b); }
+        static auto reverse(type x) -> type { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3)); }
+        static auto shuffle_2(type x) -> type { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 3, 2)); }
+        static auto shuffle_1(type x) -> type { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)); }
+        static auto blend_2(type a, type b) -> type { return _mm_blend_ps(a, b, 0b1100); }
+        static auto blend_1(type a, type b) -> type { return _mm_blend_ps(a, b, 0b1010); }
+    };
+#endif
+
+    ////////////////////////////////////////////////////////////
+    // Bitonic sorting network working on vectors of four lanes
+    //
+    // Every merging stage starts with a compare-exchange between
+    // mirrored elements so that every compare-exchange puts the
+    // smallest element at the lowest index, which means that no
+    // lane ever needs to be sorted in descending order.
+    //
+    // Every step is instantiated for a given vector index, which
+    // ensures that all indices are known at compile time and that
+    // the vectors can be kept in registers for the whole network.
+
+    template<typename Vector>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_swap_if(typename Vector::type& a, typename Vector::type& b)
+        -> void
+    {
+        auto tmp = Vector::min(a, b);
+        b = Vector::max(a, b);
+        a = tmp;
+    }
+
+    template<typename Vector, std::size_t Distance>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_in_register_swap_if(typename Vector::type& x)
+        -> void
+    {
+        // Distance 4 stands for the mirrored lanes
+        auto partner = Distance == 1 ? Vector::shuffle_1(x) :
+                       Distance == 2 ? Vector::shuffle_2(x) :
+                                       Vector::reverse(x);
+        auto lo = Vector::min(x, partner);
+        auto hi = Vector::max(x, partner);
+        x = Distance == 1 ? Vector::blend_1(lo, hi) : Vector::blend_2(lo, hi);
+    }
+
+    // Compare-exchange mirrored elements in blocks of Size elements
+    template<typename Vector, std::size_t Size, std::size_t Index>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_mirror_step(typename Vector::type* vecs)
+        -> void
+    {
+        constexpr std::size_t block_size = Size >= 8 ? Size / 4 : 1;
+        constexpr std::size_t position = Index % block_size;
+        if (Size == 2) {
+            simd_in_register_swap_if<Vector, 1>(vecs[Index]);
+        } else if (Size == 4) {
+            simd_in_register_swap_if<Vector, 4>(vecs[Index]);
+        } else if (position < block_size / 2) {
+            auto& hi = vecs[Index - position + block_size - 1 - position];
+            auto tmp = Vector::reverse(hi);
+            simd_swap_if<Vector>(vecs[Index], tmp);
+            hi = Vector::reverse(tmp);
+        }
+    }
+
+    // Compare-exchange elements separated by Distance
+    template<typename Vector, std::size_t Distance, std::size_t Index>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_half_cleaner_step(typename Vector::type* vecs)
+        -> void
+    {
+        constexpr std::size_t vec_distance = Distance >= 4 ? Distance / 4 : 1;
+        if (Distance < 4) {
+            simd_in_register_swap_if<Vector, Distance>(vecs[Index]);
+        } else if ((Index & vec_distance) == 0) {
+            simd_swap_if<Vector>(vecs[Index], vecs[Index + vec_distance]);
+        }
+    }
+
+    template<typename Vector, std::size_t Size, std::size_t... Indices>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_mirror(typename Vector::type* vecs, std::index_sequence<Indices...>)
+        -> void
+    {
+        (void) std::initializer_list<int>{
+            (simd_mirror_step<Vector, Size, Indices>(vecs), 0)...
+        };
+    }
+
+    template<typename Vector, std::size_t Distance, std::size_t... Indices>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto simd_half_cleaner(typename Vector::type* vecs, std::index_sequence<Indices...>)
+        -> void
+    {
+        (void) std::initializer_list<int>{
+            (simd_half_cleaner_step<Vector, Distance, Indices>(vecs), 0)...
+        };
+    }
+
+    template<typename Vector, std::size_t Size, std::size_t N, bool = (Size > N)>
+    struct simd_bitonic_stages
+    {
+        template<typename Indices>
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto run(typename Vector::type* vecs, Indices indices)
+            -> void
+        {
+            simd_mirror<Vector, Size>(vecs, indices);
+            run_half_cleaners(vecs, indices, std::integral_constant<std::size_t, Size / 4>{});
+            simd_bitonic_stages<Vector, Size * 2, N>::run(vecs, indices);
+        }
+
+        template<typename Indices>
+        static auto run_half_cleaners(typename Vector::type*, Indices,
+                                      std::integral_constant<std::size_t, 0>)
+            -> void
+        {}
+
+        template<typename Indices, std::size_t Distance>
+        CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+        static auto run_half_cleaners(typename Vector::type* vecs, Indices indices,
+                                      std::integral_constant<std::size_t, Distance>)
+            -> void
+        {
+            simd_half_cleaner<Vector, Distance>(vecs, indices);
+            run_half_cleaners(vecs, indices, std::integral_constant<std::size_t, Distance / 2>{});
+        }
+    };
+
+    template<typename Vector, std::size_t Size, std::size_t N>
+    struct simd_bitonic_stages<Vector, Size, N, true>
+    {
+        template<typename Indices>
+        static auto run(typename Vector::type*, Indices)
+            -> void
+        {}
+    };
+
+    template<std::size_t N, typename T>
+    auto simd_sort_network(T* data)
+        -> void
+    {
+        using vector = simd_vector4<T>;
+        constexpr std::size_t nb_vectors = N / 4;
+
+        typename vector::type vecs[nb_vectors];
+        for (std::size_t i = 0 ; i < nb_vectors ; ++i) {
+            vecs[i] = vector::load(data + 4 * i);
+        }
+        simd_bitonic_stages<vector, 2, N>::run(vecs, std::make_index_sequence<nb_vectors>{});
+        for (std::size_t i = 0 ; i < nb_vectors ; ++i) {
+            vector::store(data + 4 * i, vecs[i]);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Whether the vectorized sorting network can be used
+    //
+    // The scalar networks for 8 elements or fewer are already
+    // compiled to branchless code that runs at least as fast as
+    // the vectorized one, so only bigger networks are vectorized
+
+    template<typename Compare, typename T>
+    struct is_simd_comparison:
+        std::false_type
+    {};
+
+    template<typename T>
+    struct is_simd_comparison<std::less<>, T>:
+        std::true_type
+    {};
+
+    template<typename T>
+    struct is_simd_comparison<std::less<T>, T>:
+        std::true_type
+    {};
+
+#ifdef __cpp_lib_ranges
+    template<typename T>
+    struct is_simd_comparison<std::ranges::less, T>:
+        std::true_type
+    {};
+#endif
+
+    template<typename Projection>
+    struct is_simd_projection:
+        std::false_type
+    {};
+
+    template<>
+    struct is_simd_projection<utility::identity>:
+        std::true_type
+    {};
+
+#if CPPSORT_STD_IDENTITY_AVAILABLE
+    template<>
+    struct is_simd_projection<std::identity>:
+        std::true_type
+    {};
+#endif
+
+    // Iterators known to point to contiguous memory
+    template<std::size_t N, typename Iterator, typename T>
+    struct is_simd_network_iterator:
+        disjunction<
+            std::is_same<Iterator, T*>,
+            std::is_same<Iterator, typename std::vector<T>::iterator>,
+            std::is_same<Iterator, typename std::array<T, N>::iterator>
+        >
+    {};
+
+    template<std::size_t N, typename Iterator, typename Compare, typename Projection>
+    struct is_simd_network_sortable:
+        conjunction<
+            std::integral_constant<bool, N == 16 || N == 32>,
+            std::integral_constant<bool, simd_vector4<value_type_t<Iterator>>::available>,
+            is_simd_network_iterator<N, Iterator, value_type_t<Iterator>>,
+            is_simd_comparison<Compare, value_type_t<Iterator>>,
+            is_simd_projection<Projection>
+        >
+    {};
+
+    template<std::size_t N, typename RandomAccessIterator>
+    auto simd_sort_network(RandomAccessIterator first)
+        -> void
+    {
+        simd_sort_network<N>(std::addressof(*first));
+    }
+}}
+
+#endif // CPPSORT_DETAIL_SORTING_NETWORK_SIMD_H_
@@ -13,6 +13,7 @@
 #include <cpp-sort/sorter_traits.h>
 #include <cpp-sort/utility/functional.h>
 #include "../swap_if.h"
+#include "simd.h"
 
 namespace cppsort
 {
@@ -21,13 +22,29 @@ namespace detail
     template<>
     struct sorting_network_sorter_impl<32u>
     {
+        template<
+            typename RandomAccessIterator,
+            typename Compare = std::less<>,
+            typename Projection = utility::identity
+        >
+        auto operator()(RandomAccessIterator first, RandomAccessIterator,
+                        Compare={}, Projection={}) const
+            -> std::enable_if_t<
+                is_simd_network_sortable<32u, RandomAccessIterator, Compare, Projection>::value
+            >
+        {
+            // Vectorized network for arithmetic types
+            simd_sort_network<32u>(first);
+        }
+
         template<
             typename RandomAccessIterator,
             typename Compare = std::less<>,
             typename Projection = utility::identity,
-            typename = std::enable_if_t<is_projection_iterator_v<
-                Projection, RandomAccessIterator, Compare
-            >>
+            typename = std::enable_if_t<
+                is_projection_iterator_v<Projection, RandomAccessIterator, Compare> &&
+                not is_simd_network_sortable<32u, RandomAccessIterator, Compare, Projection>::value
+            >
         >
         auto operator()(RandomAccessIterator first, RandomAccessIterator,
                         Compare compare={}, Projection projection={}) const
@@ -50,9 +50,13 @@ namespace detail
     auto swap_if(Integer& x, Integer& y, std::less<>, utility::identity) noexcept
         -> std::enable_if_t<std::is_integral<Integer>::value>
     {
+        // Selecting both values with the same condition is more
+        // reliably compiled to conditional moves than std::min
+        // and std::max, which compilers can turn into branches
         Integer dx = x;
-        x = (std::min)(x, y);
-        y ^= dx ^ x;
+        bool cond = y < x;
+        x = cond ? y : x;
+        y = cond ? dx : y;
     }
 
     template<typename Float>
@@ -69,8 +73,9 @@ namespace detail
         -> std::enable_if_t<std::is_integral<Integer>::value>
     {
         Integer dx = x;
-        x = (std::max)(x, y);
-        y ^= dx ^ x;
+        bool cond = x < y;
+        x = cond ? y : x;
+        y = cond ? dx : y;
     }
 
     template<typename Float>
@@ -82,6 +87,24 @@ namespace detail
         y = (std::min)(dx, y);
     }
 
+    // std::less<Float> and std::greater<Float> compare floating
+    // point numbers like their transparent counterparts, they use
+    // the same code so that the results are the same, NaN included
+
+    template<typename Float>
+    auto swap_if(Float& x, Float& y, std::less<Float>, utility::identity) noexcept
+        -> std::enable_if_t<std::is_floating_point<Float>::value>
+    {
+        return swap_if(x, y, std::less<>{}, utility::identity{});
+    }
+
+    template<typename Float>
+    auto swap_if(Float& x, Float& y, std::greater<Float>, utility::identity) noexcept
+        -> std::enable_if_t<std::is_floating_point<Float>::value>
+    {
+        return swap_if(x, y, std::greater<>{}, utility::identity{});
+    }
+
 #if CPPSORT_STD_IDENTITY_AVAILABLE
     template<typename Integer>
     auto swap_if(Integer& x, Integer& y, std::less<> comp, std::identity) noexcept
@@ -110,6 +133,20 @@ namespace detail
     {
         return swap_if(x, y, comp, utility::identity{});
     }
+
+    template<typename Float>
+    auto swap_if(Float& x, Float& y, std::less<Float>, std::identity) noexcept
+        -> std::enable_if_t<std::is_floating_point<Float>::value>
+    {
+        return swap_if(x, y, std::less<>{}, utility::identity{});
+    }
+
+    template<typename Float>
+    auto swap_if(Float& x, Float& y, std::greater<Float>, std::identity) noexcept
+        -> std::enable_if_t<std::is_floating_point<Float>::value>
+    {
+        return swap_if(x, y, std::greater<>{}, utility::identity{});
+    }
 #endif
 
 #ifdef __cpp_lib_ranges
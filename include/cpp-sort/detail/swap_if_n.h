@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_SWAP_IF_N_H_
+#define CPPSORT_DETAIL_SWAP_IF_N_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/utility/functional.h>
+#include "attributes.h"
+#include "config.h"
+#include "functional.h"
+#include "swap_if.h"
+
+#if CPPSORT_AVX_AVAILABLE
+#   include <immintrin.h>
+#elif CPPSORT_SSE41_AVAILABLE
+#   include <smmintrin.h>
+#elif CPPSORT_SSE2_AVAILABLE
+#   include <emmintrin.h>
+#endif
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Vectors used to compare-exchange several pairs at once
+    //
+    // The widest vectors available at compile time are used,
+    // size is 1 when there are no suitable vectors for a type.
+    // min and max take their parameters in the same order as
+    // the scalar swap_if overloads pass them to std::min and
+    // std::max, so that the results are the same even for NaN
+    // and signed zeros.
+    //
+
+    template<typename T, typename=void>
+    struct swap_if_lanes
+    {
+        static constexpr std::size_t size = 1;
+    };
+
+#if CPPSORT_AVX_AVAILABLE
+    template<>
+    struct swap_if_lanes<float>
+    {
+        static constexpr std::size_t size = 8;
+        using type = __m256;
+
+        static auto load(const float* ptr) -> type { return _mm256_loadu_ps(ptr); }
+        static auto store(float* ptr, type x) -> void { _mm256_storeu_ps(ptr, x); }
+        static auto min(type a, type b) -> type { return _mm256_min_ps(a, b); }
+        static auto max(type a, type b) -> type { return _mm256_max_ps(a, b); }
+    };
+
+    template<>
+    struct swap_if_lanes<double>
+    {
+        static constexpr std::size_t size = 4;
+        using type = __m256d;
+
+        static auto load(const double* ptr) -> type { return _mm256_loadu_pd(ptr); }
+        static auto store(double* ptr, type x) -> void { _mm256_storeu_pd(ptr, x); }
+        static auto min(type a, type b) -> type { return _mm256_min_pd(a, b); }
+        static auto max(type a, type b) -> type { return _mm256_max_pd(a, b); }
+    };
+#elif CPPSORT_SSE2_AVAILABLE
+    template<>
+    struct swap_if_lanes<float>
+    {
+        static constexpr std::size_t size = 4;
+        using type = __m128;
+
+        static auto load(const float* ptr) -> type { return _mm_loadu_ps(ptr); }
+        static auto store(float* ptr, type x) -> void { _mm_storeu_ps(ptr, x); }
+        static auto min(type a, type b) -> type { return _mm_min_ps(a, b); }
+        static auto max(type a, type b) -> type { return _mm_max_ps(a, b); }
+    };
+
+    template<>
+    struct swap_if_lanes<double>
+    {
+        static constexpr std::size_t size = 2;
+        using type = __m128d;
+
+        static auto load(const double* ptr) -> type { return _mm_loadu_pd(ptr); }
+        static auto store(double* ptr, type x) -> void { _mm_storeu_pd(ptr, x); }
+        static auto min(type a, type b) -> type { return _mm_min_pd(a, b); }
+        static auto max(type a, type b) -> type { return _mm_max_pd(a, b); }
+    };
+#endif
+
+#if CPPSORT_AVX2_AVAILABLE
+    template<typename T>
+    struct swap_if_lanes<T, std::enable_if_t<
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4
+    >>
+    {
+        static constexpr std::size_t size = 8;
+        using type = __m256i;
+
+        static auto load(const T* ptr) -> type { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+        static auto store(T* ptr, type x) -> void { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), x); }
+        static auto min(type a, type b) -> type { return _mm256_min_epi32(a, b); }
+        static auto max(type a, type b) -> type { return _mm256_max_epi32(a, b); }
+    };
+
+    template<typename T>
+    struct swap_if_lanes<T, std::enable_if_t<
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 8
+    >>
+    {
+        static constexpr std::size_t size = 4;
+        using type = __m256i;
+
+        static auto load(const T* ptr) -> type { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+        static auto store(T* ptr, type x) -> void { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), x); }
+
+        // Selecting with masks and xor is cheaper than blendv, and
+        // allows compilers to share most of the work between min
+        // and max
+        static auto min(type a, type b)
+            -> type
+        {
+            auto diff = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_cmpgt_epi64(a, b));
+            return _mm256_xor_si256(a, diff);
+        }
+
+        static auto max(type a, type b)
+            -> type
+        {
+            auto diff = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_cmpgt_epi64(a, b));
+            return _mm256_xor_si256(b, diff);
+        }
+    };
+#elif CPPSORT_SSE2_AVAILABLE
+    template<typename T>
+    struct swap_if_lanes<T, std::enable_if_t<
+        std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4
+    >>
+    {
+        static constexpr std::size_t size = 4;
+        using type = __m128i;
+
+        static auto load(const T* ptr) -> type { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+        static auto store(T* ptr, type x) -> void { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), x); }
+#   if CPPSORT_SSE41_AVAILABLE
+        static auto min(type a, type b) -> type { return _mm_min_epi32(a, b); }
+        static auto max(type a, type b) -> type { return _mm_max_epi32(a, b); }
+#   else
+        // SSE2 has no min and max instructions for 32-bit integers,
+        // selecting with masks and xor allows compilers to share
+        // most of the work between min and max
+        static auto min(type a, type b)
+            -> type
+        {
+            auto diff = _mm_and_si128(_mm_xor_si128(a, b), _mm_cmpgt_epi32(a, b));
+            return _mm_xor_si128(a, diff);
+        }
+
+        static auto max(type a, type b)
+            -> type
+        {
+            auto diff = _mm_and_si128(_mm_xor_si128(a, b), _mm_cmpgt_epi32(a, b));
+            return _mm_xor_si128(b, diff);
+        }
+#   endif
+    };
+#endif
+
+    template<typename Projection>
+    struct is_swap_if_n_projection:
+        std::is_same<Projection, utility::identity>
+    {};
+
+#if CPPSORT_STD_IDENTITY_AVAILABLE
+    template<>
+    struct is_swap_if_n_projection<std::identity>:
+        std::true_type
+    {};
+#endif
+
+    ////////////////////////////////////////////////////////////
+    // swap_if_n
+    //
+    // Compare-exchanges lhs[i] and rhs[i] for every i in [0, n),
+    // the two ranges must not overlap. When the elements, the
+    // comparison and the projection allow it, several pairs are
+    // compare-exchanged at once with SIMD instructions.
+
+    template<typename T, typename Compare, typename Projection>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto swap_if_n(T* lhs, T* rhs, std::size_t n,
+                   Compare compare, Projection projection,
+                   std::integral_constant<int, 0>)
+        -> void
+    {
+        for (std::size_t i = 0 ; i < n ; ++i) {
+            swap_if(lhs[i], rhs[i], compare, projection);
+        }
+    }
+
+    template<typename T, typename Compare, typename Projection, int Direction>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto swap_if_n(T* lhs, T* rhs, std::size_t n,
+                   Compare compare, Projection projection,
+                   std::integral_constant<int, Direction>)
+        -> void
+    {
+        using lanes = swap_if_lanes<T>;
+
+        std::size_t i = 0;
+        for (; i + lanes::size <= n ; i += lanes::size) {
+            auto x = lanes::load(lhs + i);
+            auto y = lanes::load(rhs + i);
+            if (Direction > 0) {
+                lanes::store(lhs + i, lanes::min(y, x));
+                lanes::store(rhs + i, lanes::max(y, x));
+            } else {
+                lanes::store(lhs + i, lanes::max(y, x));
+                lanes::store(rhs + i, lanes::min(y, x));
+            }
+        }
+        for (; i < n ; ++i) {
+            swap_if(lhs[i], rhs[i], compare, projection);
+        }
+    }
+
+    template<typename T, typename Compare, typename Projection>
+    CPPSORT_ATTRIBUTE_ALWAYS_INLINE
+    auto swap_if_n(T* lhs, T* rhs, std::size_t n,
+                   Compare compare, Projection projection)
+        -> void
+    {
+        constexpr int direction =
+            (swap_if_lanes<T>::size > 1 && is_swap_if_n_projection<Projection>::value) ?
+                comparison_direction<Compare, T>::value : 0;
+        swap_if_n(lhs, rhs, n, std::move(compare), std::move(projection),
+                  std::integral_constant<int, direction>{});
+    }
+}}
+
+#endif // CPPSORT_DETAIL_SWAP_IF_N_H_
@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_DETAIL_TASK_POOL_H_
+#define CPPSORT_DETAIL_TASK_POOL_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "config.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Type-erased unit of work
+
+    class task_base
+    {
+        public:
+
+            task_base() = default;
+            task_base(const task_base&) = delete;
+            task_base& operator=(const task_base&) = delete;
+            virtual ~task_base() = default;
+
+            auto execute() noexcept
+                -> void
+            {
+                try {
+                    do_execute();
+                } catch (...) {
+                    exception = std::current_exception();
+                }
+                done.store(true, std::memory_order_release);
+            }
+
+            auto is_done() const noexcept
+                -> bool
+            {
+                return done.load(std::memory_order_acquire);
+            }
+
+            // Only meaningful once is_done() returns true
+            std::exception_ptr exception;
+
+        private:
+
+            virtual auto do_execute()
+                -> void
+                = 0;
+
+            std::atomic<bool> done{false};
+    };
+
+    template<typename Func>
+    class task_impl final:
+        public task_base
+    {
+        public:
+
+            template<typename F>
+            explicit task_impl(F&& func):
+                func(std::forward<F>(func))
+            {}
+
+            // User-provided so that GCC doesn't consider the destructor
+            // as declared inline and warn when it isn't inlined in the
+            // deleting destructor
+            ~task_impl() override {}
+
+        private:
+
+            auto do_execute()
+                -> void override
+            {
+                func();
+            }
+
+            Func func;
+    };
+
+    class task_pool;
+
+    // Runs the pending tasks of the pool until the given task is done
+    inline auto wait_for(task_pool& pool, task_base& task) noexcept
+        -> void;
+
+    ////////////////////////////////////////////////////////////
+    // Handle to a forked task
+    //
+    // A forked task must be joined before the data it refers to
+    // goes out of scope: when a task handle is destroyed before
+    // being explicitly joined (typically when an exception is
+    // thrown), its destructor waits for the task to complete and
+    // silently drops any exception it might have thrown.
+    //
+
+    class task_handle
+    {
+        public:
+
+            task_handle(task_pool& pool, std::unique_ptr<task_base>&& task) noexcept:
+                pool(&pool),
+                task(std::move(task))
+            {}
+
+            task_handle(task_handle&&) noexcept = default;
+            task_handle(const task_handle&) = delete;
+            task_handle& operator=(const task_handle&) = delete;
+            task_handle& operator=(task_handle&&) = delete;
+
+            ~task_handle()
+            {
+                if (task) {
+                    wait_for(*pool, *task);
+                }
+            }
+
+        private:
+
+            friend class task_pool;
+
+            task_pool* pool;
+            std::unique_ptr<task_base> task;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Work-stealing fork-join pool
+    //
+    // Every thread of the pool owns a double-ended queue of tasks:
+    // it pushes and pops tasks at the back of its own queue, and
+    // steals tasks from the front of the other queues when its own
+    // one is empty. The thread that constructed the pool counts as
+    // one of its threads: it owns the first queue and is expected
+    // to fork the root tasks. Joining a task never blocks: the
+    // joining thread runs pending tasks until the joined one is
+    // done, which makes nested fork-join parallelism deadlock-free.
+    //
+
+    class task_pool
+    {
+        public:
+
+            ////////////////////////////////////////////////////////////
+            // Construction & destruction
+
+            explicit task_pool(std::size_t nb_threads):
+                nb_queues(std::max(nb_threads, std::size_t(1))),
+                queues(new task_queue[nb_queues])
+            {
+                try {
+                    threads.reserve(nb_queues - 1);
+                    for (std::size_t idx = 1 ; idx < nb_queues ; ++idx) {
+                        threads.emplace_back([this, idx] { worker_loop(idx); });
+                    }
+                } catch (...) {
+                    stop();
+                    throw;
+                }
+            }
+
+            task_pool(const task_pool&) = delete;
+            task_pool& operator=(const task_pool&) = delete;
+
+            ~task_pool()
+            {
+                stop();
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Observers
+
+            auto size() const noexcept
+                -> std::size_t
+            {
+                return nb_queues;
+            }
+
+            // Number of threads to use when none is given
+            static auto default_nb_threads(std::size_t nb_threads) noexcept
+                -> std::size_t
+            {
+                if (nb_threads != 0) {
+                    return nb_threads;
+                }
+                // hardware_concurrency() is allowed to return 0 when
+                // the number of threads can't be computed
+                return std::max(std::thread::hardware_concurrency(), 1u);
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Fork-join operations
+
+            template<typename Func>
+            auto fork(Func&& func)
+                -> task_handle
+            {
+                std::unique_ptr<task_base> task(
+                    new task_impl<std::decay_t<Func>>(std::forward<Func>(func))
+                );
+                push(task.get());
+                return task_handle(*this, std::move(task));
+            }
+
+            auto join(task_handle& handle)
+                -> void
+            {
+                CPPSORT_ASSERT(handle.pool == this);
+                wait(*handle.task);
+                auto task = std::move(handle.task);
+                if (task->exception) {
+                    std::rethrow_exception(task->exception);
+                }
+            }
+
+        private:
+
+            friend auto wait_for(task_pool& pool, task_base& task) noexcept
+                -> void;
+
+            struct task_queue
+            {
+                std::mutex mutex;
+                std::deque<task_base*> tasks;
+            };
+
+            ////////////////////////////////////////////////////////////
+            // Worker threads management
+
+            static auto current_worker() noexcept
+                -> std::pair<const task_pool*, std::size_t>&
+            {
+                static thread_local std::pair<const task_pool*, std::size_t> worker(nullptr, 0);
+                return worker;
+            }
+
+            auto current_index() const noexcept
+                -> std::size_t
+            {
+                // Threads that don't belong to the pool use the first
+                // queue, which is meant for the pool owner
+                auto& worker = current_worker();
+                return worker.first == this ? worker.second : 0;
+            }
+
+            auto worker_loop(std::size_t index)
+                -> void
+            {
+                current_worker() = { this, index };
+                while (true) {
+                    if (try_run_one(index)) {
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> lock(sleep_mutex);
+                    sleep_cv.wait(lock, [this] {
+                        return stopping || nb_pending.load(std::memory_order_acquire) > 0;
+                    });
+                    if (stopping) {
+                        return;
+                    }
+                }
+            }
+
+            auto stop() noexcept
+                -> void
+            {
+                {
+                    std::lock_guard<std::mutex> lock(sleep_mutex);
+                    stopping = true;
+                }
+                sleep_cv.notify_all();
+                for (auto& thread: threads) {
+                    thread.join();
+                }
+                threads.clear();
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Tasks scheduling
+
+            auto push(task_base* task)
+                -> void
+            {
+                // The number of pending tasks is only updated under the
+                // lock of the queue, before the task becomes visible to
+                // the other threads and after it was removed, so that it
+                // can never be smaller than the number of queued tasks
+                auto& queue = queues[current_index()];
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    nb_pending.fetch_add(1, std::memory_order_release);
+                    queue.tasks.push_back(task);
+                }
+                {
+                    // Sleeping workers check nb_pending under this lock,
+                    // taking it ensures that the notification isn't lost
+                    std::lock_guard<std::mutex> lock(sleep_mutex);
+                }
+                sleep_cv.notify_one();
+            }
+
+            auto try_pop(std::size_t index)
+                -> task_base*
+            {
+                // Pop from the back of our own queue to benefit from
+                // cache locality with the most recently forked task
+                auto& queue = queues[index];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.tasks.empty()) {
+                    return nullptr;
+                }
+                auto task = queue.tasks.back();
+                queue.tasks.pop_back();
+                nb_pending.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+
+            auto try_steal(std::size_t index)
+                -> task_base*
+            {
+                // Steal from the front of the other queues, where the
+                // oldest and thus generally biggest tasks are
+                for (std::size_t offset = 1 ; offset < nb_queues ; ++offset) {
+                    auto& queue = queues[(index + offset) % nb_queues];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (not queue.tasks.empty()) {
+                        auto task = queue.tasks.front();
+                        queue.tasks.pop_front();
+                        nb_pending.fetch_sub(1, std::memory_order_relaxed);
+                        return task;
+                    }
+                }
+                return nullptr;
+            }
+
+            auto try_run_one(std::size_t index)
+                -> bool
+            {
+                auto task = try_pop(index);
+                if (task == nullptr) {
+                    task = try_steal(index);
+                    if (task == nullptr) {
+                        return false;
+                    }
+                }
+                task->execute();
+                return true;
+            }
+
+            auto wait(task_base& task) noexcept
+                -> void
+            {
+                auto index = current_index();
+                while (not task.is_done()) {
+                    if (not try_run_one(index)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Data members
+
+            std::size_t nb_queues;
+            std::unique_ptr<task_queue[]> queues;
+            std::vector<std::thread> threads;
+
+            std::mutex sleep_mutex;
+            std::condition_variable sleep_cv;
+            std::atomic<std::size_t> nb_pending{0};
+            bool stopping = false;
+    };
+
+    inline auto wait_for(task_pool& pool, task_base& task) noexcept
+        -> void
+    {
+        pool.wait(task);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Fork-join helpers
+
+    template<typename Func1, typename Func2>
+    auto parallel_invoke(task_pool& pool, Func1&& func1, Func2&& func2)
+        -> void
+    {
+        auto handle = pool.fork(std::forward<Func2>(func2));
+        std::forward<Func1>(func1)();
+        pool.join(handle);
+    }
+
+    template<typename Integer, typename Func>
+    auto parallel_for(task_pool& pool, Integer first, Integer last, Func&& func)
+        -> void
+    {
+        // Recursively split [first, last) so that the tasks are
+        // spread across the threads without a central queue
+        if (last - first <= 1) {
+            if (first != last) {
+                func(first);
+            }
+            return;
+        }
+        auto middle = first + (last - first) / 2;
+        parallel_invoke(pool,
+            [&] { parallel_for(pool, first, middle, func); },
+            [&] { parallel_for(pool, middle, last, func); }
+        );
+    }
+}}
+
+#endif // CPPSORT_DETAIL_TASK_POOL_H_
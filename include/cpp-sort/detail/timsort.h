@@ -86,9 +86,10 @@ namespace detail
         std::ptrdiff_t buffer_size = 0;
 
         // Silence GCC -Winline warning
+        TimSort() {}
         ~TimSort() noexcept {}
 
-        std::vector<run<iterator>> pending_;
+        std::vector<run<iterator>, resource_allocator<run<iterator>>> pending_;
 
         static auto sort(iterator const lo, iterator const hi, Compare compare, Projection projection)
             -> void
@@ -418,7 +419,7 @@ namespace detail
                 buffer.reset(nullptr);
                 buffer.get_deleter() = operator_deleter(new_size * sizeof(rvalue_type));
                 buffer.reset(static_cast<rvalue_type*>(
-                    ::operator new(new_size * sizeof(rvalue_type))
+                    allocate_bytes(new_size * sizeof(rvalue_type))
                 ));
                 buffer_size = new_size;
             }
@@ -96,4 +96,7 @@ namespace cppsort
 #include "../detail/sorting_network/sort31.h"
 #include "../detail/sorting_network/sort32.h"
 
+// Sorting several arrays at once
+#include "../detail/sorting_network/batch.h"
+
 #endif // CPPSORT_FIXED_SORTING_NETWORK_SORTER_H_
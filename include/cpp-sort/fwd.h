@@ -36,14 +36,20 @@ namespace cppsort
     struct heap_sorter;
     struct insertion_sorter;
     struct integer_spread_sorter;
+    template<typename BufferProvider>
+    struct lsd_radix_sorter;
     struct mel_sorter;
     struct merge_insertion_sorter;
     struct merge_sorter;
+    struct parallel_merge_sorter;
+    struct parallel_pdq_sorter;
+    struct parallel_ska_sorter;
     struct pdq_sorter;
     struct poplar_sorter;
     struct quick_merge_sorter;
     struct quick_sorter;
     struct selection_sorter;
+    struct simd_quick_sorter;
     struct ska_sorter;
     struct slab_sorter;
     struct smooth_sorter;
@@ -77,6 +83,8 @@ namespace cppsort
     template<typename Sorter>
     struct indirect_adapter;
     template<typename Sorter>
+    struct memory_resource_adapter;
+    template<typename Sorter>
     struct out_of_place_adapter;
     template<typename Sorter>
     struct schwartz_adapter;
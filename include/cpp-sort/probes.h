@@ -17,6 +17,11 @@
 #include <cpp-sort/probes/mono.h>
 #include <cpp-sort/probes/osc.h>
 #include <cpp-sort/probes/par.h>
+#include <cpp-sort/probes/parallel_ham.h>
+#include <cpp-sort/probes/parallel_inv.h>
+#include <cpp-sort/probes/parallel_max.h>
+#include <cpp-sort/probes/parallel_mono.h>
+#include <cpp-sort/probes/parallel_runs.h>
 #include <cpp-sort/probes/rem.h>
 #include <cpp-sort/probes/runs.h>
 #include <cpp-sort/probes/sus.h>
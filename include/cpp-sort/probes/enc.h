@@ -21,6 +21,7 @@
 #include "../detail/functional.h"
 #include "../detail/iterator_traits.h"
 #include "../detail/lower_bound.h"
+#include "../detail/memory.h"
 
 namespace cppsort
 {
@@ -50,7 +51,10 @@ namespace probe
                 }
 
                 // Heads an tails of encroaching lists
-                std::vector<std::pair<ForwardIterator, ForwardIterator>> lists;
+                std::vector<
+                    std::pair<ForwardIterator, ForwardIterator>,
+                    cppsort::detail::resource_allocator<std::pair<ForwardIterator, ForwardIterator>>
+                > lists;
                 lists.emplace_back(first, first);
                 ++first;
 
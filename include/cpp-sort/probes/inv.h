@@ -10,9 +10,9 @@
 ////////////////////////////////////////////////////////////
 #include <functional>
 #include <iterator>
-#include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include <cpp-sort/sorter_facade.h>
 #include <cpp-sort/sorter_traits.h>
 #include <cpp-sort/utility/functional.h>
@@ -21,6 +21,7 @@
 #include "../detail/count_inversions.h"
 #include "../detail/functional.h"
 #include "../detail/iterator_traits.h"
+#include "../detail/memory.h"
 
 namespace cppsort
 {
@@ -40,16 +41,16 @@ namespace probe
                 return 0;
             }
 
-            auto iterators = std::make_unique<ForwardIterator[]>(size);
-            auto buffer = std::make_unique<ForwardIterator[]>(size);
+            std::vector<ForwardIterator, cppsort::detail::resource_allocator<ForwardIterator>> iterators(size);
+            std::vector<ForwardIterator, cppsort::detail::resource_allocator<ForwardIterator>> buffer(size);
 
-            auto store = iterators.get();
+            auto store = iterators.data();
             for (ForwardIterator it = first ; it != last ; ++it) {
                 *store++ = it;
             }
 
             return cppsort::detail::count_inversions<difference_type>(
-                iterators.get(), iterators.get() + size, buffer.get(),
+                iterators.data(), iterators.data() + size, buffer.data(),
                 std::move(compare),
                 cppsort::detail::indirect(std::move(projection))
             );
@@ -23,6 +23,7 @@
 #include "../detail/equal_range.h"
 #include "../detail/functional.h"
 #include "../detail/iterator_traits.h"
+#include "../detail/memory.h"
 #include "../detail/pdqsort.h"
 
 namespace cppsort
@@ -48,7 +49,7 @@ namespace probe
             // Indirectly sort the iterators
 
             // Copy the iterators in a vector
-            std::vector<ForwardIterator> iterators;
+            std::vector<ForwardIterator, cppsort::detail::resource_allocator<ForwardIterator>> iterators;
             iterators.reserve(size);
             for (ForwardIterator it = first ; it != last ; ++it) {
                 iterators.push_back(it);
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_PARALLEL_HAM_H_
+#define CPPSORT_PROBES_PARALLEL_HAM_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/ham.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/parallel_probes.h"
+#include "../detail/task_pool.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        struct parallel_ham_impl
+        {
+            // Number of threads to use, 0 means that the number
+            // of hardware threads is used instead
+            std::size_t nb_threads = 0;
+
+            parallel_ham_impl() = default;
+
+            constexpr explicit parallel_ham_impl(std::size_t nb_threads) noexcept:
+                nb_threads(nb_threads)
+            {}
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> cppsort::detail::difference_type_t<RandomAccessIterator>
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        cppsort::detail::iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_ham requires at least random-access iterators"
+                );
+                using difference_type = cppsort::detail::difference_type_t<RandomAccessIterator>;
+
+                auto size = last - first;
+                auto threads = cppsort::detail::parallel_probe_nb_threads(nb_threads, size);
+                if (threads <= 1) {
+                    return ham_probe_algo(first, last, size,
+                                          std::move(compare), std::move(projection));
+                }
+
+                auto iterators = cppsort::detail::parallel_sort_iterators(
+                    first, last, compare, projection, threads
+                );
+
+                // Count the number of values not in place
+                cppsort::detail::task_pool pool(threads);
+                auto counts = cppsort::detail::parallel_map_chunks<difference_type>(pool, size,
+                    [&](difference_type begin, difference_type end) {
+                        auto&& comp = utility::as_function(compare);
+                        auto&& proj = utility::as_function(projection);
+
+                        difference_type count = 0;
+                        for (auto idx = begin ; idx != end ; ++idx) {
+                            auto&& value = proj(first[idx]);
+                            auto&& sorted_value = proj(*iterators[static_cast<std::size_t>(idx)]);
+                            if (comp(value, sorted_value) || comp(sorted_value, value)) {
+                                ++count;
+                            }
+                        }
+                        return count;
+                    }
+                );
+
+                difference_type count = 0;
+                for (auto chunk_count: counts) {
+                    count += chunk_count;
+                }
+                return count;
+            }
+
+            template<typename Integer>
+            static constexpr auto max_for_size(Integer n)
+                -> Integer
+            {
+                return ham_impl::max_for_size(n);
+            }
+        };
+    }
+
+    struct parallel_ham_probe:
+        sorter_facade<detail::parallel_ham_impl>
+    {
+        parallel_ham_probe() = default;
+
+        constexpr explicit parallel_ham_probe(std::size_t nb_threads) noexcept:
+            sorter_facade<detail::parallel_ham_impl>(nb_threads)
+        {}
+    };
+
+    namespace
+    {
+        constexpr auto&& parallel_ham
+            = utility::static_const<parallel_ham_probe>::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_PARALLEL_HAM_H_
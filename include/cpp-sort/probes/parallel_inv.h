@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_PARALLEL_INV_H_
+#define CPPSORT_PROBES_PARALLEL_INV_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cpp-sort/probes/inv.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/size.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/functional.h"
+#include "../detail/iterator_traits.h"
+#include "../detail/memory.h"
+#include "../detail/parallel_probes.h"
+#include "../detail/task_pool.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        template<typename ForwardIterator, typename Compare, typename Projection>
+        auto parallel_inv_probe_algo(ForwardIterator first, ForwardIterator last,
+                                     cppsort::detail::difference_type_t<ForwardIterator> size,
+                                     Compare compare, Projection projection,
+                                     std::size_t nb_threads)
+            -> ::cppsort::detail::difference_type_t<ForwardIterator>
+        {
+            using difference_type = ::cppsort::detail::difference_type_t<ForwardIterator>;
+
+            auto threads = cppsort::detail::parallel_probe_nb_threads(nb_threads, size);
+            if (threads <= 1) {
+                return inv_probe_algo(std::move(first), std::move(last), size,
+                                      std::move(compare), std::move(projection));
+            }
+
+            std::vector<ForwardIterator, cppsort::detail::resource_allocator<ForwardIterator>> iterators(size);
+            std::vector<ForwardIterator, cppsort::detail::resource_allocator<ForwardIterator>> buffer(size);
+
+            auto store = iterators.data();
+            for (ForwardIterator it = first ; it != last ; ++it) {
+                *store++ = it;
+            }
+
+            // Give every thread several subranges to count for load balancing
+            auto leaf_size = std::max(
+                difference_type(cppsort::detail::parallel_probe_grain),
+                size / static_cast<difference_type>(8 * threads)
+            );
+
+            cppsort::detail::task_pool pool(threads);
+            return cppsort::detail::parallel_count_inversions<difference_type>(
+                pool, iterators.data(), iterators.data() + size, buffer.data(), leaf_size,
+                std::move(compare),
+                cppsort::detail::indirect(std::move(projection))
+            );
+        }
+
+        struct parallel_inv_impl
+        {
+            // Number of threads to use, 0 means that the number
+            // of hardware threads is used instead
+            std::size_t nb_threads = 0;
+
+            parallel_inv_impl() = default;
+
+            constexpr explicit parallel_inv_impl(std::size_t nb_threads) noexcept:
+                nb_threads(nb_threads)
+            {}
+
+            template<
+                typename ForwardIterable,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_v<Projection, ForwardIterable, Compare>
+                >
+            >
+            auto operator()(ForwardIterable&& iterable,
+                            Compare compare={}, Projection projection={}) const
+                -> decltype(auto)
+            {
+                return parallel_inv_probe_algo(std::begin(iterable), std::end(iterable),
+                                               utility::size(iterable),
+                                               std::move(compare), std::move(projection),
+                                               nb_threads);
+            }
+
+            template<
+                typename ForwardIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, ForwardIterator, Compare>
+                >
+            >
+            auto operator()(ForwardIterator first, ForwardIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> decltype(auto)
+            {
+                return parallel_inv_probe_algo(first, last, std::distance(first, last),
+                                               std::move(compare), std::move(projection),
+                                               nb_threads);
+            }
+
+            template<typename Integer>
+            static constexpr auto max_for_size(Integer n)
+                -> Integer
+            {
+                return inv_impl::max_for_size(n);
+            }
+        };
+    }
+
+    struct parallel_inv_probe:
+        sorter_facade<detail::parallel_inv_impl>
+    {
+        parallel_inv_probe() = default;
+
+        constexpr explicit parallel_inv_probe(std::size_t nb_threads) noexcept:
+            sorter_facade<detail::parallel_inv_impl>(nb_threads)
+        {}
+    };
+
+    namespace
+    {
+        constexpr auto&& parallel_inv
+            = utility::static_const<parallel_inv_probe>::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_PARALLEL_INV_H_
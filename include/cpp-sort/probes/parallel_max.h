@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_PARALLEL_MAX_H_
+#define CPPSORT_PROBES_PARALLEL_MAX_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/max.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/equal_range.h"
+#include "../detail/functional.h"
+#include "../detail/iterator_traits.h"
+#include "../detail/parallel_probes.h"
+#include "../detail/task_pool.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        struct parallel_max_impl
+        {
+            // Number of threads to use, 0 means that the number
+            // of hardware threads is used instead
+            std::size_t nb_threads = 0;
+
+            parallel_max_impl() = default;
+
+            constexpr explicit parallel_max_impl(std::size_t nb_threads) noexcept:
+                nb_threads(nb_threads)
+            {}
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> cppsort::detail::difference_type_t<RandomAccessIterator>
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        cppsort::detail::iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_max requires at least random-access iterators"
+                );
+                using difference_type = cppsort::detail::difference_type_t<RandomAccessIterator>;
+
+                auto size = last - first;
+                auto threads = cppsort::detail::parallel_probe_nb_threads(nb_threads, size);
+                if (threads <= 1) {
+                    return max_probe_algo(first, last, size,
+                                          std::move(compare), std::move(projection));
+                }
+
+                auto iterators = cppsort::detail::parallel_sort_iterators(
+                    first, last, compare, projection, threads
+                );
+
+                // Maximum distance an element has to travel in order
+                // to reach its sorted position
+                cppsort::detail::task_pool pool(threads);
+                auto distances = cppsort::detail::parallel_map_chunks<difference_type>(pool, size,
+                    [&](difference_type begin, difference_type end) {
+                        auto&& proj = utility::as_function(projection);
+
+                        difference_type max_dist = 0;
+                        for (auto it_pos = begin ; it_pos != end ; ++it_pos) {
+                            // Find the range where the element belongs once sorted
+                            auto rng = cppsort::detail::equal_range(
+                                iterators.begin(), iterators.end(), proj(first[it_pos]),
+                                compare, cppsort::detail::indirect(projection)
+                            );
+                            auto pos_min = rng.first - iterators.begin();
+                            auto pos_max = rng.second - iterators.begin();
+
+                            // If it isn't in one of its sorted positions, compute the closest
+                            if (it_pos < pos_min) {
+                                max_dist = (std::max)(pos_min - it_pos, max_dist);
+                            } else if (it_pos >= pos_max) {
+                                max_dist = (std::max)(it_pos - pos_max + 1, max_dist);
+                            }
+                        }
+                        return max_dist;
+                    }
+                );
+
+                return *std::max_element(distances.begin(), distances.end());
+            }
+
+            template<typename Integer>
+            static constexpr auto max_for_size(Integer n)
+                -> Integer
+            {
+                return max_impl::max_for_size(n);
+            }
+        };
+    }
+
+    struct parallel_max_probe:
+        sorter_facade<detail::parallel_max_impl>
+    {
+        parallel_max_probe() = default;
+
+        constexpr explicit parallel_max_probe(std::size_t nb_threads) noexcept:
+            sorter_facade<detail::parallel_max_impl>(nb_threads)
+        {}
+    };
+
+    namespace
+    {
+        constexpr auto&& parallel_max
+            = utility::static_const<parallel_max_probe>::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_PARALLEL_MAX_H_
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_PARALLEL_MONO_H_
+#define CPPSORT_PROBES_PARALLEL_MONO_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/mono.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/parallel_probes.h"
+#include "../detail/task_pool.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        ////////////////////////////////////////////////////////////
+        // The sequential mono probe reads the pairs of adjacent
+        // elements from left to right with three states: between
+        // runs, in an ascending run, or in a descending run. Pairs
+        // of equivalent elements never change the state, a strictly
+        // ascending or descending pair starts a run of the same
+        // direction when between runs, and a pair going in the
+        // opposite direction of the current run ends it and is
+        // counted. Since the state at the beginning of a chunk isn't
+        // known in advance, every chunk is read once for each of the
+        // three possible initial states, then the results of the
+        // chunks are chained from left to right.
+
+        enum struct mono_state
+        {
+            between_runs,
+            ascending,
+            descending
+        };
+
+        template<typename Integer>
+        struct mono_chunk_result
+        {
+            // Final state and number of runs ended for every
+            // possible initial state
+            mono_state states[3];
+            Integer counts[3];
+        };
+
+        struct parallel_mono_impl
+        {
+            // Number of threads to use, 0 means that the number
+            // of hardware threads is used instead
+            std::size_t nb_threads = 0;
+
+            parallel_mono_impl() = default;
+
+            constexpr explicit parallel_mono_impl(std::size_t nb_threads) noexcept:
+                nb_threads(nb_threads)
+            {}
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> cppsort::detail::difference_type_t<RandomAccessIterator>
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        cppsort::detail::iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_mono requires at least random-access iterators"
+                );
+                using difference_type = cppsort::detail::difference_type_t<RandomAccessIterator>;
+
+                auto size = last - first;
+                auto threads = cppsort::detail::parallel_probe_nb_threads(nb_threads, size);
+                if (threads <= 1) {
+                    return mono_impl{}(std::move(first), std::move(last),
+                                       std::move(compare), std::move(projection));
+                }
+
+                cppsort::detail::task_pool pool(threads);
+                auto results = cppsort::detail::parallel_map_chunks<mono_chunk_result<difference_type>>(
+                    pool, size - 1,
+                    [&](difference_type begin, difference_type end) {
+                        auto&& comp = utility::as_function(compare);
+                        auto&& proj = utility::as_function(projection);
+
+                        mono_chunk_result<difference_type> res = {
+                            { mono_state::between_runs, mono_state::ascending, mono_state::descending },
+                            { 0, 0, 0 }
+                        };
+                        auto it = first + begin;
+                        auto chunk_last = first + end;
+                        for (; it != chunk_last ; ++it) {
+                            // The three reads generally reach the same state
+                            // quickly, after which they can't diverge anymore
+                            if (res.states[0] == res.states[1] && res.states[1] == res.states[2]) {
+                                break;
+                            }
+
+                            mono_state direction;
+                            if (comp(proj(*it), proj(it[1]))) {
+                                direction = mono_state::ascending;
+                            } else if (comp(proj(it[1]), proj(*it))) {
+                                direction = mono_state::descending;
+                            } else {
+                                continue;
+                            }
+
+                            for (int idx = 0 ; idx < 3 ; ++idx) {
+                                if (res.states[idx] == mono_state::between_runs) {
+                                    res.states[idx] = direction;
+                                } else if (res.states[idx] != direction) {
+                                    res.states[idx] = mono_state::between_runs;
+                                    ++res.counts[idx];
+                                }
+                            }
+                        }
+                        if (it == chunk_last) {
+                            return res;
+                        }
+
+                        // Finish the chunk with a single read
+                        auto state = res.states[0];
+                        difference_type count = 0;
+                        for (; it != chunk_last ; ++it) {
+                            switch (state) {
+                                case mono_state::between_runs:
+                                    if (comp(proj(*it), proj(it[1]))) {
+                                        state = mono_state::ascending;
+                                    } else if (comp(proj(it[1]), proj(*it))) {
+                                        state = mono_state::descending;
+                                    }
+                                    break;
+                                case mono_state::ascending:
+                                    if (comp(proj(it[1]), proj(*it))) {
+                                        state = mono_state::between_runs;
+                                        ++count;
+                                    }
+                                    break;
+                                case mono_state::descending:
+                                    if (comp(proj(*it), proj(it[1]))) {
+                                        state = mono_state::between_runs;
+                                        ++count;
+                                    }
+                                    break;
+                            }
+                        }
+
+                        for (int idx = 0 ; idx < 3 ; ++idx) {
+                            res.states[idx] = state;
+                            res.counts[idx] += count;
+                        }
+                        return res;
+                    }
+                );
+
+                auto state = mono_state::between_runs;
+                difference_type count = 0;
+                for (auto& res: results) {
+                    auto idx = static_cast<int>(state);
+                    count += res.counts[idx];
+                    state = res.states[idx];
+                }
+                return count;
+            }
+
+            template<typename Integer>
+            static constexpr auto max_for_size(Integer n)
+                -> Integer
+            {
+                return mono_impl::max_for_size(n);
+            }
+        };
+    }
+
+    struct parallel_mono_probe:
+        sorter_facade<detail::parallel_mono_impl>
+    {
+        parallel_mono_probe() = default;
+
+        constexpr explicit parallel_mono_probe(std::size_t nb_threads) noexcept:
+            sorter_facade<detail::parallel_mono_impl>(nb_threads)
+        {}
+    };
+
+    namespace
+    {
+        constexpr auto&& parallel_mono
+            = utility::static_const<parallel_mono_probe>::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_PARALLEL_MONO_H_
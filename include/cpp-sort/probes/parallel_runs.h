@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_PROBES_PARALLEL_RUNS_H_
+#define CPPSORT_PROBES_PARALLEL_RUNS_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/probes/runs.h>
+#include <cpp-sort/sorter_facade.h>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/iterator_traits.h"
+#include "../detail/parallel_probes.h"
+#include "../detail/task_pool.h"
+
+namespace cppsort
+{
+namespace probe
+{
+    namespace detail
+    {
+        struct parallel_runs_impl
+        {
+            // Number of threads to use, 0 means that the number
+            // of hardware threads is used instead
+            std::size_t nb_threads = 0;
+
+            parallel_runs_impl() = default;
+
+            constexpr explicit parallel_runs_impl(std::size_t nb_threads) noexcept:
+                nb_threads(nb_threads)
+            {}
+
+            template<
+                typename RandomAccessIterator,
+                typename Compare = std::less<>,
+                typename Projection = utility::identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, RandomAccessIterator, Compare>
+                >
+            >
+            auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                            Compare compare={}, Projection projection={}) const
+                -> cppsort::detail::difference_type_t<RandomAccessIterator>
+            {
+                static_assert(
+                    std::is_base_of<
+                        std::random_access_iterator_tag,
+                        cppsort::detail::iterator_category_t<RandomAccessIterator>
+                    >::value,
+                    "parallel_runs requires at least random-access iterators"
+                );
+                using difference_type = cppsort::detail::difference_type_t<RandomAccessIterator>;
+
+                auto size = last - first;
+                auto threads = cppsort::detail::parallel_probe_nb_threads(nb_threads, size);
+                if (threads <= 1) {
+                    return runs_impl{}(std::move(first), std::move(last),
+                                       std::move(compare), std::move(projection));
+                }
+
+                // Every chunk counts the step-downs between its
+                // elements and the ones right after them
+                cppsort::detail::task_pool pool(threads);
+                auto counts = cppsort::detail::parallel_map_chunks<difference_type>(pool, size - 1,
+                    [&](difference_type begin, difference_type end) {
+                        auto&& comp = utility::as_function(compare);
+                        auto&& proj = utility::as_function(projection);
+
+                        difference_type count = 0;
+                        for (auto it = first + begin ; it != first + end ; ++it) {
+                            count += comp(proj(it[1]), proj(*it));
+                        }
+                        return count;
+                    }
+                );
+
+                difference_type count = 0;
+                for (auto chunk_count: counts) {
+                    count += chunk_count;
+                }
+                return count;
+            }
+
+            template<typename Integer>
+            static constexpr auto max_for_size(Integer n)
+                -> Integer
+            {
+                return runs_impl::max_for_size(n);
+            }
+        };
+    }
+
+    struct parallel_runs_probe:
+        sorter_facade<detail::parallel_runs_impl>
+    {
+        parallel_runs_probe() = default;
+
+        constexpr explicit parallel_runs_probe(std::size_t nb_threads) noexcept:
+            sorter_facade<detail::parallel_runs_impl>(nb_threads)
+        {}
+    };
+
+    namespace
+    {
+        constexpr auto&& parallel_runs
+            = utility::static_const<parallel_runs_probe>::value;
+    }
+}}
+
+#endif // CPPSORT_PROBES_PARALLEL_RUNS_H_
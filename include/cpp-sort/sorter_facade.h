@@ -15,6 +15,7 @@
 #include <cpp-sort/refined.h>
 #include <cpp-sort/sorter_traits.h>
 #include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/sort_context.h>
 #include "detail/config.h"
 #include "detail/type_traits.h"
 
@@ -141,6 +142,17 @@ namespace cppsort
             Sorter(std::forward<Args>(args)...)
         {}
 
+        ////////////////////////////////////////////////////////////
+        // Sort context overload
+
+        template<typename... Args>
+        auto operator()(utility::sort_context& context, Args&&... args) const
+            -> decltype(std::declval<const sorter_facade&>()(std::forward<Args>(args)...))
+        {
+            utility::detail::memory_resource_guard guard(&context);
+            return (*this)(std::forward<Args>(args)...);
+        }
+
         ////////////////////////////////////////////////////////////
         // Non-comparison overloads
 
@@ -11,6 +11,8 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <new>
+#include "../detail/memory.h"
 
 namespace cppsort
 {
@@ -173,20 +175,49 @@ namespace utility
         // to reduce template bloat, notably by making sure that it isn't
         // instantiated for every different size policy
 
+        template<typename T>
+        struct dynamic_buffer_deleter
+        {
+            // Number of constructed elements to destroy
+            std::size_t size;
+            cppsort::detail::operator_deleter deallocate;
+
+            auto operator()(T* pointer) noexcept
+                -> void
+            {
+                for (std::size_t idx = 0 ; idx < size ; ++idx) {
+                    cppsort::detail::destroy_at(pointer + idx);
+                }
+                deallocate(pointer);
+            }
+        };
+
         template<typename T>
         class dynamic_buffer_impl
         {
             private:
 
                 std::size_t _size;
-                std::unique_ptr<T[]> _memory;
+                std::unique_ptr<T[], dynamic_buffer_deleter<T>> _memory;
 
             public:
 
                 explicit dynamic_buffer_impl(std::size_t size):
                     _size(size),
-                    _memory(std::make_unique<T[]>(_size))
-                {}
+                    _memory(
+                        static_cast<T*>(cppsort::detail::allocate_bytes(size * sizeof(T))),
+                        dynamic_buffer_deleter<T>{
+                            0,
+                            cppsort::detail::operator_deleter(size * sizeof(T))
+                        }
+                    )
+                {
+                    // Value-initialize the elements like std::make_unique
+                    for (std::size_t idx = 0 ; idx < size ; ++idx) {
+                        ::new (_memory.get() + idx) T();
+                        ++_memory.get_deleter().size;
+                    }
+                }
 
                 auto size() const
                     -> std::size_t
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_EXTERNAL_SORTER_H_
+#define CPPSORT_UTILITY_EXTERNAL_SORTER_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/utility/adapter_storage.h>
+#include <cpp-sort/utility/functional.h>
+#include "../detail/external_sort.h"
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // External sorter
+    //
+    // Sorts sequences that do not fit in memory: the elements
+    // are read from an input range by runs that fit in the given
+    // memory budget, each run is sorted with the wrapped sorter
+    // and spilled to a temporary file, then the runs are merged
+    // into the output. Reading and writing the temporary files
+    // is done by other threads while the sort goes on, with two
+    // buffers per run.
+    //
+    // The memory budget is a number of bytes, it does not take
+    // into account the memory used by the wrapped sorter itself.
+    // The temporary files are created in the given directory, or
+    // with std::tmpfile when no directory is given.
+    //
+
+    template<typename Sorter = pdq_sorter>
+    class external_sorter:
+        adapter_storage<Sorter>
+    {
+        public:
+
+            ////////////////////////////////////////////////////////////
+            // Construction
+
+            explicit external_sorter(std::size_t memory_budget, Sorter sorter={}):
+                adapter_storage<Sorter>(std::move(sorter)),
+                budget(memory_budget)
+            {}
+
+            external_sorter(std::size_t memory_budget, std::string temporary_directory,
+                            Sorter sorter={}):
+                adapter_storage<Sorter>(std::move(sorter)),
+                budget(memory_budget),
+                directory(std::move(temporary_directory))
+            {}
+
+            auto memory_budget() const noexcept
+                -> std::size_t
+            {
+                return budget;
+            }
+
+            auto temporary_directory() const noexcept
+                -> const std::string&
+            {
+                return directory;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Sort
+
+            template<
+                typename InputIterator,
+                typename OutputIterator,
+                typename Compare = std::less<>,
+                typename Projection = identity,
+                typename = std::enable_if_t<
+                    is_projection_iterator_v<Projection, InputIterator, Compare>
+                >
+            >
+            auto operator()(InputIterator first, InputIterator last, OutputIterator out,
+                            Compare compare={}, Projection projection={}) const
+                -> OutputIterator
+            {
+                return cppsort::detail::external_sort(std::move(first), std::move(last), std::move(out),
+                                                      budget, directory,
+                                                      std::move(compare), std::move(projection),
+                                                      this->get());
+            }
+
+            template<
+                typename Iterable,
+                typename OutputIterator,
+                typename Compare = std::less<>,
+                typename Projection = identity,
+                typename = std::enable_if_t<
+                    is_projection_v<Projection, Iterable, Compare>
+                >
+            >
+            auto operator()(Iterable&& iterable, OutputIterator out,
+                            Compare compare={}, Projection projection={}) const
+                -> OutputIterator
+            {
+                using std::begin;
+                using std::end;
+                return operator()(begin(iterable), end(iterable), std::move(out),
+                                  std::move(compare), std::move(projection));
+            }
+
+        private:
+
+            std::size_t budget;
+            std::string directory;
+    };
+}}
+
+#endif // CPPSORT_UTILITY_EXTERNAL_SORTER_H_
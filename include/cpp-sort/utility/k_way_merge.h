@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_K_WAY_MERGE_H_
+#define CPPSORT_UTILITY_K_WAY_MERGE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/buffer.h>
+#include <cpp-sort/utility/functional.h>
+#include "../detail/k_way_merge.h"
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Merge any number of sorted ranges
+    //
+    // The ranges are merged all at once with a loser tree, so
+    // every element costs about log2(k) comparisons where k is
+    // the number of ranges. The merge is stable: equivalent
+    // elements are taken from the ranges in order.
+
+    template<
+        typename Iterables,
+        typename OutputIterator,
+        typename Compare = std::less<>,
+        typename Projection = identity
+    >
+    auto k_way_merge(const Iterables& ranges, OutputIterator out,
+                     Compare compare={}, Projection projection={})
+        -> OutputIterator
+    {
+        using std::begin;
+        using std::end;
+        using iterator = decltype(begin(*begin(ranges)));
+
+        std::vector<std::pair<iterator, iterator>> sources;
+        for (auto&& range: ranges) {
+            sources.emplace_back(begin(range), end(range));
+        }
+
+        cppsort::detail::k_way_merge(sources, std::move(compare), std::move(projection),
+                                     [&out](iterator it) {
+                                         *out = *it;
+                                         ++out;
+                                     });
+        return out;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Merge consecutive sorted runs in place
+    //
+    // The runs are [first, middles[0]), [middles[0], middles[1]),
+    // ..., [middles[k-2], last), the elements are merged into a
+    // buffer provided by BufferProvider, then moved back. When
+    // the buffer can't hold all the elements, pairs of runs are
+    // merged with the buffer instead until one run is left.
+
+    template<
+        typename BufferProvider = dynamic_buffer<identity>,
+        typename RandomAccessIterator,
+        typename Iterable,
+        typename Compare = std::less<>,
+        typename Projection = identity
+    >
+    auto k_way_inplace_merge(RandomAccessIterator first, const Iterable& middles,
+                             RandomAccessIterator last,
+                             Compare compare={}, Projection projection={})
+        -> void
+    {
+        std::vector<RandomAccessIterator> bounds = { first };
+        for (auto&& middle: middles) {
+            bounds.push_back(middle);
+        }
+        bounds.push_back(last);
+
+        cppsort::detail::k_way_inplace_merge<BufferProvider>(
+            std::move(bounds), std::move(compare), std::move(projection)
+        );
+    }
+}}
+
+#endif // CPPSORT_UTILITY_K_WAY_MERGE_H_
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_MEMORY_RESOURCE_H_
+#define CPPSORT_UTILITY_MEMORY_RESOURCE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <new>
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Memory resource
+    //
+    // Abstract interface for the memory resources used by the
+    // library to allocate scratch memory, it mirrors the C++17
+    // std::pmr::memory_resource but is usable in C++14.
+    //
+
+    class memory_resource
+    {
+        public:
+
+            memory_resource() = default;
+            memory_resource(const memory_resource&) = default;
+            memory_resource& operator=(const memory_resource&) = default;
+            virtual ~memory_resource() = default;
+
+            auto allocate(std::size_t bytes, std::size_t alignment=alignof(std::max_align_t))
+                -> void*
+            {
+                return do_allocate(bytes, alignment);
+            }
+
+            auto deallocate(void* ptr, std::size_t bytes, std::size_t alignment=alignof(std::max_align_t))
+                -> void
+            {
+                do_deallocate(ptr, bytes, alignment);
+            }
+
+            auto is_equal(const memory_resource& other) const noexcept
+                -> bool
+            {
+                return do_is_equal(other);
+            }
+
+        private:
+
+            virtual auto do_allocate(std::size_t bytes, std::size_t alignment)
+                -> void*
+                = 0;
+
+            virtual auto do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+                -> void
+                = 0;
+
+            virtual auto do_is_equal(const memory_resource& other) const noexcept
+                -> bool
+                = 0;
+    };
+
+    inline auto operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+        -> bool
+    {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+    inline auto operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+        -> bool
+    {
+        return not (lhs == rhs);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Resource using the global operator new and operator delete
+
+    namespace detail
+    {
+        class new_delete_resource_impl final:
+            public memory_resource
+        {
+            private:
+
+                auto do_allocate(std::size_t bytes, std::size_t /* alignment */)
+                    -> void* override
+                {
+                    return ::operator new(bytes);
+                }
+
+                auto do_deallocate(void* ptr, std::size_t bytes, std::size_t /* alignment */)
+                    -> void override
+                {
+#ifdef __cpp_sized_deallocation
+                    ::operator delete(ptr, bytes);
+#else
+                    (void)bytes;
+                    ::operator delete(ptr);
+#endif
+                }
+
+                auto do_is_equal(const memory_resource& other) const noexcept
+                    -> bool override
+                {
+                    return this == &other;
+                }
+        };
+
+        // The resources are static data members of a class template
+        // rather than function-local statics: they are initialized
+        // at compile time, so accessing them doesn't involve guard
+        // variables, which keeps the functions below small enough
+        // to be inlined
+        template<typename=void>
+        struct memory_resources
+        {
+            static new_delete_resource_impl new_delete;
+            static thread_local memory_resource* current;
+        };
+
+        template<typename T>
+        new_delete_resource_impl memory_resources<T>::new_delete;
+
+        template<typename T>
+        thread_local memory_resource* memory_resources<T>::current = nullptr;
+    }
+
+    inline auto new_delete_resource() noexcept
+        -> memory_resource*
+    {
+        return &detail::memory_resources<>::new_delete;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Resource used by the current thread
+
+    inline auto get_memory_resource() noexcept
+        -> memory_resource*
+    {
+        auto resource = detail::memory_resources<>::current;
+        return resource ? resource : new_delete_resource();
+    }
+
+    inline auto set_memory_resource(memory_resource* resource) noexcept
+        -> memory_resource*
+    {
+        auto old_resource = get_memory_resource();
+        detail::memory_resources<>::current = resource;
+        return old_resource;
+    }
+
+    namespace detail
+    {
+        // Installs a memory resource for the current thread
+        // and restores the previous one on destruction
+        class memory_resource_guard
+        {
+            public:
+
+                explicit memory_resource_guard(memory_resource* resource) noexcept:
+                    old_resource(set_memory_resource(resource))
+                {}
+
+                memory_resource_guard(const memory_resource_guard&) = delete;
+                memory_resource_guard& operator=(const memory_resource_guard&) = delete;
+
+                ~memory_resource_guard()
+                {
+                    set_memory_resource(old_resource);
+                }
+
+            private:
+
+                memory_resource* old_resource;
+        };
+    }
+}}
+
+#endif // CPPSORT_UTILITY_MEMORY_RESOURCE_H_
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_SELECTION_H_
+#define CPPSORT_UTILITY_SELECTION_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cpp-sort/sorter_traits.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/utility/adapter_storage.h>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/utility/static_const.h>
+#include "../detail/adaptive_quickselect.h"
+#include "../detail/bitops.h"
+#include "../detail/introselect.h"
+#include "../detail/iterator_traits.h"
+#include "../detail/nth_element.h"
+#include "../detail/partial_sort.h"
+#include "../detail/type_traits.h"
+
+namespace cppsort
+{
+namespace detail
+{
+    ////////////////////////////////////////////////////////////
+    // Whether the selection utilities accept the given iterators
+    //
+    // Most sorters only check the category of the iterators with
+    // a static_assert, so the iterators must also belong to the
+    // iterator category of the sorter when it has one in order to
+    // get SFINAE-friendly selection utilities.
+
+    template<typename Sorter, typename Iterator, typename=void>
+    struct has_sorter_iterator_category:
+        std::true_type
+    {};
+
+    template<typename Sorter, typename Iterator>
+    struct has_sorter_iterator_category<Sorter, Iterator, void_t<cppsort::iterator_category<Sorter>>>:
+        std::is_base_of<cppsort::iterator_category<Sorter>, iterator_category_t<Iterator>>
+    {};
+
+    template<typename SelectAlgorithm, typename Iterator, typename Compare, typename Projection>
+    struct is_select_algorithm_iterator:
+        conjunction<
+            is_invocable<const SelectAlgorithm&, Iterator, Iterator,
+                         difference_type_t<Iterator>, difference_type_t<Iterator>,
+                         Compare, Projection>,
+            is_projection_iterator<Projection, Iterator, Compare>
+        >
+    {};
+
+    template<typename Sorter, typename SelectAlgorithm, typename Iterator,
+             typename Compare, typename Projection>
+    struct is_partial_sorter_iterator:
+        conjunction<
+            is_select_algorithm_iterator<SelectAlgorithm, Iterator, Compare, Projection>,
+            is_comparison_projection_sorter_iterator<const Sorter&, Iterator, Compare, Projection>,
+            has_sorter_iterator_category<Sorter, Iterator>
+        >
+    {};
+
+    // A projection passed without a comparator must not be a
+    // valid comparator itself
+    template<typename Iterator, typename Projection>
+    struct is_projection_only_iterator:
+        negation<is_projection_iterator<utility::identity, Iterator, Projection>>
+    {};
+}
+
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Selection algorithms
+    //
+    // Function objects with the same interface as the internal
+    // nth_element: they take the position of the element to
+    // select and the size of the range, and return an iterator
+    // to the selected element.
+
+    struct introselect_algorithm
+    {
+        template<typename ForwardIterator, typename Compare, typename Projection>
+        auto operator()(ForwardIterator first, ForwardIterator last,
+                        cppsort::detail::difference_type_t<ForwardIterator> nth_pos,
+                        cppsort::detail::difference_type_t<ForwardIterator> size,
+                        Compare compare, Projection projection) const
+            -> ForwardIterator
+        {
+            return cppsort::detail::introselect(first, last, nth_pos, size,
+                                                cppsort::detail::log2(size),
+                                                std::move(compare), std::move(projection));
+        }
+    };
+
+    struct adaptive_quickselect_algorithm
+    {
+        template<
+            typename RandomAccessIterator,
+            typename Compare,
+            typename Projection,
+            typename = std::enable_if_t<
+                std::is_base_of<
+                    std::random_access_iterator_tag,
+                    cppsort::detail::iterator_category_t<RandomAccessIterator>
+                >::value
+            >
+        >
+        auto operator()(RandomAccessIterator first, RandomAccessIterator last,
+                        cppsort::detail::difference_type_t<RandomAccessIterator> nth_pos,
+                        cppsort::detail::difference_type_t<RandomAccessIterator>, // unused
+                        Compare compare, Projection projection) const
+            -> RandomAccessIterator
+        {
+            return cppsort::detail::median_of_ninthers_select(first, first + nth_pos, last,
+                                                              std::move(compare), std::move(projection));
+        }
+    };
+
+    struct default_select_algorithm
+    {
+        template<typename ForwardIterator, typename Compare, typename Projection>
+        auto operator()(ForwardIterator first, ForwardIterator last,
+                        cppsort::detail::difference_type_t<ForwardIterator> nth_pos,
+                        cppsort::detail::difference_type_t<ForwardIterator> size,
+                        Compare compare, Projection projection) const
+            -> ForwardIterator
+        {
+            return cppsort::detail::nth_element(first, last, nth_pos, size,
+                                                std::move(compare), std::move(projection));
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // nth_element
+    //
+    // Reorders a collection so that the nth element is the one
+    // that would be there if the collection was sorted, with
+    // no element after it comparing less than an element
+    // before it, and returns an iterator to it.
+
+    template<typename SelectAlgorithm = default_select_algorithm>
+    struct nth_element_selector
+    {
+        template<
+            typename ForwardIterator,
+            typename Compare = std::less<>,
+            typename Projection = identity,
+            typename = std::enable_if_t<
+                cppsort::detail::is_select_algorithm_iterator<
+                    SelectAlgorithm, ForwardIterator, Compare, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterator first, ForwardIterator nth, ForwardIterator last,
+                        Compare compare={}, Projection projection={}) const
+            -> ForwardIterator
+        {
+            if (nth == last) return nth;
+            return SelectAlgorithm{}(first, last,
+                                     std::distance(first, nth), std::distance(first, last),
+                                     std::move(compare), std::move(projection));
+        }
+
+        template<
+            typename ForwardIterator,
+            typename Projection,
+            typename = std::enable_if_t<
+                cppsort::detail::is_projection_only_iterator<ForwardIterator, Projection>::value &&
+                cppsort::detail::is_select_algorithm_iterator<
+                    SelectAlgorithm, ForwardIterator, std::less<>, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterator first, ForwardIterator nth, ForwardIterator last,
+                        Projection projection) const
+            -> ForwardIterator
+        {
+            return operator()(std::move(first), std::move(nth), std::move(last),
+                              std::less<>{}, std::move(projection));
+        }
+
+        template<
+            typename ForwardIterable,
+            typename Compare = std::less<>,
+            typename Projection = identity,
+            typename Iterator = decltype(std::begin(std::declval<ForwardIterable&>())),
+            typename = std::enable_if_t<
+                cppsort::detail::is_select_algorithm_iterator<
+                    SelectAlgorithm, Iterator, Compare, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterable&& iterable,
+                        cppsort::detail::difference_type_t<Iterator> nth_pos,
+                        Compare compare={}, Projection projection={}) const
+            -> Iterator
+        {
+            auto first = std::begin(iterable);
+            auto last = std::end(iterable);
+            auto size = std::distance(first, last);
+            if (nth_pos >= size) return last;
+            return SelectAlgorithm{}(first, last, nth_pos, size,
+                                     std::move(compare), std::move(projection));
+        }
+
+        template<
+            typename ForwardIterable,
+            typename Projection,
+            typename Iterator = decltype(std::begin(std::declval<ForwardIterable&>())),
+            typename = std::enable_if_t<
+                cppsort::detail::is_projection_only_iterator<Iterator, Projection>::value &&
+                cppsort::detail::is_select_algorithm_iterator<
+                    SelectAlgorithm, Iterator, std::less<>, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterable&& iterable,
+                        cppsort::detail::difference_type_t<Iterator> nth_pos,
+                        Projection projection) const
+            -> Iterator
+        {
+            return operator()(std::forward<ForwardIterable>(iterable), nth_pos,
+                              std::less<>{}, std::move(projection));
+        }
+    };
+
+    ////////////////////////////////////////////////////////////
+    // partial_sort
+    //
+    // Sorts the k smallest elements of a collection and puts
+    // them at its beginning, the other elements are left in
+    // no particular order. The k smallest elements are first
+    // selected, then sorted with the given sorter, which is
+    // also the way to give a buffer provider to partial_sort.
+
+    template<
+        typename Sorter = pdq_sorter,
+        typename SelectAlgorithm = default_select_algorithm
+    >
+    struct partial_sorter:
+        adapter_storage<Sorter>
+    {
+        ////////////////////////////////////////////////////////////
+        // Construction
+
+        partial_sorter() = default;
+
+        constexpr explicit partial_sorter(Sorter sorter):
+            adapter_storage<Sorter>(std::move(sorter))
+        {}
+
+        ////////////////////////////////////////////////////////////
+        // Partial sort
+
+        template<
+            typename ForwardIterator,
+            typename Compare = std::less<>,
+            typename Projection = identity,
+            typename = std::enable_if_t<
+                cppsort::detail::is_partial_sorter_iterator<
+                    Sorter, SelectAlgorithm, ForwardIterator, Compare, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterator first, ForwardIterator middle, ForwardIterator last,
+                        Compare compare={}, Projection projection={}) const
+            -> void
+        {
+            cppsort::detail::partial_sort(first, middle, last,
+                                          std::distance(first, middle), std::distance(first, last),
+                                          std::move(compare), std::move(projection),
+                                          SelectAlgorithm{}, this->get());
+        }
+
+        template<
+            typename ForwardIterator,
+            typename Projection,
+            typename = std::enable_if_t<
+                cppsort::detail::is_projection_only_iterator<ForwardIterator, Projection>::value &&
+                cppsort::detail::is_partial_sorter_iterator<
+                    Sorter, SelectAlgorithm, ForwardIterator, std::less<>, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterator first, ForwardIterator middle, ForwardIterator last,
+                        Projection projection) const
+            -> void
+        {
+            operator()(std::move(first), std::move(middle), std::move(last),
+                       std::less<>{}, std::move(projection));
+        }
+
+        template<
+            typename ForwardIterable,
+            typename Compare = std::less<>,
+            typename Projection = identity,
+            typename Iterator = decltype(std::begin(std::declval<ForwardIterable&>())),
+            typename = std::enable_if_t<
+                cppsort::detail::is_partial_sorter_iterator<
+                    Sorter, SelectAlgorithm, Iterator, Compare, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterable&& iterable,
+                        cppsort::detail::difference_type_t<Iterator> k,
+                        Compare compare={}, Projection projection={}) const
+            -> void
+        {
+            auto first = std::begin(iterable);
+            auto last = std::end(iterable);
+            auto size = std::distance(first, last);
+            if (k > size) {
+                k = size;
+            }
+            cppsort::detail::partial_sort(first, std::next(first, k), last, k, size,
+                                          std::move(compare), std::move(projection),
+                                          SelectAlgorithm{}, this->get());
+        }
+
+        template<
+            typename ForwardIterable,
+            typename Projection,
+            typename Iterator = decltype(std::begin(std::declval<ForwardIterable&>())),
+            typename = std::enable_if_t<
+                cppsort::detail::is_projection_only_iterator<Iterator, Projection>::value &&
+                cppsort::detail::is_partial_sorter_iterator<
+                    Sorter, SelectAlgorithm, Iterator, std::less<>, Projection
+                >::value
+            >
+        >
+        auto operator()(ForwardIterable&& iterable,
+                        cppsort::detail::difference_type_t<Iterator> k,
+                        Projection projection) const
+            -> void
+        {
+            operator()(std::forward<ForwardIterable>(iterable), k,
+                       std::less<>{}, std::move(projection));
+        }
+    };
+
+    namespace
+    {
+        constexpr auto&& nth_element
+            = static_const<nth_element_selector<>>::value;
+
+        constexpr auto&& partial_sort
+            = static_const<partial_sorter<>>::value;
+    }
+}}
+
+#endif // CPPSORT_UTILITY_SELECTION_H_
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_SORT_APPENDED_H_
+#define CPPSORT_UTILITY_SORT_APPENDED_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include "../detail/inplace_merge.h"
+#include "../detail/iterator_traits.h"
+#include "../detail/upper_bound.h"
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Sort elements appended to a sorted collection
+    //
+    // [first, middle) is already sorted: only [middle, last)
+    // is sorted with the given sorter, then both parts are
+    // merged. The merge starts at the first element of the
+    // sorted part greater than the smallest new element, and
+    // it only needs a buffer as big as the smallest part.
+    //
+
+    template<
+        typename Sorter,
+        typename BidirectionalIterator,
+        typename Compare = std::less<>,
+        typename Projection = identity
+    >
+    auto sort_appended(Sorter&& sorter, BidirectionalIterator first,
+                       BidirectionalIterator middle, BidirectionalIterator last,
+                       Compare compare={}, Projection projection={})
+        -> void
+    {
+        if (middle == last) return;
+        std::forward<Sorter>(sorter)(middle, last, compare, projection);
+        if (first == middle) return;
+
+        auto&& comp = as_function(compare);
+        auto&& proj = as_function(projection);
+        if (not comp(proj(*middle), proj(*std::prev(middle)))) {
+            // The new elements already go after the old ones
+            return;
+        }
+
+        first = cppsort::detail::upper_bound(first, middle, proj(*middle), compare, projection);
+        cppsort::detail::inplace_merge(first, middle, last,
+                                       std::move(compare), std::move(projection),
+                                       std::distance(first, middle),
+                                       std::distance(middle, last));
+    }
+
+    template<
+        typename Sorter,
+        typename BidirectionalIterable,
+        typename Compare = std::less<>,
+        typename Projection = identity,
+        typename Iterator = decltype(std::begin(std::declval<BidirectionalIterable&>()))
+    >
+    auto sort_appended(Sorter&& sorter, BidirectionalIterable&& iterable,
+                       cppsort::detail::difference_type_t<Iterator> sorted_size,
+                       Compare compare={}, Projection projection={})
+        -> void
+    {
+        auto first = std::begin(iterable);
+        sort_appended(std::forward<Sorter>(sorter),
+                      first, std::next(first, sorted_size), std::end(iterable),
+                      std::move(compare), std::move(projection));
+    }
+}}
+
+#endif // CPPSORT_UTILITY_SORT_APPENDED_H_
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_SORT_CONTEXT_H_
+#define CPPSORT_UTILITY_SORT_CONTEXT_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <cpp-sort/utility/memory_resource.h>
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Sort context
+    //
+    // Memory resource which keeps the blocks it hands out once
+    // they are deallocated, and reuses them for the subsequent
+    // allocations instead of asking its upstream resource for
+    // new memory. It is meant to be passed to sorters that are
+    // repeatedly called on collections of similar sizes so that
+    // their scratch memory stays allocated and hot between calls.
+    //
+    // The total size of the cached blocks is capped: the blocks
+    // cached the longest ago are given back to the upstream resource
+    // to make room for the ones being deallocated. A cached block is
+    // only reused for a request at least half its size. Once every
+    // block is deallocated - typically at the end of a sort - the
+    // cached blocks smaller than every request made in the meantime
+    // are given back: the collections to sort grew, and such blocks
+    // are unlikely to be reused. Everything else is given back when
+    // release() is called or when the context is destroyed.
+    //
+    // A sort_context is not thread-safe, and it must outlive
+    // the sorts that use it.
+    //
+
+    class sort_context final:
+        public memory_resource
+    {
+        public:
+
+            ////////////////////////////////////////////////////////////
+            // Construction & destruction
+
+            sort_context() = default;
+
+            explicit sort_context(memory_resource* upstream) noexcept:
+                upstream(upstream)
+            {}
+
+            sort_context(memory_resource* upstream, std::size_t max_cached_bytes) noexcept:
+                upstream(upstream),
+                max_cached(max_cached_bytes)
+            {}
+
+            sort_context(const sort_context&) = delete;
+            sort_context& operator=(const sort_context&) = delete;
+
+            ~sort_context()
+            {
+                release();
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Cache management
+
+            auto upstream_resource() const noexcept
+                -> memory_resource*
+            {
+                return upstream;
+            }
+
+            auto max_cached_bytes() const noexcept
+                -> std::size_t
+            {
+                return max_cached;
+            }
+
+            auto cached_bytes() const noexcept
+                -> std::size_t
+            {
+                return cached;
+            }
+
+            auto release() noexcept
+                -> void
+            {
+                while (free_blocks != nullptr) {
+                    auto block = free_blocks;
+                    free_blocks = block->next;
+                    deallocate_block(block);
+                }
+                cached = 0;
+            }
+
+        private:
+
+            ////////////////////////////////////////////////////////////
+            // Block header, stored right before the memory handed out
+
+            struct block_header
+            {
+                block_header* next;
+                // Usable size of the block
+                std::size_t size;
+                // Alignment of the block and offset of the usable
+                // memory from the beginning of the upstream block
+                std::size_t alignment;
+                std::size_t offset;
+            };
+
+            static auto header_of(void* ptr) noexcept
+                -> block_header*
+            {
+                return static_cast<block_header*>(ptr) - 1;
+            }
+
+            auto deallocate_block(block_header* block) noexcept
+                -> void
+            {
+                auto base = reinterpret_cast<unsigned char*>(block + 1) - block->offset;
+                upstream->deallocate(base, block->offset + block->size, block->alignment);
+            }
+
+            // Remove a block from the cache, ptr is the link to it
+            auto uncache_block(block_header** ptr) noexcept
+                -> block_header*
+            {
+                auto block = *ptr;
+                *ptr = block->next;
+                cached -= block->size;
+                return block;
+            }
+
+            // Called when no block is in use anymore: give back the
+            // blocks too small for every request made in the meantime
+            auto trim_small_blocks() noexcept
+                -> void
+            {
+                for (auto ptr = &free_blocks ; *ptr != nullptr ; ) {
+                    if ((*ptr)->size < min_requested) {
+                        deallocate_block(uncache_block(ptr));
+                    } else {
+                        ptr = &(*ptr)->next;
+                    }
+                }
+                min_requested = (std::numeric_limits<std::size_t>::max)();
+            }
+
+            ////////////////////////////////////////////////////////////
+            // memory_resource interface
+
+            auto do_allocate(std::size_t bytes, std::size_t alignment)
+                -> void* override
+            {
+                if (bytes < min_requested) {
+                    min_requested = bytes;
+                }
+
+                // Reuse the smallest cached block suitable for the request,
+                // blocks more than twice as big are kept for bigger ones
+                block_header** best = nullptr;
+                for (auto ptr = &free_blocks ; *ptr != nullptr ; ptr = &(*ptr)->next) {
+                    auto block = *ptr;
+                    if (block->size >= bytes && block->size / 2 <= bytes &&
+                        block->alignment >= alignment) {
+                        if (best == nullptr || block->size < (*best)->size) {
+                            best = ptr;
+                        }
+                    }
+                }
+
+                if (best != nullptr) {
+                    ++nb_used;
+                    return uncache_block(best) + 1;
+                }
+
+                // Allocate a new block with some slack so that it can
+                // be reused when sorting slightly bigger collections
+                if (alignment < alignof(block_header)) {
+                    alignment = alignof(block_header);
+                }
+                auto offset = (sizeof(block_header) + alignment - 1) / alignment * alignment;
+                auto size = bytes + bytes / 4;
+
+                auto base = static_cast<unsigned char*>(upstream->allocate(offset + size, alignment));
+                ::new (base + offset - sizeof(block_header)) block_header{nullptr, size, alignment, offset};
+                ++nb_used;
+                return base + offset;
+            }
+
+            auto do_deallocate(void* ptr, std::size_t /* bytes */, std::size_t /* alignment */)
+                -> void override
+            {
+                auto block = header_of(ptr);
+                if (block->size > max_cached) {
+                    deallocate_block(block);
+                } else {
+                    // Make room for the block, the blocks at the end
+                    // of the list are the ones cached the longest ago
+                    while (cached + block->size > max_cached) {
+                        auto ptr_last = &free_blocks;
+                        while ((*ptr_last)->next != nullptr) {
+                            ptr_last = &(*ptr_last)->next;
+                        }
+                        deallocate_block(uncache_block(ptr_last));
+                    }
+                    block->next = free_blocks;
+                    free_blocks = block;
+                    cached += block->size;
+                }
+
+                if (--nb_used == 0) {
+                    trim_small_blocks();
+                }
+            }
+
+            auto do_is_equal(const memory_resource& other) const noexcept
+                -> bool override
+            {
+                return this == &other;
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Data members
+
+            memory_resource* upstream = new_delete_resource();
+            block_header* free_blocks = nullptr;
+            // Total size of the cached blocks and its maximum
+            std::size_t cached = 0;
+            std::size_t max_cached = 64 * 1024 * 1024;
+            // Number of blocks in use, and size of the smallest request
+            // made since the last time no block was in use
+            std::size_t nb_used = 0;
+            std::size_t min_requested = (std::numeric_limits<std::size_t>::max)();
+    };
+}}
+
+#endif // CPPSORT_UTILITY_SORT_CONTEXT_H_
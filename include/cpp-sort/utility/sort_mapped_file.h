@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_SORT_MAPPED_FILE_H_
+#define CPPSORT_UTILITY_SORT_MAPPED_FILE_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "../detail/config.h"
+
+#if CPPSORT_MMAP_AVAILABLE
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <sys/mman.h>
+#include <cpp-sort/adapters/hybrid_adapter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/sorters/ska_sorter.h>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include "../detail/mapped_records.h"
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Sort a file of fixed-size records in place
+    //
+    // The file is mapped in memory and its records are sorted
+    // directly in the mapping, which avoids reading the whole
+    // file into a buffer and writing it back afterwards. The
+    // records are first read sequentially to check whether
+    // they are already sorted, in which case no page is ever
+    // written, then sorted with the given sorter.
+    //
+    // When no sorter is given, ska_sorter is used when it can
+    // handle the comparison and projection, and pdq_sorter is
+    // used otherwise: both sort in place without allocating
+    // memory proportional to the size of the file.
+    //
+
+    template<
+        typename Record,
+        typename Sorter,
+        typename Compare = std::less<>,
+        typename Projection = identity
+    >
+    auto sort_mapped_file(Sorter&& sorter, const char* path,
+                          Compare compare={}, Projection projection={})
+        -> void
+    {
+        cppsort::detail::mapped_records<Record> records(path);
+        if (records.size() < 2) {
+            return;
+        }
+
+        // Read the whole file ahead while checking whether it
+        // is already sorted
+        records.advise(POSIX_MADV_SEQUENTIAL);
+        records.advise(POSIX_MADV_WILLNEED);
+        auto&& comp = as_function(compare);
+        auto&& proj = as_function(projection);
+        auto sorted = std::is_sorted(records.begin(), records.end(),
+                                     [&](const Record& lhs, const Record& rhs) {
+                                         return comp(proj(lhs), proj(rhs));
+                                     });
+        if (sorted) {
+            return;
+        }
+
+        // Sorting algorithms access the records in no
+        // particular order
+        records.advise(POSIX_MADV_RANDOM);
+        std::forward<Sorter>(sorter)(records.begin(), records.end(),
+                                     std::move(compare), std::move(projection));
+    }
+
+    template<
+        typename Record,
+        typename Compare = std::less<>,
+        typename Projection = identity
+    >
+    auto sort_mapped_file(const char* path, Compare compare={}, Projection projection={})
+        -> void
+    {
+        sort_mapped_file<Record>(hybrid_adapter<ska_sorter, pdq_sorter>{}, path,
+                                 std::move(compare), std::move(projection));
+    }
+}}
+
+#endif // CPPSORT_MMAP_AVAILABLE
+
+#endif // CPPSORT_UTILITY_SORT_MAPPED_FILE_H_
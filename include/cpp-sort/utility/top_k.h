@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef CPPSORT_UTILITY_TOP_K_H_
+#define CPPSORT_UTILITY_TOP_K_H_
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cpp-sort/utility/as_function.h>
+#include <cpp-sort/utility/functional.h>
+#include "../detail/heapsort.h"
+#include "../detail/iterator_traits.h"
+
+namespace cppsort
+{
+namespace utility
+{
+    ////////////////////////////////////////////////////////////
+    // Top-k collector
+    //
+    // Keeps the k smallest elements pushed into it according to
+    // the given comparator and projection, in a max-heap of at
+    // most k elements: the root is the biggest element kept so
+    // far, so any element that doesn't compare less than it is
+    // rejected with a single comparison. The memory used never
+    // exceeds k elements no matter how many elements are pushed.
+    //
+
+    template<
+        typename T,
+        typename Compare = std::less<>,
+        typename Projection = identity
+    >
+    class top_k_collector
+    {
+        public:
+
+            ////////////////////////////////////////////////////////////
+            // Construction
+
+            explicit top_k_collector(std::size_t k, Compare compare={},
+                                     Projection projection={}):
+                k(k),
+                compare(std::move(compare)),
+                projection(std::move(projection))
+            {
+                heap.reserve(k);
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Element insertion
+
+            auto push(const T& value)
+                -> void
+            {
+                emplace(value);
+            }
+
+            auto push(T&& value)
+                -> void
+            {
+                emplace(std::move(value));
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Accessors
+
+            auto capacity() const noexcept
+                -> std::size_t
+            {
+                return k;
+            }
+
+            auto size() const noexcept
+                -> std::size_t
+            {
+                return heap.size();
+            }
+
+            auto empty() const noexcept
+                -> bool
+            {
+                return heap.empty();
+            }
+
+            ////////////////////////////////////////////////////////////
+            // Result extraction
+
+            auto extract_sorted()
+                -> std::vector<T>
+            {
+                // The elements already form a heap, only the second
+                // half of heapsort is needed to sort them
+                cppsort::detail::sort_heap(heap.begin(), heap.end(), compare, projection);
+                auto res = std::move(heap);
+                heap.clear();
+                heap.reserve(k);
+                return res;
+            }
+
+        private:
+
+            template<typename U>
+            auto emplace(U&& value)
+                -> void
+            {
+                using difference_type = cppsort::detail::difference_type_t<
+                    typename std::vector<T>::iterator
+                >;
+
+                if (heap.size() < k) {
+                    heap.push_back(std::forward<U>(value));
+                    cppsort::detail::push_heap(heap.begin(), heap.end(), compare, projection,
+                                               static_cast<difference_type>(heap.size()));
+                    return;
+                }
+
+                auto&& comp = as_function(compare);
+                auto&& proj = as_function(projection);
+                if (k == 0 || not comp(proj(value), proj(heap.front()))) {
+                    return;
+                }
+
+                // Replace the biggest element and restore the heap
+                heap.front() = std::forward<U>(value);
+                cppsort::detail::sift_down<Compare>(heap.begin(), heap.end(), compare, projection,
+                                                    static_cast<difference_type>(heap.size()),
+                                                    heap.begin());
+            }
+
+            std::size_t k;
+            Compare compare;
+            Projection projection;
+            std::vector<T> heap;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Top-k of an input range
+    //
+    // Reads [first, last) once and writes its k smallest elements
+    // in sorted order to out, without storing more than k elements
+    // at once.
+    //
+
+    template<
+        typename InputIterator,
+        typename OutputIterator,
+        typename Compare = std::less<>,
+        typename Projection = identity
+    >
+    auto top_k(InputIterator first, InputIterator last, std::size_t k,
+               OutputIterator out, Compare compare={}, Projection projection={})
+        -> OutputIterator
+    {
+        top_k_collector<cppsort::detail::value_type_t<InputIterator>, Compare, Projection>
+            collector(k, std::move(compare), std::move(projection));
+        for (; first != last ; ++first) {
+            collector.push(*first);
+        }
+
+        auto res = collector.extract_sorted();
+        return std::move(res.begin(), res.end(), out);
+    }
+}}
+
+#endif // CPPSORT_UTILITY_TOP_K_H_
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/indirect_adapter.h>
+#include <cpp-sort/adapters/memory_resource_adapter.h>
+#include <cpp-sort/adapters/schwartz_adapter.h>
+#include <cpp-sort/probes/inv.h>
+#include <cpp-sort/sorters/cartesian_tree_sorter.h>
+#include <cpp-sort/sorters/drop_merge_sorter.h>
+#include <cpp-sort/sorters/merge_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/sorters/spin_sorter.h>
+#include <cpp-sort/sorters/tim_sorter.h>
+#include <cpp-sort/utility/memory_resource.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    // Memory resource counting the allocations and deallocations
+    class counting_resource final:
+        public cppsort::utility::memory_resource
+    {
+        public:
+
+            std::size_t nb_allocations = 0;
+            std::size_t nb_deallocations = 0;
+            std::size_t bytes_in_use = 0;
+
+        private:
+
+            auto do_allocate(std::size_t bytes, std::size_t alignment)
+                -> void* override
+            {
+                ++nb_allocations;
+                bytes_in_use += bytes;
+                return cppsort::utility::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            auto do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+                -> void override
+            {
+                ++nb_deallocations;
+                bytes_in_use -= bytes;
+                cppsort::utility::new_delete_resource()->deallocate(ptr, bytes, alignment);
+            }
+
+            auto do_is_equal(const cppsort::utility::memory_resource& other) const noexcept
+                -> bool override
+            {
+                return this == &other;
+            }
+    };
+}
+
+TEMPLATE_TEST_CASE( "memory_resource_adapter with buffered sorters", "[memory_resource_adapter]",
+                    cppsort::cartesian_tree_sorter,
+                    cppsort::drop_merge_sorter,
+                    cppsort::indirect_adapter<cppsort::pdq_sorter>,
+                    cppsort::merge_sorter,
+                    cppsort::schwartz_adapter<cppsort::pdq_sorter>,
+                    cppsort::spin_sorter,
+                    cppsort::tim_sorter )
+{
+    std::vector<int> collection; collection.reserve(491);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 491, -125);
+
+    counting_resource resource;
+    cppsort::memory_resource_adapter<TestType> sorter(&resource);
+    sorter(collection, std::negate<>{});
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+
+    CHECK( resource.nb_allocations > 0 );
+    CHECK( resource.nb_allocations == resource.nb_deallocations );
+    CHECK( resource.bytes_in_use == 0 );
+    // The previous resource is restored after the call
+    CHECK( cppsort::utility::get_memory_resource() == cppsort::utility::new_delete_resource() );
+}
+
+TEST_CASE( "memory_resource_adapter with bidirectional iterators", "[memory_resource_adapter]" )
+{
+    std::list<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 491, -125);
+
+    counting_resource resource;
+    cppsort::memory_resource_adapter<cppsort::merge_sorter> sorter(&resource);
+    sorter(collection);
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    CHECK( resource.nb_allocations > 0 );
+    CHECK( resource.bytes_in_use == 0 );
+}
+
+TEST_CASE( "set the memory resource of the current thread", "[memory_resource_adapter]" )
+{
+    using namespace cppsort::utility;
+
+    std::vector<int> collection; collection.reserve(491);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 491, -125);
+
+    counting_resource resource;
+    CHECK( get_memory_resource() == new_delete_resource() );
+    auto old_resource = set_memory_resource(&resource);
+    CHECK( old_resource == new_delete_resource() );
+    CHECK( get_memory_resource() == &resource );
+
+    auto inversions = cppsort::probe::inv(collection);
+    CHECK( resource.nb_allocations > 0 );
+    CHECK( resource.bytes_in_use == 0 );
+
+    set_memory_resource(nullptr);
+    CHECK( get_memory_resource() == new_delete_resource() );
+
+    // Same result with the global heap
+    CHECK( cppsort::probe::inv(collection) == inversions );
+}
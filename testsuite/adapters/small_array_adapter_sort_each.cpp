@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/small_array_adapter.h>
+#include <cpp-sort/fixed/low_moves_sorter.h>
+#include <cpp-sort/fixed/sorting_network_sorter.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    using network_sizes = std::index_sequence<0, 1, 2, 3, 5, 8, 13, 16, 21, 29, 32>;
+
+    // Fills a collection of arrays with random values, sorts it
+    // with sort_each and checks that every array is sorted
+    template<typename T, std::size_t N, typename Sorter, typename... Args>
+    auto check_sort_each(Sorter sorter, std::size_t nb_arrays, Args... args)
+        -> void
+    {
+        std::vector<T> values;
+        auto size = static_cast<long long int>(nb_arrays * N);
+        dist::shuffled{}(std::back_inserter(values), size, -size / 2);
+
+        std::vector<std::array<T, N>> arrays(nb_arrays);
+        for (std::size_t i = 0 ; i < nb_arrays ; ++i) {
+            std::copy_n(values.begin() + i * N, N, arrays[i].begin());
+        }
+
+        auto expected = arrays;
+        for (auto& array: expected) {
+            std::sort(array.begin(), array.end(), args...);
+        }
+
+        sorter.sort_each(arrays, args...);
+        CHECK( arrays == expected );
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Values for which the order of the parameters of min and max
+    // matters, the vectorized compare-exchanges must give exactly
+    // the same results as the scalar ones
+
+    template<typename T>
+    auto special_values(std::false_type /* floating point */)
+        -> std::vector<T>
+    {
+        using limits = std::numeric_limits<T>;
+        return { limits::min(), T(limits::min() + 1), T(-1), T(0), T(1), T(limits::max() - 1), limits::max() };
+    }
+
+    template<typename T>
+    auto special_values(std::true_type /* floating point */)
+        -> std::vector<T>
+    {
+        using limits = std::numeric_limits<T>;
+        return {
+            -limits::infinity(), limits::lowest(), T(-1.5), T(-0.0), T(0.0),
+            limits::denorm_min(), T(1.5), limits::max(), limits::infinity(),
+            limits::quiet_NaN(), -limits::quiet_NaN()
+        };
+    }
+
+    template<typename T>
+    auto same_bits(const T* lhs, const T* rhs, std::size_t size)
+        -> bool
+    {
+        return std::memcmp(lhs, rhs, size * sizeof(T)) == 0;
+    }
+
+    // Sorts full and padded blocks of arrays with the vectorized
+    // networks, every array must be identical to the result of the
+    // scalar network, sizes which have a vectorized network of their
+    // own for a single array are avoided
+    template<typename T, std::size_t N, typename Compare>
+    auto check_special_arrays(Compare compare)
+        -> void
+    {
+        auto values = special_values<T>(std::is_floating_point<T>{});
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<std::size_t> dist(0, values.size() - 1);
+
+        // Two blocks of the widest vectors and a few more arrays
+        std::vector<std::array<T, N>> arrays(19);
+        for (auto& array: arrays) {
+            for (auto& value: array) {
+                value = values[dist(engine)];
+            }
+        }
+
+        auto expected = arrays;
+        for (auto& array: expected) {
+            cppsort::sorting_network_sorter<N>{}(array.data(), array.data() + N, compare);
+        }
+
+        cppsort::small_array_adapter<cppsort::sorting_network_sorter> sorter;
+        sorter.sort_each(arrays, compare);
+        for (std::size_t i = 0 ; i < arrays.size() ; ++i) {
+            CHECK( same_bits(arrays[i].data(), expected[i].data(), N) );
+        }
+    }
+
+    template<typename T, typename Compare>
+    auto check_special_values(Compare compare)
+        -> void
+    {
+        check_special_arrays<T, 3>(compare);
+        check_special_arrays<T, 8>(compare);
+        check_special_arrays<T, 13>(compare);
+    }
+
+    template<typename T, typename... Args, std::size_t... Indices>
+    auto check_network_sizes(std::index_sequence<Indices...>, Args... args)
+        -> void
+    {
+        cppsort::small_array_adapter<cppsort::sorting_network_sorter> sorter;
+        for (std::size_t nb_arrays: { 0, 1, 3, 17, 100 }) {
+            (void) std::initializer_list<int>{
+                (check_sort_each<T, Indices>(sorter, nb_arrays, args...), 0)...
+            };
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE( "small_array_adapter::sort_each with sorting_network_sorter",
+                    "[small_array_adapter]",
+                    std::int32_t, std::int64_t, std::int16_t, float, double )
+{
+    SECTION( "ascending order" )
+    {
+        check_network_sizes<TestType>(network_sizes{});
+    }
+
+    SECTION( "descending order" )
+    {
+        check_network_sizes<TestType>(network_sizes{}, std::greater<>{});
+    }
+}
+
+TEMPLATE_TEST_CASE( "small_array_adapter::sort_each with NaN and signed zeros",
+                    "[small_array_adapter]",
+                    std::int32_t, std::int64_t, float, double )
+{
+    SECTION( "ascending order" )
+    {
+        check_special_values<TestType>(std::less<>{});
+    }
+
+    SECTION( "descending order" )
+    {
+        check_special_values<TestType>(std::greater<>{});
+    }
+}
+
+TEST_CASE( "small_array_adapter::sort_each with other sorters",
+           "[small_array_adapter]" )
+{
+    SECTION( "projection" )
+    {
+        cppsort::small_array_adapter<cppsort::sorting_network_sorter> sorter;
+        std::vector<std::array<int, 16>> arrays(50);
+        std::mt19937 engine(Catch::rngSeed());
+        for (auto& array: arrays) {
+            std::iota(array.begin(), array.end(), 0);
+            std::shuffle(array.begin(), array.end(), engine);
+        }
+
+        sorter.sort_each(arrays.begin(), arrays.end(), std::negate<>{});
+        for (auto& array: arrays) {
+            CHECK( std::is_sorted(array.begin(), array.end(), std::greater<>{}) );
+        }
+    }
+
+    SECTION( "fixed-size sorter without batched algorithm" )
+    {
+        cppsort::small_array_adapter<cppsort::low_moves_sorter> sorter;
+        check_sort_each<int, 10>(sorter, 30);
+        check_sort_each<int, 10>(sorter, 30, std::greater<>{});
+    }
+}
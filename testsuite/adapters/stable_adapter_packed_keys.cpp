@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/stable_adapter.h>
+#include <cpp-sort/sorters/heap_sorter.h>
+#include <cpp-sort/sorters/lsd_radix_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/sorters/ska_sorter.h>
+#include <testing-tools/wrapper.h>
+
+namespace
+{
+    // Sorts wrappers whose values have few distinct keys and
+    // compares the result to that of std::stable_sort, the
+    // order field of the wrappers holds their original position
+    template<typename T, typename Sorter, typename Compare, typename MakeValue>
+    auto check_stable_sort(Sorter sorter, Compare compare, MakeValue make_value)
+        -> void
+    {
+        using wrapper = generic_stable_wrapper<T>;
+
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<int> dist(-20, 20);
+
+        std::vector<wrapper> collection;
+        for (int i = 0 ; i < 1000 ; ++i) {
+            wrapper elem = make_value(dist(engine));
+            elem.order = i;
+            collection.push_back(elem);
+        }
+
+        auto expected = collection;
+        std::stable_sort(expected.begin(), expected.end(), [&](const wrapper& lhs, const wrapper& rhs) {
+            return compare(lhs.value, rhs.value);
+        });
+
+        cppsort::stable_adapter<Sorter> stable_sorter(sorter);
+        stable_sorter(collection, compare, &wrapper::value);
+        CHECK( collection == expected );
+    }
+
+    template<typename T, typename Sorter, typename MakeValue>
+    auto check_both_orders(Sorter sorter, MakeValue make_value)
+        -> void
+    {
+        check_stable_sort<T>(sorter, std::less<>{}, make_value);
+        check_stable_sort<T>(sorter, std::greater<>{}, make_value);
+    }
+}
+
+TEMPLATE_TEST_CASE( "stable_adapter with keys packed with their positions", "[stable_adapter]",
+                    cppsort::heap_sorter,
+                    cppsort::pdq_sorter )
+{
+    auto to = [](auto tag) {
+        return [](int value) { return static_cast<decltype(tag)>(value); };
+    };
+
+    SECTION( "integers" )
+    {
+        check_both_orders<int>(TestType{}, to(int{}));
+        check_both_orders<std::int16_t>(TestType{}, to(std::int16_t{}));
+        check_both_orders<std::int8_t>(TestType{}, to(std::int8_t{}));
+        check_both_orders<char>(TestType{}, to(char{}));
+        check_both_orders<unsigned>(TestType{}, [](int value) {
+            // Make sure that the highest bit is used
+            return static_cast<unsigned>(value) * 0x08000000u;
+        });
+        check_both_orders<bool>(TestType{}, [](int value) { return value > 0; });
+    }
+
+    SECTION( "floating point numbers" )
+    {
+        check_both_orders<float>(TestType{}, [](int value) {
+            return static_cast<float>(value) / 4.0f;
+        });
+    }
+
+    SECTION( "signed zeros are equivalent" )
+    {
+        check_both_orders<float>(TestType{}, [](int value) {
+            return (value % 2 == 0) ? 0.0f : -0.0f;
+        });
+    }
+}
+
+TEMPLATE_TEST_CASE( "stable_adapter with keys that can't be packed", "[stable_adapter]",
+                    cppsort::heap_sorter,
+                    cppsort::pdq_sorter )
+{
+    SECTION( "64-bit keys" )
+    {
+        check_both_orders<double>(TestType{}, [](int value) {
+            return static_cast<double>(value) / 4.0;
+        });
+        check_both_orders<long long int>(TestType{}, [](int value) {
+            return static_cast<long long int>(value) * (1LL << 40);
+        });
+    }
+
+    SECTION( "strings compared in three ways" )
+    {
+        check_both_orders<std::string>(TestType{}, [](int value) {
+            return std::to_string(value);
+        });
+    }
+
+    SECTION( "custom comparator" )
+    {
+        auto compare = [](int lhs, int rhs) { return lhs / 3 < rhs / 3; };
+        check_stable_sort<int>(TestType{}, compare, [](int value) { return value; });
+    }
+}
+
+TEMPLATE_TEST_CASE( "stable_adapter with sorters that don't take a comparator", "[stable_adapter]",
+                    cppsort::lsd_radix_sorter<>,
+                    cppsort::ska_sorter )
+{
+    // lsd_radix_sorter is always stable and only sorts in
+    // ascending order, stable_adapter passes through it
+    SECTION( "integers" )
+    {
+        check_stable_sort<int>(TestType{}, std::less<>{}, [](int value) { return value; });
+        check_stable_sort<unsigned>(TestType{}, std::less<>{}, [](int value) {
+            return static_cast<unsigned>(value) * 0x08000000u;
+        });
+    }
+
+    SECTION( "without projection" )
+    {
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<int> dist(-20, 20);
+        std::vector<int> collection;
+        for (int i = 0 ; i < 1000 ; ++i) {
+            collection.push_back(dist(engine));
+        }
+
+        cppsort::stable_adapter<TestType>{}(collection);
+        CHECK( std::is_sorted(collection.begin(), collection.end()) );
+    }
+}
+
+TEMPLATE_TEST_CASE( "stable_adapter projects packed keys only once", "[stable_adapter]",
+                    cppsort::heap_sorter,
+                    cppsort::pdq_sorter,
+                    cppsort::ska_sorter )
+{
+    using wrapper = generic_stable_wrapper<int>;
+
+    std::mt19937 engine(Catch::rngSeed());
+    std::uniform_int_distribution<int> dist(-20, 20);
+    std::vector<wrapper> collection;
+    for (int i = 0 ; i < 1000 ; ++i) {
+        wrapper elem;
+        elem.value = dist(engine);
+        elem.order = i;
+        collection.push_back(elem);
+    }
+
+    // The projection is only called when packing the keys:
+    // any other call means that the associate iterators
+    // fallback was used instead
+    std::size_t count = 0;
+    auto projection = [&count](const wrapper& elem) {
+        ++count;
+        return elem.value;
+    };
+
+    auto expected = collection;
+    std::stable_sort(expected.begin(), expected.end(), [](const wrapper& lhs, const wrapper& rhs) {
+        return lhs.value > rhs.value;
+    });
+
+    cppsort::stable_adapter<TestType>{}(collection, std::greater<>{}, projection);
+    CHECK( collection == expected );
+    CHECK( count == collection.size() );
+}
@@ -1,14 +1,22 @@
 /*
- * Copyright (c) 2016-2020 Morwenn
+ * Copyright (c) 2016-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <list>
 #include <locale>
+#include <random>
 #include <string>
+#include <vector>
 #include <catch2/catch.hpp>
+#include <cpp-sort/adapters/schwartz_adapter.h>
 #include <cpp-sort/comparators/case_insensitive_less.h>
 #include <cpp-sort/refined.h>
 #include <cpp-sort/sorters/heap_sorter.h>
+#include <cpp-sort/sorters/ska_sorter.h>
+#include <cpp-sort/sorters/spread_sorter.h>
 
 namespace sub
 {
@@ -33,6 +41,31 @@ namespace sub
     }
 }
 
+namespace
+{
+    template<typename CharT>
+    auto random_strings(std::size_t size, const std::basic_string<CharT>& alphabet)
+        -> std::vector<std::basic_string<CharT>>
+    {
+        // Strings are long enough to be compared in several
+        // blocks of characters by ascii_case_insensitive_less
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<std::size_t> length_dist(0, 40);
+        std::uniform_int_distribution<std::size_t> char_dist(0, alphabet.size() - 1);
+
+        std::vector<std::basic_string<CharT>> res;
+        for (std::size_t i = 0 ; i < size ; ++i) {
+            // Common prefixes make comparisons longer
+            std::basic_string<CharT> str(i % 3 * 10, alphabet[0]);
+            for (auto length = length_dist(engine) ; length > 0 ; --length) {
+                str.push_back(alphabet[char_dist(engine)]);
+            }
+            res.push_back(str);
+        }
+        return res;
+    }
+}
+
 TEST_CASE( "case-insensitive string comparison with case_insensitive_less" )
 {
     std::array<std::string, 9> array = {
@@ -95,3 +128,90 @@ TEST_CASE( "case-insensitive string comparison with case_insensitive_less" )
     }
 }
 
+
+TEST_CASE( "case_insensitive_sort_key gives the same order as case_insensitive_less",
+           "[case_insensitive_sort_key]" )
+{
+    auto classic = std::locale::classic();
+
+    SECTION( "char" )
+    {
+        auto strings = random_strings<char>(200, "aAbBzZ@[`{09 \x80\xff");
+        auto key = cppsort::case_insensitive_sort_key(classic);
+        auto compare = cppsort::case_insensitive_less(classic);
+        for (auto& lhs: strings) {
+            for (auto& rhs: strings) {
+                CHECK( (key(lhs) < key(rhs)) == compare(lhs, rhs) );
+            }
+        }
+    }
+
+    SECTION( "wchar_t" )
+    {
+        auto strings = random_strings<wchar_t>(200, L"aAbBzZ@[`{09 \x80\xff");
+        auto key = cppsort::case_insensitive_sort_key(classic);
+        auto compare = cppsort::case_insensitive_less(classic);
+        for (auto& lhs: strings) {
+            for (auto& rhs: strings) {
+                CHECK( (key(lhs) < key(rhs)) == compare(lhs, rhs) );
+            }
+        }
+    }
+
+    SECTION( "radix sorters" )
+    {
+        auto strings = random_strings<char>(1000, "aAbBzZ@[`{09 \x80\xff");
+        auto strings2 = strings;
+
+        cppsort::schwartz_adapter<cppsort::ska_sorter> ska_sorter;
+        ska_sorter(strings, cppsort::case_insensitive_sort_key);
+        CHECK( std::is_sorted(strings.begin(), strings.end(), cppsort::case_insensitive_less) );
+
+        cppsort::schwartz_adapter<cppsort::spread_sorter> spread_sorter;
+        spread_sorter(strings2, cppsort::case_insensitive_sort_key);
+        CHECK( std::is_sorted(strings2.begin(), strings2.end(), cppsort::case_insensitive_less) );
+    }
+}
+
+TEST_CASE( "ascii_case_insensitive_less gives the same order as case_insensitive_less",
+           "[ascii_case_insensitive_less]" )
+{
+    auto strings = random_strings<char>(200, "aAbBzZ@[`{09 \x80\xff");
+    auto compare = cppsort::case_insensitive_less(std::locale::classic());
+
+    SECTION( "contiguous sequences" )
+    {
+        for (auto& lhs: strings) {
+            for (auto& rhs: strings) {
+                CHECK( cppsort::ascii_case_insensitive_less(lhs, rhs) == compare(lhs, rhs) );
+            }
+        }
+    }
+
+    SECTION( "other sequences" )
+    {
+        for (auto& lhs: strings) {
+            std::list<char> lhs_list(lhs.begin(), lhs.end());
+            for (auto& rhs: strings) {
+                std::vector<char> rhs_vec(rhs.begin(), rhs.end());
+                CHECK( cppsort::ascii_case_insensitive_less(lhs_list, rhs_vec) == compare(lhs, rhs) );
+            }
+        }
+    }
+
+    SECTION( "sort" )
+    {
+        cppsort::heap_sort(strings, cppsort::ascii_case_insensitive_less);
+        CHECK( std::is_sorted(strings.begin(), strings.end(), compare) );
+    }
+}
+
+TEST_CASE( "ascii_case_insensitive_less only accepts sequences of char",
+           "[ascii_case_insensitive_less]" )
+{
+    using compare_t = cppsort::ascii_case_insensitive_less_t;
+    CHECK(( cppsort::detail::is_invocable<compare_t, const std::string&, const std::vector<char>&>::value ));
+    CHECK_FALSE(( cppsort::detail::is_invocable<compare_t, const std::wstring&, const std::wstring&>::value ));
+    CHECK_FALSE(( cppsort::detail::is_invocable<compare_t, const std::string&, const std::u32string&>::value ));
+    CHECK_FALSE(( cppsort::detail::is_invocable<compare_t, const std::vector<int>&, const std::vector<int>&>::value ));
+}
@@ -1,12 +1,43 @@
 /*
- * Copyright (c) 2016-2020 Morwenn
+ * Copyright (c) 2016-2021 Morwenn
  * SPDX-License-Identifier: MIT
  */
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <random>
 #include <string>
+#include <vector>
 #include <catch2/catch.hpp>
+#include <cpp-sort/adapters/schwartz_adapter.h>
 #include <cpp-sort/comparators/natural_less.h>
 #include <cpp-sort/sorters/heap_sorter.h>
+#include <cpp-sort/sorters/ska_sorter.h>
+#include <cpp-sort/sorters/spread_sorter.h>
+
+namespace
+{
+    auto random_strings(std::size_t size)
+        -> std::vector<std::string>
+    {
+        // Few different characters to get numbers of several
+        // sizes, leading zeros and lots of common prefixes
+        const std::string alphabet = "000123989aB -\xff";
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<std::size_t> length_dist(0, 12);
+        std::uniform_int_distribution<std::size_t> char_dist(0, alphabet.size() - 1);
+
+        std::vector<std::string> res;
+        for (std::size_t i = 0 ; i < size ; ++i) {
+            std::string str;
+            for (auto length = length_dist(engine) ; length > 0 ; --length) {
+                str.push_back(alphabet[char_dist(engine)]);
+            }
+            res.push_back(str);
+        }
+        return res;
+    }
+}
 
 TEST_CASE( "string natural sort with natural_less" )
 {
@@ -33,3 +64,52 @@ TEST_CASE( "string natural sort with natural_less" )
     CHECK( array == expected );
 }
 
+
+TEST_CASE( "natural_less corner cases" )
+{
+    CHECK( cppsort::natural_less(std::string("a2b"), std::string("a10a")) );
+    CHECK( cppsort::natural_less(std::string("1a9"), std::string("1a10")) );
+    CHECK_FALSE( cppsort::natural_less(std::string("1a10"), std::string("1a9")) );
+    CHECK( cppsort::natural_less(std::string("0a"), std::string("0b")) );
+    CHECK( cppsort::natural_less(std::string("1"), std::string("1a")) );
+    CHECK_FALSE( cppsort::natural_less(std::string("1a"), std::string("1")) );
+    CHECK_FALSE( cppsort::natural_less(std::string("007"), std::string("7")) );
+    CHECK_FALSE( cppsort::natural_less(std::string("7"), std::string("007")) );
+}
+
+TEST_CASE( "natural_sort_key gives the same order as natural_less" )
+{
+    auto strings = random_strings(300);
+    for (auto& lhs: strings) {
+        auto lhs_key = cppsort::natural_sort_key(lhs);
+        for (auto& rhs: strings) {
+            auto rhs_key = cppsort::natural_sort_key(rhs);
+            CHECK( (lhs_key < rhs_key) == cppsort::natural_less(lhs, rhs) );
+        }
+    }
+
+    // Numbers with more than 254 digits
+    std::string long_number(300, '9');
+    std::string longer_number = "1" + std::string(300, '0');
+    CHECK( cppsort::natural_sort_key("a" + long_number) < cppsort::natural_sort_key("a" + longer_number) );
+    CHECK( cppsort::natural_sort_key("a" + std::string(254, '9')) < cppsort::natural_sort_key("a" + long_number) );
+}
+
+TEST_CASE( "natural sort with natural_sort_key and radix sorters" )
+{
+    auto strings = random_strings(1000);
+
+    SECTION( "ska_sorter" )
+    {
+        cppsort::schwartz_adapter<cppsort::ska_sorter> sorter;
+        sorter(strings, cppsort::natural_sort_key);
+        CHECK( std::is_sorted(strings.begin(), strings.end(), cppsort::natural_less) );
+    }
+
+    SECTION( "spread_sorter" )
+    {
+        cppsort::schwartz_adapter<cppsort::spread_sorter> sorter;
+        sorter(strings, cppsort::natural_sort_key);
+        CHECK( std::is_sorted(strings.begin(), strings.end(), cppsort::natural_less) );
+    }
+}
@@ -20,6 +20,7 @@ TEMPLATE_TEST_CASE( "random-access sorters with a projection returning an rvalue
                     cppsort::grail_sorter<>,
                     cppsort::heap_sorter,
                     cppsort::insertion_sorter,
+                    cppsort::lsd_radix_sorter<>,
                     cppsort::mel_sorter,
                     cppsort::merge_insertion_sorter,
                     cppsort::merge_sorter,
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/indirect_adapter.h>
+#include <cpp-sort/adapters/memory_resource_adapter.h>
+#include <cpp-sort/adapters/schwartz_adapter.h>
+#include <cpp-sort/probes.h>
+#include <cpp-sort/sorters.h>
+#include <cpp-sort/utility/buffer.h>
+#include <cpp-sort/utility/memory_resource.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/memory_exhaustion.h>
+
+//
+// Check that sorters and probes that need extra memory don't use the
+// global heap when they are given a memory resource that doesn't use it
+//
+// These tests shouldn't be part of the main test suite executable
+//
+
+namespace
+{
+    // Simple arena allocating from a fixed-size block of memory
+    // and only releasing memory when everything is deallocated
+    class arena_resource final:
+        public cppsort::utility::memory_resource
+    {
+        public:
+
+            std::size_t nb_allocations = 0;
+
+        private:
+
+            static constexpr std::size_t capacity = 1 << 20;
+            alignas(std::max_align_t) unsigned char memory[capacity];
+            std::size_t used = 0;
+            std::size_t nb_live = 0;
+
+            auto do_allocate(std::size_t bytes, std::size_t alignment)
+                -> void*
+                override
+            {
+                auto offset = (used + alignment - 1) / alignment * alignment;
+                if (offset + bytes > capacity) {
+                    throw std::bad_alloc();
+                }
+                used = offset + bytes;
+                ++nb_allocations;
+                ++nb_live;
+                return memory + offset;
+            }
+
+            auto do_deallocate(void*, std::size_t, std::size_t)
+                -> void
+                override
+            {
+                if (--nb_live == 0) {
+                    used = 0;
+                }
+            }
+
+            auto do_is_equal(const cppsort::utility::memory_resource& other) const noexcept
+                -> bool
+                override
+            {
+                return this == &other;
+            }
+    };
+}
+
+TEMPLATE_TEST_CASE( "test memory resources with heap exhaustion", "[memory_resource_adapter][heap_exhaustion]",
+                    cppsort::block_sorter<cppsort::utility::dynamic_buffer<cppsort::utility::half>>,
+                    cppsort::cartesian_tree_sorter,
+                    cppsort::drop_merge_sorter,
+                    cppsort::indirect_adapter<cppsort::pdq_sorter>,
+                    cppsort::merge_insertion_sorter,
+                    cppsort::merge_sorter,
+                    cppsort::poplar_sorter,
+                    cppsort::schwartz_adapter<cppsort::pdq_sorter>,
+                    cppsort::slab_sorter,
+                    cppsort::spin_sorter,
+                    cppsort::tim_sorter )
+{
+    std::vector<int> collection; collection.reserve(491);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 491, -125);
+
+    static arena_resource resource;
+    cppsort::memory_resource_adapter<TestType> sorter(&resource);
+    {
+        scoped_memory_exhaustion _;
+        sorter(collection, std::negate<>{});
+    }
+    CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+    CHECK( resource.nb_allocations > 0 );
+}
+
+TEMPLATE_TEST_CASE( "test memory resources with heap exhaustion for probes", "[probe][heap_exhaustion]",
+                    decltype(cppsort::probe::enc),
+                    decltype(cppsort::probe::exc),
+                    decltype(cppsort::probe::ham),
+                    decltype(cppsort::probe::inv),
+                    decltype(cppsort::probe::max),
+                    decltype(cppsort::probe::rem),
+                    decltype(cppsort::probe::sus) )
+{
+    std::vector<int> collection; collection.reserve(491);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 491, -125);
+
+    static arena_resource resource;
+    auto old_resource = cppsort::utility::set_memory_resource(&resource);
+    std::remove_const_t<std::remove_reference_t<TestType>> mop;
+    {
+        scoped_memory_exhaustion _;
+        (void)mop(collection);
+    }
+    cppsort::utility::set_memory_resource(old_resource);
+    CHECK( resource.nb_allocations > 0 );
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <functional>
+#include <iterator>
+#include <list>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/probes.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    template<typename Compare=std::less<>, typename Projection=cppsort::utility::identity>
+    auto check_parallel_probes(const std::vector<int>& collection,
+                               Compare compare={}, Projection projection={})
+        -> void
+    {
+        // Force several threads even on machines with few cores
+        cppsort::probe::parallel_ham_probe parallel_ham(4);
+        cppsort::probe::parallel_inv_probe parallel_inv(4);
+        cppsort::probe::parallel_max_probe parallel_max(4);
+        cppsort::probe::parallel_mono_probe parallel_mono(4);
+        cppsort::probe::parallel_runs_probe parallel_runs(4);
+
+        CHECK( parallel_ham(collection, compare, projection) ==
+               cppsort::probe::ham(collection, compare, projection) );
+        CHECK( parallel_inv(collection, compare, projection) ==
+               cppsort::probe::inv(collection, compare, projection) );
+        CHECK( parallel_max(collection, compare, projection) ==
+               cppsort::probe::max(collection, compare, projection) );
+        CHECK( parallel_mono(collection, compare, projection) ==
+               cppsort::probe::mono(collection, compare, projection) );
+        CHECK( parallel_runs(collection, compare, projection) ==
+               cppsort::probe::runs(collection, compare, projection) );
+    }
+}
+
+TEMPLATE_TEST_CASE( "parallel probes give the same results as sequential ones", "[probe][parallel]",
+                    dist::shuffled,
+                    dist::shuffled_16_values,
+                    dist::all_equal,
+                    dist::ascending,
+                    dist::descending,
+                    dist::pipe_organ,
+                    dist::push_front,
+                    dist::ascending_sawtooth,
+                    dist::alternating,
+                    dist::descending_plateau )
+{
+    std::vector<int> collection;
+    auto distribution = TestType{};
+    distribution(std::back_inserter(collection), 50'000);
+
+    check_parallel_probes(collection);
+    check_parallel_probes(collection, std::greater<>{});
+    check_parallel_probes(collection, std::less<>{}, [](int value) { return value / 3; });
+}
+
+TEST_CASE( "parallel probes with small or unusual inputs", "[probe][parallel]" )
+{
+    SECTION( "sizes around the thresholds" )
+    {
+        for (int size: { 0, 1, 2, 4'095, 4'096, 8'191, 8'192, 8'193, 12'345 }) {
+            std::vector<int> collection;
+            auto distribution = dist::shuffled_16_values{};
+            distribution(std::back_inserter(collection), size);
+            check_parallel_probes(collection);
+        }
+    }
+
+    SECTION( "two distinct values" )
+    {
+        // No two adjacent pairs of elements can go in the same direction
+        // with two values, which is the worst case for parallel_mono
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<int> dist(0, 1);
+        for (int iteration = 0 ; iteration < 10 ; ++iteration) {
+            std::vector<int> collection(20'000);
+            for (auto& value: collection) {
+                value = dist(engine);
+            }
+            check_parallel_probes(collection);
+        }
+    }
+
+    SECTION( "parallel_inv with forward iterators" )
+    {
+        std::vector<int> collection;
+        auto distribution = dist::shuffled{};
+        distribution(std::back_inserter(collection), 30'000);
+
+        std::list<int> li(collection.begin(), collection.end());
+        cppsort::probe::parallel_inv_probe parallel_inv(3);
+        CHECK( parallel_inv(li) == cppsort::probe::inv(collection) );
+        CHECK( parallel_inv(li.begin(), li.end()) == cppsort::probe::inv(collection) );
+    }
+
+    SECTION( "max_for_size" )
+    {
+        CHECK( cppsort::probe::parallel_inv.max_for_size(100) == cppsort::probe::inv.max_for_size(100) );
+        CHECK( cppsort::probe::parallel_mono.max_for_size(100) == cppsort::probe::mono.max_for_size(100) );
+    }
+}
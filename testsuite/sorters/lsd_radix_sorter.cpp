@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/lsd_radix_sorter.h>
+#include <cpp-sort/utility/buffer.h>
+#include <testing-tools/algorithm.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/wrapper.h>
+
+TEST_CASE( "lsd_radix_sorter tests", "[lsd_radix_sorter]" )
+{
+    auto distribution = dist::shuffled{};
+
+    SECTION( "sort with int iterable" )
+    {
+        std::vector<int> vec; vec.reserve(1000);
+        distribution(std::back_inserter(vec), 1000, -500);
+        cppsort::lsd_radix_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with unsigned int iterators" )
+    {
+        std::deque<unsigned> deq;
+        distribution(std::back_inserter(deq), 1000, 0);
+        cppsort::lsd_radix_sort(std::begin(deq), std::end(deq));
+        CHECK( std::is_sorted(std::begin(deq), std::end(deq)) );
+    }
+
+    SECTION( "sort with std::uint64_t keys" )
+    {
+        std::vector<std::uint64_t> vec; vec.reserve(10000);
+        std::uint64_t value = 0x0123456789abcdefu;
+        for (int i = 0 ; i < 10000 ; ++i) {
+            value ^= value << 13;
+            value ^= value >> 7;
+            value ^= value << 17;
+            vec.push_back(value);
+        }
+        cppsort::lsd_radix_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with float iterable" )
+    {
+        std::vector<float> vec; vec.reserve(1000);
+        distribution(std::back_inserter(vec), 1000, -500);
+        std::for_each(std::begin(vec), std::end(vec), [](float& value) { value /= 3.0f; });
+        cppsort::lsd_radix_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with double iterators" )
+    {
+        std::vector<double> vec; vec.reserve(1000);
+        distribution(std::back_inserter(vec), 1000, -500);
+        std::for_each(std::begin(vec), std::end(vec), [](double& value) { value /= 7.0; });
+        cppsort::lsd_radix_sort(std::begin(vec), std::end(vec));
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with small collections" )
+    {
+        std::vector<short> vec; vec.reserve(50);
+        distribution(std::back_inserter(vec), 50, -25);
+        cppsort::lsd_radix_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with projection" )
+    {
+        std::vector<std::pair<int, std::string>> vec;
+        for (int i = 0 ; i < 1000 ; ++i) {
+            vec.emplace_back((i * 7919) % 1000, std::to_string(i));
+        }
+        cppsort::lsd_radix_sort(vec, &std::pair<int, std::string>::first);
+        CHECK( helpers::is_sorted(std::begin(vec), std::end(vec),
+                                  std::less<>{}, &std::pair<int, std::string>::first) );
+    }
+
+    SECTION( "sort with a buffer too small" )
+    {
+        std::vector<int> vec; vec.reserve(1000);
+        distribution(std::back_inserter(vec), 1000, -500);
+        cppsort::lsd_radix_sorter<cppsort::utility::fixed_buffer<512>> sorter;
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+}
+
+TEST_CASE( "lsd_radix_sorter stability", "[lsd_radix_sorter][is_stable]" )
+{
+    using wrapper = generic_stable_wrapper<int>;
+
+    std::vector<wrapper> collection(1000);
+    helpers::iota(collection.begin(), collection.end(), 0, &wrapper::order);
+    auto distribution = dist::shuffled_16_values{};
+    distribution(collection.begin(), collection.size());
+
+    SECTION( "with a big enough buffer" )
+    {
+        cppsort::lsd_radix_sort(collection, &wrapper::value);
+        CHECK( std::is_sorted(collection.begin(), collection.end()) );
+    }
+
+    SECTION( "with a buffer too small" )
+    {
+        cppsort::lsd_radix_sorter<cppsort::utility::fixed_buffer<512>> sorter;
+        sorter(collection, &wrapper::value);
+        CHECK( std::is_sorted(collection.begin(), collection.end()) );
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/parallel_merge_sorter.h>
+#include <testing-tools/algorithm.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/wrapper.h>
+
+TEST_CASE( "parallel_merge_sorter tests", "[parallel_merge_sorter]" )
+{
+    // The collections must be big enough for the parallel
+    // algorithm to be used instead of the sequential one
+    std::vector<int> vec; vec.reserve(100000);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(vec), 100000, -25000);
+
+    SECTION( "sort with random-access iterable" )
+    {
+        cppsort::parallel_merge_sorter sorter(4);
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with random-access iterators and compare" )
+    {
+        cppsort::parallel_merge_sorter sorter(3);
+        sorter(std::begin(vec), std::end(vec), std::greater<>{});
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec), std::greater<>{}) );
+    }
+
+    SECTION( "sort with std::deque" )
+    {
+        std::deque<int> collection(std::begin(vec), std::end(vec));
+        cppsort::parallel_merge_sorter sorter(5);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort with the default number of threads" )
+    {
+        cppsort::parallel_merge_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort non-trivial types" )
+    {
+        std::vector<std::string> collection;
+        collection.reserve(vec.size());
+        for (int value: vec) {
+            collection.push_back(std::to_string(value));
+        }
+        cppsort::parallel_merge_sorter sorter(4);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+}
+
+TEST_CASE( "parallel_merge_sorter stability", "[parallel_merge_sorter][is_stable]" )
+{
+    using wrapper = generic_stable_wrapper<int>;
+
+    std::vector<wrapper> collection(50000);
+    helpers::iota(collection.begin(), collection.end(), 0, &wrapper::order);
+    auto distribution = dist::shuffled_16_values{};
+    distribution(collection.begin(), collection.size());
+
+    cppsort::parallel_merge_sorter sorter(4);
+    sorter(collection, &wrapper::value);
+    CHECK( std::is_sorted(collection.begin(), collection.end()) );
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/parallel_pdq_sorter.h>
+#include <testing-tools/algorithm.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/wrapper.h>
+
+TEST_CASE( "parallel_pdq_sorter tests", "[parallel_pdq_sorter]" )
+{
+    // The collections must be big enough for the parallel
+    // algorithm to be used instead of the sequential one
+    std::vector<int> vec; vec.reserve(100000);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(vec), 100000, -25000);
+
+    SECTION( "sort with random-access iterable" )
+    {
+        cppsort::parallel_pdq_sorter sorter(4);
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with random-access iterators and compare" )
+    {
+        cppsort::parallel_pdq_sorter sorter(3, 1000);
+        sorter(std::begin(vec), std::end(vec), std::greater<>{});
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec), std::greater<>{}) );
+    }
+
+    SECTION( "sort with std::deque" )
+    {
+        std::deque<int> collection(std::begin(vec), std::end(vec));
+        cppsort::parallel_pdq_sorter sorter(5, 500);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort with the default number of threads" )
+    {
+        cppsort::parallel_pdq_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with few distinct values" )
+    {
+        std::vector<int> collection;
+        dist::shuffled_16_values{}(std::back_inserter(collection), 100000);
+        cppsort::parallel_pdq_sorter sorter(4, 1000);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort already sorted collections" )
+    {
+        std::vector<int> collection;
+        dist::ascending{}(std::back_inserter(collection), 100000);
+        cppsort::parallel_pdq_sorter sorter(4, 1000);
+        sorter(collection, std::greater<>{});
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort non-branchless types with projection" )
+    {
+        using wrapper = generic_wrapper<std::string>;
+        std::vector<wrapper> collection;
+        collection.reserve(vec.size());
+        for (int value: vec) {
+            collection.emplace_back(std::to_string(value));
+        }
+        cppsort::parallel_pdq_sorter sorter(4, 1000);
+        sorter(collection, &wrapper::value);
+        CHECK( helpers::is_sorted(std::begin(collection), std::end(collection),
+                                  std::less<>{}, &wrapper::value) );
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/parallel_ska_sorter.h>
+#include <testing-tools/distributions.h>
+
+TEST_CASE( "parallel_ska_sorter tests", "[parallel_ska_sorter]" )
+{
+    // The collections must be big enough for the parallel
+    // algorithm to be used instead of the sequential one
+    std::vector<int> vec; vec.reserve(100000);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(vec), 100000, -25000);
+
+    SECTION( "sort with int iterable" )
+    {
+        cppsort::parallel_ska_sorter sorter(4);
+        sorter(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with int iterators" )
+    {
+        cppsort::parallel_ska_sorter sorter(3);
+        sorter(std::begin(vec), std::end(vec));
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with std::deque" )
+    {
+        std::deque<int> collection(std::begin(vec), std::end(vec));
+        cppsort::parallel_ska_sorter sorter(5);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort with the default number of threads" )
+    {
+        cppsort::parallel_ska_sort(vec);
+        CHECK( std::is_sorted(std::begin(vec), std::end(vec)) );
+    }
+
+    SECTION( "sort with std::uint64_t keys" )
+    {
+        // Random 64-bit keys with an empty most significant byte
+        std::vector<std::uint64_t> collection; collection.reserve(200000);
+        std::uint64_t value = 0x0123456789abcdefu;
+        for (int i = 0 ; i < 200000 ; ++i) {
+            value ^= value << 13;
+            value ^= value >> 7;
+            value ^= value << 17;
+            collection.push_back(value >> 8);
+        }
+        cppsort::parallel_ska_sorter sorter(4);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort with few distinct values" )
+    {
+        std::vector<int> collection; collection.reserve(100000);
+        auto distribution = dist::shuffled_16_values{};
+        distribution(std::back_inserter(collection), 100000);
+        cppsort::parallel_ska_sorter sorter(4);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort with std::pair with a non-trivial second element" )
+    {
+        std::vector<std::pair<int, std::string>> collection;
+        collection.reserve(vec.size());
+        for (int value: vec) {
+            collection.emplace_back(value % 100, std::to_string(value));
+        }
+        cppsort::parallel_ska_sorter sorter(4);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort with projection" )
+    {
+        std::vector<std::pair<double, int>> collection;
+        collection.reserve(vec.size());
+        for (int value: vec) {
+            collection.emplace_back(value / 7.0, value);
+        }
+        cppsort::parallel_ska_sorter sorter(4);
+        sorter(collection, &std::pair<double, int>::first);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "sort with std::string" )
+    {
+        std::vector<std::string> collection;
+        collection.reserve(vec.size());
+        for (int value: vec) {
+            collection.push_back(std::to_string(value));
+        }
+        cppsort::parallel_ska_sorter sorter(4);
+        sorter(collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/simd_quick_sorter.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    // Sorts copies of the collection with the given function and
+    // with std::sort, and checks that the results are the same
+    template<typename T, typename Sort>
+    auto check_sort(std::vector<T> collection, Sort sort)
+        -> void
+    {
+        auto expected = collection;
+        std::sort(expected.begin(), expected.end());
+        sort(collection);
+        CHECK( collection == expected );
+    }
+
+    template<typename T, typename Sort>
+    auto check_distributions(Sort sort)
+        -> void
+    {
+        for (long long int size: { 0, 1, 2, 31, 32, 33, 47, 100, 1000, 10007, 100000 }) {
+            std::vector<T> collection;
+            dist::shuffled{}(std::back_inserter(collection), size, -size / 2);
+            check_sort(collection, sort);
+
+            collection.clear();
+            dist::shuffled_16_values{}(std::back_inserter(collection), size);
+            check_sort(collection, sort);
+
+            collection.clear();
+            dist::all_equal{}(std::back_inserter(collection), size);
+            check_sort(collection, sort);
+
+            collection.clear();
+            dist::descending{}(std::back_inserter(collection), size);
+            check_sort(collection, sort);
+
+            collection.clear();
+            dist::pipe_organ{}(std::back_inserter(collection), size);
+            check_sort(collection, sort);
+
+            collection.clear();
+            dist::alternating{}(std::back_inserter(collection), size);
+            check_sort(collection, sort);
+
+            collection.clear();
+            dist::median_of_3_killer{}(std::back_inserter(collection), size);
+            check_sort(collection, sort);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE( "simd_quick_sorter with arithmetic types", "[simd_quick_sorter]",
+                    std::int32_t, std::int64_t, float, double )
+{
+    SECTION( "vector" )
+    {
+        check_distributions<TestType>([](std::vector<TestType>& collection) {
+            cppsort::simd_quick_sort(collection);
+        });
+    }
+
+    SECTION( "pointers" )
+    {
+        check_distributions<TestType>([](std::vector<TestType>& collection) {
+            cppsort::simd_quick_sort(collection.data(), collection.data() + collection.size());
+        });
+    }
+
+#if CPPSORT_SIMD_DISPATCH_AVAILABLE
+    // Test every kernel supported by the processor, and not
+    // only the one picked by the runtime dispatch
+    SECTION( "AVX2 kernel" )
+    {
+        if (__builtin_cpu_supports("avx2")) {
+            check_distributions<TestType>([](std::vector<TestType>& collection) {
+                auto first = collection.data();
+                auto last = first + collection.size();
+                cppsort::detail::simd_quicksort_loop<cppsort::detail::avx2_kernel>(first, last, 64);
+            });
+        }
+    }
+
+    SECTION( "AVX-512 kernel" )
+    {
+        if (__builtin_cpu_supports("avx512f")) {
+            check_distributions<TestType>([](std::vector<TestType>& collection) {
+                auto first = collection.data();
+                auto last = first + collection.size();
+                cppsort::detail::simd_quicksort_loop<cppsort::detail::avx512_kernel>(first, last, 64);
+            });
+        }
+    }
+#endif
+
+    SECTION( "scalar fallback" )
+    {
+        std::vector<TestType> collection;
+        dist::shuffled{}(std::back_inserter(collection), 1000, -500);
+
+        cppsort::simd_quick_sort(collection, std::greater<>{});
+        CHECK( std::is_sorted(collection.begin(), collection.end(), std::greater<>{}) );
+        cppsort::simd_quick_sort(collection, std::negate<>{});
+        CHECK( std::is_sorted(collection.begin(), collection.end(), std::greater<>{}) );
+
+        std::deque<TestType> deque(collection.begin(), collection.end());
+        cppsort::simd_quick_sort(deque);
+        CHECK( std::is_sorted(deque.begin(), deque.end()) );
+    }
+}
+
+TEST_CASE( "simd_quick_sorter with extreme values", "[simd_quick_sorter]" )
+{
+    SECTION( "integers" )
+    {
+        std::vector<std::int64_t> collection;
+        dist::shuffled{}(std::back_inserter(collection), 1000, -500);
+        for (std::size_t i = 0 ; i < collection.size() ; i += 7) {
+            collection[i] = (i % 2) ? std::numeric_limits<std::int64_t>::max()
+                                    : std::numeric_limits<std::int64_t>::min();
+        }
+        auto expected = collection;
+        std::sort(expected.begin(), expected.end());
+        cppsort::simd_quick_sort(collection);
+        CHECK( collection == expected );
+    }
+
+    SECTION( "floating point" )
+    {
+        std::vector<double> collection;
+        dist::shuffled{}(std::back_inserter(collection), 1000, -500);
+        for (std::size_t i = 0 ; i < collection.size() ; i += 7) {
+            collection[i] = (i % 2) ? std::numeric_limits<double>::infinity()
+                                    : -std::numeric_limits<double>::infinity();
+        }
+        auto expected = collection;
+        std::sort(expected.begin(), expected.end());
+        cppsort::simd_quick_sort(collection);
+        CHECK( collection == expected );
+    }
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/slab_sorter.h>
+#include <testing-tools/distributions.h>
+
+TEST_CASE( "slab_sorter tests", "[slab_sorter]" )
+{
+    SECTION( "many elements equivalent to the median" )
+    {
+        // Pipe-organ and descending runs sharing the same values
+        // make the partitioning step pick a median with many
+        // equivalent elements, which used to leave elements bigger
+        // than the median in the left partition
+        for (int run_size = 20 ; run_size < 200 ; run_size += 7) {
+            std::vector<int> collection;
+            auto out = std::back_inserter(collection);
+            while (collection.size() < 1000) {
+                dist::pipe_organ{}(out, run_size - 10);
+                dist::descending{}(out, run_size + 10);
+            }
+            cppsort::slab_sort(collection);
+            CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/fixed/sorting_network_sorter.h>
+#include <testing-tools/distributions.h>
+
+//
+// Some of the sizes and types below are handled by a vectorized
+// sorting network when the needed instruction sets are
+// available, and by the scalar one otherwise
+//
+
+namespace
+{
+    template<typename T, std::size_t N>
+    auto check_sorting_network(std::mt19937& engine)
+        -> void
+    {
+        std::uniform_int_distribution<int> dist(-10, 10);
+        std::array<T, N> array;
+        for (auto& value: array) {
+            value = static_cast<T>(dist(engine));
+        }
+        auto expected = array;
+        std::sort(expected.begin(), expected.end());
+
+        // std::array
+        auto arr = array;
+        cppsort::sorting_network_sorter<N>{}(arr);
+        CHECK( arr == expected );
+
+        // std::vector
+        std::vector<T> vec(array.begin(), array.end());
+        cppsort::sorting_network_sorter<N>{}(vec);
+        CHECK( std::equal(vec.begin(), vec.end(), expected.begin()) );
+
+        // Raw pointers
+        T carray[N];
+        std::copy(array.begin(), array.end(), carray);
+        cppsort::sorting_network_sorter<N>{}(carray, carray + N);
+        CHECK( std::equal(carray, carray + N, expected.begin()) );
+
+        // Comparison and projection fall back to the scalar network
+        arr = array;
+        cppsort::sorting_network_sorter<N>{}(arr, std::greater<>{});
+        CHECK( std::equal(arr.rbegin(), arr.rend(), expected.begin()) );
+        arr = array;
+        cppsort::sorting_network_sorter<N>{}(arr, std::negate<>{});
+        CHECK( std::equal(arr.rbegin(), arr.rend(), expected.begin()) );
+    }
+
+    template<typename T>
+    auto check_all_sizes()
+        -> void
+    {
+        std::mt19937 engine(Catch::rngSeed());
+        for (int i = 0 ; i < 100 ; ++i) {
+            check_sorting_network<T, 8>(engine);
+            check_sorting_network<T, 16>(engine);
+            check_sorting_network<T, 32>(engine);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE( "sorting_network_sorter with arithmetic types", "[sorting_network_sorter][simd]",
+                    std::int32_t, std::int64_t, float, double )
+{
+    check_all_sizes<TestType>();
+}
+
+TEST_CASE( "sorting_network_sorter with extreme values", "[sorting_network_sorter][simd]" )
+{
+    std::array<std::int64_t, 32> array;
+    std::vector<std::int64_t> values = {
+        std::numeric_limits<std::int64_t>::min(),
+        std::numeric_limits<std::int64_t>::max(),
+        -1, 0, 1
+    };
+    for (std::size_t i = 0 ; i < array.size() ; ++i) {
+        array[i] = values[(i * 7) % values.size()];
+    }
+    auto expected = array;
+    std::sort(expected.begin(), expected.end());
+
+    cppsort::sorting_network_sorter<32>{}(array);
+    CHECK( array == expected );
+}
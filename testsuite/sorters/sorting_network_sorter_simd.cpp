@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/fixed/sorting_network_sorter.h>
+#include <cpp-sort/utility/functional.h>
+
+//
+// These tests are compiled with SSE4.1 enabled, so that the
+// vectorized sorting networks are actually exercised: with
+// std::less<> the vectorized network is used, with std::greater<>
+// the scalar network is used, and both are expected to give the
+// same results as std::sort
+//
+
+static_assert(CPPSORT_SSE41_AVAILABLE, "the SIMD tests must be compiled with SSE4.1 enabled");
+
+namespace
+{
+    template<typename T, std::size_t N, typename Compare>
+    auto check_network(const std::array<T, N>& array, Compare compare)
+        -> void
+    {
+        auto expected = array;
+        std::sort(expected.begin(), expected.end(), compare);
+
+        auto arr = array;
+        cppsort::sorting_network_sorter<N>{}(arr, compare);
+        CHECK( arr == expected );
+
+        std::vector<T> vec(array.begin(), array.end());
+        cppsort::sorting_network_sorter<N>{}(vec, compare);
+        CHECK( std::equal(vec.begin(), vec.end(), expected.begin()) );
+
+        T carray[N];
+        std::copy(array.begin(), array.end(), carray);
+        cppsort::sorting_network_sorter<N>{}(carray, carray + N, compare);
+        CHECK( std::equal(carray, carray + N, expected.begin()) );
+    }
+
+    template<typename T, std::size_t N>
+    auto check_both_directions(const std::array<T, N>& array)
+        -> void
+    {
+        check_network(array, std::less<>{});
+        check_network(array, std::greater<>{});
+    }
+
+    template<typename T, std::size_t N>
+    auto check_simd_network()
+        -> void
+    {
+        // Make sure that the vectorized network is the one being tested
+        CHECK( cppsort::detail::is_simd_network_sortable<
+            N, T*, std::less<>, cppsort::utility::identity
+        >::value );
+        CHECK( cppsort::detail::is_simd_network_sortable<
+            N, typename std::array<T, N>::iterator, std::less<>, cppsort::utility::identity
+        >::value );
+        CHECK( not cppsort::detail::is_simd_network_sortable<
+            N, T*, std::greater<>, cppsort::utility::identity
+        >::value );
+
+        std::array<T, N> array;
+
+        // Ascending input
+        for (std::size_t idx = 0 ; idx < N ; ++idx) {
+            array[idx] = static_cast<T>(idx) - static_cast<T>(N / 2);
+        }
+        check_both_directions(array);
+
+        // Descending input
+        std::reverse(array.begin(), array.end());
+        check_both_directions(array);
+
+        // Every element equal
+        array.fill(static_cast<T>(3));
+        check_both_directions(array);
+
+        // Extreme values mixed with regular ones
+        for (std::size_t idx = 0 ; idx < N ; ++idx) {
+            switch (idx % 4) {
+                case 0:  array[idx] = (std::numeric_limits<T>::max)();    break;
+                case 1:  array[idx] = std::numeric_limits<T>::lowest();   break;
+                default: array[idx] = static_cast<T>(idx % 7) - T(3);
+            }
+        }
+        check_both_directions(array);
+
+        // Random inputs, with a small range to get duplicates
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<int> dist(-10, 10);
+        for (int i = 0 ; i < 200 ; ++i) {
+            for (auto& value: array) {
+                value = static_cast<T>(dist(engine));
+            }
+            check_both_directions(array);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE( "vectorized sorting_network_sorter with 16 elements", "[sorting_network_sorter][simd]",
+                    std::int32_t, float )
+{
+    check_simd_network<TestType, 16>();
+}
+
+TEMPLATE_TEST_CASE( "vectorized sorting_network_sorter with 32 elements", "[sorting_network_sorter][simd]",
+                    std::int32_t, float )
+{
+    check_simd_network<TestType, 32>();
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/utility/functional.h>
+#include <cpp-sort/detail/swap_if.h>
+#include <cpp-sort/detail/swap_if_n.h>
+
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Values for which the order of the parameters of min and max
+    // matters, the vectorized compare-exchanges must give exactly
+    // the same results as the scalar ones
+
+    template<typename T>
+    auto special_values(std::false_type /* floating point */)
+        -> std::vector<T>
+    {
+        using limits = std::numeric_limits<T>;
+        return { limits::min(), T(limits::min() + 1), T(-1), T(0), T(1), T(limits::max() - 1), limits::max() };
+    }
+
+    template<typename T>
+    auto special_values(std::true_type /* floating point */)
+        -> std::vector<T>
+    {
+        using limits = std::numeric_limits<T>;
+        return {
+            -limits::infinity(), limits::lowest(), T(-1.5), T(-0.0), T(0.0),
+            limits::denorm_min(), T(1.5), limits::max(), limits::infinity(),
+            limits::quiet_NaN(), -limits::quiet_NaN()
+        };
+    }
+
+    template<typename T>
+    auto same_bits(const std::vector<T>& lhs, const std::vector<T>& rhs)
+        -> bool
+    {
+        return lhs.size() == rhs.size()
+            && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+    }
+
+    // Compare-exchanges every pair of special values with swap_if_n,
+    // for every number of pairs up to a few vectors and at several
+    // offsets, and checks that the results are the same as those of
+    // the scalar swap_if, bit for bit
+    template<typename T, typename Compare, typename Projection>
+    auto check_swap_if_n(Compare compare, Projection projection)
+        -> void
+    {
+        auto values = special_values<T>(std::is_floating_point<T>{});
+        std::vector<T> lhs, rhs;
+        for (auto x: values) {
+            for (auto y: values) {
+                lhs.push_back(x);
+                rhs.push_back(y);
+            }
+        }
+
+        constexpr std::size_t max_count = 3 * cppsort::detail::swap_if_lanes<T>::size + 1;
+        for (std::size_t count = 0 ; count <= max_count ; ++count) {
+            for (std::size_t offset = 0 ; offset + count <= lhs.size() ; offset += 7) {
+                auto expected_lhs = lhs;
+                auto expected_rhs = rhs;
+                for (std::size_t i = offset ; i < offset + count ; ++i) {
+                    cppsort::detail::swap_if(expected_lhs[i], expected_rhs[i], compare, projection);
+                }
+
+                auto res_lhs = lhs;
+                auto res_rhs = rhs;
+                cppsort::detail::swap_if_n(res_lhs.data() + offset, res_rhs.data() + offset,
+                                           count, compare, projection);
+                CHECK( same_bits(res_lhs, expected_lhs) );
+                CHECK( same_bits(res_rhs, expected_rhs) );
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE( "swap_if_n with special values", "[swap_if]",
+                    std::int16_t, std::int32_t, std::int64_t, float, double )
+{
+    SECTION( "vectorized comparisons" )
+    {
+        check_swap_if_n<TestType>(std::less<>{}, cppsort::utility::identity{});
+        check_swap_if_n<TestType>(std::greater<>{}, cppsort::utility::identity{});
+        check_swap_if_n<TestType>(std::less<TestType>{}, cppsort::utility::identity{});
+    }
+
+    SECTION( "scalar fallback" )
+    {
+        // Neither the comparison nor the projection are known
+        // to be compatible with the vectorized compare-exchanges
+        auto compare = [](TestType lhs, TestType rhs) { return lhs < rhs; };
+        auto projection = [](const TestType& value) -> const TestType& { return value; };
+        check_swap_if_n<TestType>(compare, cppsort::utility::identity{});
+        check_swap_if_n<TestType>(std::less<>{}, projection);
+    }
+}
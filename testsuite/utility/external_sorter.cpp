@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/merge_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/utility/external_sorter.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    struct record
+    {
+        int key;
+        int order;
+
+        friend auto operator==(const record& lhs, const record& rhs)
+            -> bool
+        {
+            return lhs.key == rhs.key && lhs.order == rhs.order;
+        }
+    };
+}
+
+TEST_CASE( "external_sorter", "[utility][external_sorter]" )
+{
+    std::vector<int> collection;
+    collection.reserve(100'000);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 100'000, -1568);
+
+    SECTION( "everything fits in memory" )
+    {
+        cppsort::utility::external_sorter<> sorter(1 << 20);
+        std::vector<int> res;
+        sorter(collection, std::back_inserter(res));
+
+        std::sort(collection.begin(), collection.end());
+        CHECK( res == collection );
+    }
+
+    SECTION( "merge the runs in a single pass" )
+    {
+        // Eight runs and a fan-in of at least eight
+        cppsort::utility::external_sorter<cppsort::pdq_sorter> sorter(2 << 20);
+        std::vector<int> big_collection;
+        distribution(std::back_inserter(big_collection), 2'000'000, 0);
+        std::vector<int> res;
+        sorter(big_collection, std::back_inserter(res));
+
+        std::sort(big_collection.begin(), big_collection.end());
+        CHECK( res == big_collection );
+    }
+
+    SECTION( "merge the runs in several passes" )
+    {
+        // Many small runs merged two at a time
+        cppsort::utility::external_sorter<> sorter(4096);
+        std::vector<int> res(collection.size());
+        auto it = sorter(collection.begin(), collection.end(), res.begin(), std::greater<>{});
+        CHECK( it == res.end() );
+
+        std::sort(collection.begin(), collection.end(), std::greater<>{});
+        CHECK( res == collection );
+    }
+
+    SECTION( "more runs than open files" )
+    {
+        // Thousands of runs, more than the usual limit of open
+        // files if there was one temporary file per run
+        cppsort::utility::external_sorter<> sorter(128);
+        std::vector<int> small_collection(collection.begin(), collection.begin() + 40'000);
+        std::vector<int> res;
+        sorter(small_collection, std::back_inserter(res));
+
+        std::sort(small_collection.begin(), small_collection.end());
+        CHECK( res == small_collection );
+    }
+
+    SECTION( "temporary directory" )
+    {
+        cppsort::utility::external_sorter<> sorter(4096, ".");
+        CHECK( sorter.temporary_directory() == "." );
+        std::vector<int> res;
+        sorter(collection, std::back_inserter(res));
+
+        std::sort(collection.begin(), collection.end());
+        CHECK( res == collection );
+    }
+
+    SECTION( "missing temporary directory" )
+    {
+        cppsort::utility::external_sorter<> sorter(4096, "cpp-sort-missing-directory");
+        std::vector<int> res;
+        CHECK_THROWS_AS( sorter(collection, std::back_inserter(res)), std::system_error );
+    }
+
+    SECTION( "empty input" )
+    {
+        cppsort::utility::external_sorter<> sorter(4096);
+        std::vector<int> empty, res;
+        sorter(empty, std::back_inserter(res));
+        CHECK( res.empty() );
+    }
+
+    SECTION( "stream input and output" )
+    {
+        std::ostringstream input_stream;
+        std::copy(collection.begin(), collection.end(), std::ostream_iterator<int>(input_stream, " "));
+
+        std::istringstream iss(input_stream.str());
+        std::ostringstream oss;
+        cppsort::utility::external_sorter<> sorter(16384);
+        sorter(std::istream_iterator<int>(iss), std::istream_iterator<int>(),
+               std::ostream_iterator<int>(oss, " "));
+
+        std::istringstream result_stream(oss.str());
+        std::vector<int> res(std::istream_iterator<int>(result_stream), {});
+        std::sort(collection.begin(), collection.end());
+        CHECK( res == collection );
+    }
+}
+
+TEST_CASE( "external_sorter stability", "[utility][external_sorter]" )
+{
+    std::mt19937 engine(Catch::rngSeed());
+    std::uniform_int_distribution<int> dist(0, 50);
+
+    std::vector<record> collection;
+    for (int i = 0 ; i < 50'000 ; ++i) {
+        collection.push_back({ dist(engine), i });
+    }
+
+    // Stable in-memory sorter and runs merged in several passes
+    cppsort::utility::external_sorter<cppsort::merge_sorter> sorter(8192);
+    std::vector<record> res;
+    sorter(collection, std::back_inserter(res), std::less<>{}, &record::key);
+
+    std::stable_sort(collection.begin(), collection.end(), [](const record& lhs, const record& rhs) {
+        return lhs.key < rhs.key;
+    });
+    CHECK( res == collection );
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/utility/buffer.h>
+#include <cpp-sort/utility/k_way_merge.h>
+
+namespace
+{
+    struct record
+    {
+        int key;
+        int order;
+
+        friend auto operator==(const record& lhs, const record& rhs)
+            -> bool
+        {
+            return lhs.key == rhs.key && lhs.order == rhs.order;
+        }
+    };
+
+    // Sorted runs of random sizes, some of them empty, with
+    // few distinct keys and the order of creation in order
+    auto make_runs(std::size_t nb_runs)
+        -> std::vector<std::vector<record>>
+    {
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<int> size_dist(0, 200);
+        std::uniform_int_distribution<int> key_dist(0, 100);
+
+        std::vector<std::vector<record>> runs(nb_runs);
+        int order = 0;
+        for (auto& run: runs) {
+            auto size = size_dist(engine);
+            for (int i = 0 ; i < size ; ++i) {
+                run.push_back({ key_dist(engine), order++ });
+            }
+            std::sort(run.begin(), run.end(), [](const record& lhs, const record& rhs) {
+                return lhs.key < rhs.key;
+            });
+        }
+        return runs;
+    }
+
+    auto expected_merge(const std::vector<std::vector<record>>& runs)
+        -> std::vector<record>
+    {
+        std::vector<record> res;
+        for (const auto& run: runs) {
+            res.insert(res.end(), run.begin(), run.end());
+        }
+        std::stable_sort(res.begin(), res.end(), [](const record& lhs, const record& rhs) {
+            return lhs.key < rhs.key;
+        });
+        return res;
+    }
+
+    auto concatenate(const std::vector<std::vector<record>>& runs,
+                     std::vector<std::vector<record>::iterator>& middles)
+        -> std::vector<record>
+    {
+        std::vector<record> res;
+        std::vector<std::size_t> offsets;
+        for (const auto& run: runs) {
+            res.insert(res.end(), run.begin(), run.end());
+            offsets.push_back(res.size());
+        }
+        offsets.pop_back();
+        for (auto offset: offsets) {
+            middles.push_back(res.begin() + static_cast<std::ptrdiff_t>(offset));
+        }
+        return res;
+    }
+}
+
+TEST_CASE( "k_way_merge", "[utility][k_way_merge]" )
+{
+    SECTION( "many runs" )
+    {
+        auto runs = make_runs(257);
+        std::vector<record> res;
+        cppsort::utility::k_way_merge(runs, std::back_inserter(res), std::less<>{}, &record::key);
+        CHECK( res == expected_merge(runs) );
+    }
+
+    SECTION( "few runs" )
+    {
+        for (std::size_t nb_runs = 0 ; nb_runs < 5 ; ++nb_runs) {
+            auto runs = make_runs(nb_runs);
+            std::vector<record> res;
+            cppsort::utility::k_way_merge(runs, std::back_inserter(res), std::less<>{}, &record::key);
+            CHECK( res == expected_merge(runs) );
+        }
+    }
+
+    SECTION( "custom comparator" )
+    {
+        std::vector<std::vector<int>> runs = {
+            { 9, 5, 3 }, {}, { 8, 7, 6, 1 }, { 4, 2 }, { 10 }
+        };
+        std::vector<int> res(10);
+        auto it = cppsort::utility::k_way_merge(runs, res.begin(), std::greater<>{});
+        CHECK( it == res.end() );
+        CHECK( res == std::vector<int>{ 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 } );
+    }
+
+    SECTION( "number of comparisons" )
+    {
+        std::vector<std::vector<int>> runs(64);
+        std::mt19937 engine(Catch::rngSeed());
+        std::uniform_int_distribution<int> dist(0, 1000000);
+        std::size_t size = 0;
+        for (auto& run: runs) {
+            for (int i = 0 ; i < 100 ; ++i) {
+                run.push_back(dist(engine));
+            }
+            std::sort(run.begin(), run.end());
+            size += run.size();
+        }
+
+        std::size_t nb_comparisons = 0;
+        std::vector<int> res;
+        cppsort::utility::k_way_merge(runs, std::back_inserter(res), [&](int lhs, int rhs) {
+            ++nb_comparisons;
+            return lhs < rhs;
+        });
+        CHECK( std::is_sorted(res.begin(), res.end()) );
+        // log2(64) comparisons per element and the initial matches
+        CHECK( nb_comparisons <= size * 6 + runs.size() );
+    }
+}
+
+TEST_CASE( "k_way_inplace_merge", "[utility][k_way_merge]" )
+{
+    auto runs = make_runs(100);
+    auto expected = expected_merge(runs);
+    std::vector<std::vector<record>::iterator> middles;
+
+    SECTION( "buffer big enough" )
+    {
+        auto collection = concatenate(runs, middles);
+        cppsort::utility::k_way_inplace_merge(collection.begin(), middles, collection.end(),
+                                              std::less<>{}, &record::key);
+        CHECK( collection == expected );
+    }
+
+    SECTION( "small buffer" )
+    {
+        auto collection = concatenate(runs, middles);
+        cppsort::utility::k_way_inplace_merge<cppsort::utility::fixed_buffer<64>>(
+            collection.begin(), middles, collection.end(),
+            std::less<>{}, &record::key
+        );
+        CHECK( collection == expected );
+    }
+
+    SECTION( "no buffer" )
+    {
+        auto collection = concatenate(runs, middles);
+        cppsort::utility::k_way_inplace_merge<cppsort::utility::fixed_buffer<0>>(
+            collection.begin(), middles, collection.end(),
+            std::less<>{}, &record::key
+        );
+        CHECK( collection == expected );
+    }
+
+    SECTION( "single run" )
+    {
+        std::vector<int> collection = { 1, 2, 3, 4 };
+        std::vector<std::vector<int>::iterator> no_middles;
+        cppsort::utility::k_way_inplace_merge(collection.begin(), no_middles, collection.end());
+        CHECK( collection == std::vector<int>{ 1, 2, 3, 4 } );
+    }
+}
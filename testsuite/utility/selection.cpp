@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <forward_list>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/grail_sorter.h>
+#include <cpp-sort/sorters/heap_sorter.h>
+#include <cpp-sort/sorters/merge_sorter.h>
+#include <cpp-sort/utility/buffer.h>
+#include <cpp-sort/utility/selection.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/wrapper.h>
+
+namespace
+{
+    template<typename PartialSorter>
+    auto check_partial_sort(PartialSorter partial_sorter, std::vector<int> collection, int k)
+        -> void
+    {
+        auto expected = collection;
+        std::sort(expected.begin(), expected.end());
+        expected.resize(static_cast<std::size_t>(k));
+
+        partial_sorter(collection, k);
+        auto middle = collection.begin() + k;
+        CHECK( std::equal(collection.begin(), middle, expected.begin(), expected.end()) );
+
+        // The other elements are still there
+        std::sort(middle, collection.end());
+        CHECK( std::is_sorted(collection.begin(), collection.end()) );
+    }
+}
+
+TEMPLATE_TEST_CASE( "partial_sort with every selection algorithm", "[utility][selection]",
+                    cppsort::utility::default_select_algorithm,
+                    cppsort::utility::introselect_algorithm,
+                    cppsort::utility::adaptive_quickselect_algorithm )
+{
+    cppsort::utility::partial_sorter<cppsort::heap_sorter, TestType> partial_sorter;
+
+    std::vector<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 100'000, -1568);
+
+    SECTION( "shuffled" )
+    {
+        for (int k: { 0, 1, 2, 100, 12'499, 12'500, 50'000, 100'000 }) {
+            check_partial_sort(partial_sorter, collection, k);
+        }
+    }
+
+    SECTION( "descending" )
+    {
+        std::sort(collection.begin(), collection.end(), std::greater<>{});
+        check_partial_sort(partial_sorter, collection, 100);
+    }
+
+    SECTION( "many duplicates" )
+    {
+        for (auto& value: collection) {
+            value %= 16;
+        }
+        check_partial_sort(partial_sorter, collection, 100);
+        check_partial_sort(partial_sorter, collection, 10'000);
+    }
+}
+
+TEST_CASE( "partial_sort with projections and iterators", "[utility][selection]" )
+{
+    using wrapper = generic_wrapper<int>;
+
+    std::vector<int> values;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(values), 10'000, 0);
+
+    SECTION( "projection" )
+    {
+        std::vector<wrapper> collection;
+        for (int value: values) {
+            collection.push_back({ value });
+        }
+        cppsort::utility::partial_sort(collection, 50, std::greater<>{}, &wrapper::value);
+        for (int idx = 0 ; idx < 50 ; ++idx) {
+            CHECK( collection[idx].value == 9'999 - idx );
+        }
+    }
+
+    SECTION( "projection without comparison" )
+    {
+        std::vector<wrapper> collection;
+        for (int value: values) {
+            collection.push_back({ value });
+        }
+        cppsort::utility::partial_sort(collection, 50, &wrapper::value);
+        for (int idx = 0 ; idx < 50 ; ++idx) {
+            CHECK( collection[idx].value == idx );
+        }
+
+        cppsort::utility::partial_sort(collection.begin(), collection.begin() + 50, collection.end(),
+                                       [](const wrapper& value) { return -value.value; });
+        for (int idx = 0 ; idx < 50 ; ++idx) {
+            CHECK( collection[idx].value == 9'999 - idx );
+        }
+    }
+
+    SECTION( "buffer provider" )
+    {
+        std::vector<int> collection = values;
+        cppsort::utility::partial_sorter<
+            cppsort::grail_sorter<cppsort::utility::fixed_buffer<16>>
+        > partial_sorter;
+        partial_sorter(collection, 1'000);
+        for (int idx = 0 ; idx < 1'000 ; ++idx) {
+            CHECK( collection[idx] == idx );
+        }
+    }
+
+    SECTION( "bidirectional iterators" )
+    {
+        std::list<int> li(values.begin(), values.end());
+        cppsort::utility::partial_sorter<cppsort::merge_sorter> partial_sorter;
+        auto middle = std::next(li.begin(), 30);
+        partial_sorter(li.begin(), middle, li.end());
+        int expected = 0;
+        for (auto it = li.begin() ; it != middle ; ++it) {
+            CHECK( *it == expected++ );
+        }
+    }
+}
+
+TEST_CASE( "partial_sort and nth_element are SFINAE-friendly", "[utility][selection]" )
+{
+    using list_iterator = std::list<int>::iterator;
+    using partial_sort_t = cppsort::utility::partial_sorter<>;
+    using merge_partial_sort_t = cppsort::utility::partial_sorter<cppsort::merge_sorter>;
+    using adaptive_nth_element_t = cppsort::utility::nth_element_selector<
+        cppsort::utility::adaptive_quickselect_algorithm
+    >;
+
+    // pdq_sorter and the adaptive quickselect need random-access iterators
+    CHECK_FALSE(( cppsort::detail::is_invocable<
+        partial_sort_t, list_iterator, list_iterator, list_iterator
+    >::value ));
+    CHECK_FALSE(( cppsort::detail::is_invocable<partial_sort_t, std::list<int>&, int>::value ));
+    CHECK_FALSE(( cppsort::detail::is_invocable<
+        adaptive_nth_element_t, list_iterator, list_iterator, list_iterator
+    >::value ));
+    CHECK(( cppsort::detail::is_invocable<
+        merge_partial_sort_t, list_iterator, list_iterator, list_iterator
+    >::value ));
+    CHECK(( cppsort::detail::is_invocable<merge_partial_sort_t, std::list<int>&, int>::value ));
+    CHECK(( cppsort::detail::is_invocable<
+        cppsort::utility::nth_element_selector<>, std::list<int>&, int
+    >::value ));
+
+    // Neither a comparison nor a projection
+    CHECK_FALSE(( cppsort::detail::is_invocable<partial_sort_t, std::vector<int>&, int, int>::value ));
+}
+
+TEMPLATE_TEST_CASE( "nth_element with every selection algorithm", "[utility][selection]",
+                    cppsort::utility::default_select_algorithm,
+                    cppsort::utility::introselect_algorithm,
+                    cppsort::utility::adaptive_quickselect_algorithm )
+{
+    cppsort::utility::nth_element_selector<TestType> nth_element;
+
+    std::vector<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 10'000, 0);
+
+    for (int nth: { 0, 1, 5'000, 9'999 }) {
+        auto it = nth_element(collection, nth);
+        REQUIRE( it == collection.begin() + nth );
+        CHECK( *it == nth );
+        CHECK( std::all_of(collection.begin(), it, [&](int value) { return value < nth; }) );
+    }
+
+    auto it = nth_element(collection.begin(), collection.begin() + 42, collection.end(),
+                          std::greater<>{}, [](int value) { return value / 2; });
+    CHECK( *it / 2 == 4'978 );
+    it = nth_element(collection, 42, [](int value) { return -value; });
+    CHECK( *it == 9'957 );
+    CHECK( nth_element(collection, 10'000) == collection.end() );
+}
+
+TEST_CASE( "nth_element with forward iterators", "[utility][selection]" )
+{
+    std::vector<int> values;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(values), 500, 0);
+
+    // Check every position to exercise all the partitions
+    for (int nth = 0 ; nth < 500 ; ++nth) {
+        std::forward_list<int> collection(values.begin(), values.end());
+        auto it = cppsort::utility::nth_element(collection, nth);
+        REQUIRE( it == std::next(collection.begin(), nth) );
+        CHECK( *it == nth );
+        CHECK( std::all_of(collection.begin(), it, [&](int value) { return value < nth; }) );
+    }
+}
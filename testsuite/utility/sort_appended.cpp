@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/merge_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/utility/sort_appended.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    struct record
+    {
+        int key;
+        int order;
+
+        friend auto operator==(const record& lhs, const record& rhs)
+            -> bool
+        {
+            return lhs.key == rhs.key && lhs.order == rhs.order;
+        }
+    };
+}
+
+TEST_CASE( "sort_appended", "[utility][sort_appended]" )
+{
+    std::vector<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 10'000, 0);
+    std::sort(collection.begin(), collection.begin() + 9'900);
+    auto expected = collection;
+    std::sort(expected.begin(), expected.end());
+
+    SECTION( "vector" )
+    {
+        cppsort::utility::sort_appended(cppsort::pdq_sort, collection, 9'900);
+        CHECK( collection == expected );
+    }
+
+    SECTION( "list" )
+    {
+        std::list<int> li(collection.begin(), collection.end());
+        cppsort::utility::sort_appended(cppsort::merge_sort, li, 9'900);
+        CHECK( std::equal(li.begin(), li.end(), expected.begin(), expected.end()) );
+    }
+
+    SECTION( "iterators and comparator" )
+    {
+        std::sort(collection.begin(), collection.begin() + 9'900, std::greater<>{});
+        cppsort::utility::sort_appended(cppsort::pdq_sort, collection.begin(),
+                                        collection.begin() + 9'900, collection.end(),
+                                        std::greater<>{});
+        std::sort(expected.begin(), expected.end(), std::greater<>{});
+        CHECK( collection == expected );
+    }
+
+    SECTION( "new elements already in place" )
+    {
+        std::sort(collection.begin(), collection.end());
+        std::shuffle(collection.begin() + 9'900, collection.end(), std::mt19937(Catch::rngSeed()));
+        cppsort::utility::sort_appended(cppsort::pdq_sort, collection, 9'900);
+        CHECK( collection == expected );
+    }
+
+    SECTION( "empty parts" )
+    {
+        auto copy = collection;
+        std::sort(copy.begin(), copy.end());
+        cppsort::utility::sort_appended(cppsort::pdq_sort, copy, 10'000);
+        CHECK( copy == expected );
+
+        cppsort::utility::sort_appended(cppsort::pdq_sort, collection, 0);
+        CHECK( collection == expected );
+    }
+}
+
+TEST_CASE( "sort_appended stability", "[utility][sort_appended]" )
+{
+    std::mt19937 engine(Catch::rngSeed());
+    std::uniform_int_distribution<int> dist(0, 20);
+
+    std::vector<record> collection;
+    for (int i = 0 ; i < 1'000 ; ++i) {
+        collection.push_back({ dist(engine), i });
+    }
+    auto compare_keys = [](const record& lhs, const record& rhs) {
+        return lhs.key < rhs.key;
+    };
+    std::stable_sort(collection.begin(), collection.begin() + 900, compare_keys);
+    auto expected = collection;
+    std::stable_sort(expected.begin(), expected.end(), compare_keys);
+
+    cppsort::utility::sort_appended(cppsort::merge_sort, collection, 900,
+                                    std::less<>{}, &record::key);
+    CHECK( collection == expected );
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/adapters/indirect_adapter.h>
+#include <cpp-sort/sorters/merge_sorter.h>
+#include <cpp-sort/sorters/pdq_sorter.h>
+#include <cpp-sort/sorters/tim_sorter.h>
+#include <cpp-sort/utility/memory_resource.h>
+#include <cpp-sort/utility/sort_context.h>
+#include <testing-tools/distributions.h>
+
+namespace
+{
+    // Upstream resource counting the allocations
+    class counting_resource final:
+        public cppsort::utility::memory_resource
+    {
+        public:
+
+            std::size_t nb_allocations = 0;
+            std::size_t bytes_in_use = 0;
+
+        private:
+
+            auto do_allocate(std::size_t bytes, std::size_t alignment)
+                -> void* override
+            {
+                ++nb_allocations;
+                bytes_in_use += bytes;
+                return cppsort::utility::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            auto do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+                -> void override
+            {
+                bytes_in_use -= bytes;
+                cppsort::utility::new_delete_resource()->deallocate(ptr, bytes, alignment);
+            }
+
+            auto do_is_equal(const cppsort::utility::memory_resource& other) const noexcept
+                -> bool override
+            {
+                return this == &other;
+            }
+    };
+}
+
+TEST_CASE( "sorter_facade overloads taking a sort_context", "[sort_context][sorter_facade]" )
+{
+    std::vector<int> collection; collection.reserve(412);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 412, -125);
+    auto copy = collection;
+
+    cppsort::utility::sort_context context;
+
+    SECTION( "iterable" )
+    {
+        cppsort::merge_sort(context, collection);
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "iterable with comparison and projection" )
+    {
+        cppsort::merge_sort(context, collection, std::greater<>{});
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+        cppsort::merge_sort(context, collection, std::negate<>{});
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection), std::greater<>{}) );
+        cppsort::merge_sort(context, collection, std::greater<>{}, std::negate<>{});
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+    }
+
+    SECTION( "iterators" )
+    {
+        cppsort::merge_sort(context, std::begin(collection), std::end(collection));
+        CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+        cppsort::merge_sort(context, std::begin(copy), std::end(copy), std::greater<>{});
+        CHECK( std::is_sorted(std::begin(copy), std::end(copy), std::greater<>{}) );
+    }
+
+    // The memory resource of the thread is restored after the call
+    CHECK( cppsort::utility::get_memory_resource() == cppsort::utility::new_delete_resource() );
+    CHECK( context.cached_bytes() > 0 );
+}
+
+TEMPLATE_TEST_CASE( "sort_context reuses its memory across calls", "[sort_context]",
+                    cppsort::indirect_adapter<cppsort::pdq_sorter>,
+                    cppsort::merge_sorter,
+                    cppsort::tim_sorter )
+{
+    std::vector<int> collection; collection.reserve(412);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 412, -125);
+
+    counting_resource upstream;
+    {
+        cppsort::utility::sort_context context(&upstream);
+        CHECK( context.upstream_resource() == &upstream );
+
+        TestType sorter;
+        auto copy = collection;
+        sorter(context, copy);
+        CHECK( std::is_sorted(std::begin(copy), std::end(copy)) );
+
+        auto nb_allocations = upstream.nb_allocations;
+        CHECK( nb_allocations > 0 );
+        for (int i = 0 ; i < 5 ; ++i) {
+            copy = collection;
+            sorter(context, copy);
+            CHECK( std::is_sorted(std::begin(copy), std::end(copy)) );
+        }
+        // Sorting collections of the same size doesn't require new memory
+        CHECK( upstream.nb_allocations == nb_allocations );
+
+        // Explicitly give the cached memory back to the upstream resource
+        context.release();
+        CHECK( context.cached_bytes() == 0 );
+        CHECK( upstream.bytes_in_use == 0 );
+
+        copy = collection;
+        sorter(context, copy);
+        CHECK( std::is_sorted(std::begin(copy), std::end(copy)) );
+        CHECK( upstream.nb_allocations > nb_allocations );
+    }
+    // The context gives its memory back on destruction
+    CHECK( upstream.bytes_in_use == 0 );
+}
+
+TEST_CASE( "sort_context with growing collections", "[sort_context]" )
+{
+    counting_resource upstream;
+    {
+        cppsort::utility::sort_context context(&upstream);
+        std::size_t nb_calls = 0;
+        for (int size = 100 ; size < 5000 ; size += 50) {
+            std::vector<int> collection;
+            auto distribution = dist::shuffled{};
+            distribution(std::back_inserter(collection), size, 0);
+
+            cppsort::merge_sort(context, collection);
+            CHECK( std::is_sorted(std::begin(collection), std::end(collection)) );
+            ++nb_calls;
+        }
+        // Blocks are allocated with some slack and reused
+        CHECK( upstream.nb_allocations < nb_calls / 2 );
+    }
+    CHECK( upstream.bytes_in_use == 0 );
+}
+
+TEST_CASE( "sort_context caps the cached memory", "[sort_context]" )
+{
+    counting_resource upstream;
+    {
+        cppsort::utility::sort_context context(&upstream, 1000);
+        CHECK( context.max_cached_bytes() == 1000 );
+
+        // Blocks bigger than the cap are never cached, the blocks
+        // are allocated with 25% of slack
+        void* ptr = context.allocate(900);
+        context.deallocate(ptr, 900);
+        CHECK( context.cached_bytes() == 0 );
+        CHECK( upstream.bytes_in_use == 0 );
+
+        void* ptr1 = context.allocate(400);
+        void* ptr2 = context.allocate(400);
+        context.deallocate(ptr1, 400);
+        context.deallocate(ptr2, 400);
+        CHECK( context.cached_bytes() == 1000 );
+
+        // The oldest cached blocks are given back to make room
+        void* ptr3 = context.allocate(300);
+        void* ptr4 = context.allocate(600);
+        CHECK( context.cached_bytes() == 500 );
+        context.deallocate(ptr4, 600);
+        CHECK( context.cached_bytes() == 750 );
+        context.deallocate(ptr3, 300);
+        CHECK( context.cached_bytes() == 500 );
+    }
+    CHECK( upstream.bytes_in_use == 0 );
+}
+
+TEST_CASE( "sort_context only reuses blocks of a suitable size", "[sort_context]" )
+{
+    counting_resource upstream;
+    {
+        cppsort::utility::sort_context context(&upstream);
+
+        void* ptr = context.allocate(1000);
+        context.deallocate(ptr, 1000);
+        CHECK( upstream.nb_allocations == 1 );
+
+        // A block more than twice as big as the request isn't used
+        ptr = context.allocate(100);
+        CHECK( upstream.nb_allocations == 2 );
+        context.deallocate(ptr, 100);
+        CHECK( context.cached_bytes() == 1250 + 125 );
+
+        // Blocks smaller than every request made while other blocks
+        // were in use are given back once no block is in use
+        ptr = context.allocate(900);
+        CHECK( upstream.nb_allocations == 2 );
+        CHECK( context.cached_bytes() == 125 );
+        context.deallocate(ptr, 900);
+        CHECK( context.cached_bytes() == 1250 );
+
+        ptr = context.allocate(2000);
+        CHECK( upstream.nb_allocations == 3 );
+        context.deallocate(ptr, 2000);
+        CHECK( context.cached_bytes() == 2500 );
+    }
+    CHECK( upstream.bytes_in_use == 0 );
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/sorters/heap_sorter.h>
+#include <cpp-sort/utility/sort_mapped_file.h>
+#include <testing-tools/distributions.h>
+#include <unistd.h>
+
+namespace
+{
+    struct log_entry
+    {
+        std::uint32_t timestamp;
+        std::uint32_t offset;
+        double weight;
+    };
+
+    // Temporary file removed at the end of the test
+    class temporary_path
+    {
+        public:
+
+            temporary_path()
+            {
+                char name[] = "cpp-sort-mapped-XXXXXX";
+                auto fd = ::mkstemp(name);
+                REQUIRE( fd != -1 );
+                ::close(fd);
+                path = name;
+            }
+
+            ~temporary_path()
+            {
+                std::remove(path.c_str());
+            }
+
+            auto c_str() const
+                -> const char*
+            {
+                return path.c_str();
+            }
+
+        private:
+
+            std::string path;
+    };
+
+    template<typename T>
+    auto write_file(const char* path, const std::vector<T>& records)
+        -> void
+    {
+        auto file = std::fopen(path, "wb");
+        REQUIRE( file != nullptr );
+        std::fwrite(records.data(), sizeof(T), records.size(), file);
+        std::fclose(file);
+    }
+
+    template<typename T>
+    auto read_file(const char* path)
+        -> std::vector<T>
+    {
+        std::vector<T> records;
+        auto file = std::fopen(path, "rb");
+        REQUIRE( file != nullptr );
+        T record;
+        while (std::fread(&record, sizeof(T), 1, file) == 1) {
+            records.push_back(record);
+        }
+        std::fclose(file);
+        return records;
+    }
+}
+
+TEST_CASE( "sort_mapped_file", "[utility][sort_mapped_file]" )
+{
+    temporary_path path;
+
+    std::vector<int> collection;
+    collection.reserve(100'000);
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 100'000, -1568);
+
+    SECTION( "integer records" )
+    {
+        write_file(path.c_str(), collection);
+        cppsort::utility::sort_mapped_file<int>(path.c_str());
+        std::sort(collection.begin(), collection.end());
+        CHECK( read_file<int>(path.c_str()) == collection );
+    }
+
+    SECTION( "comparator and sorter" )
+    {
+        write_file(path.c_str(), collection);
+        cppsort::utility::sort_mapped_file<int>(cppsort::heap_sort, path.c_str(), std::greater<>{});
+        std::sort(collection.begin(), collection.end(), std::greater<>{});
+        CHECK( read_file<int>(path.c_str()) == collection );
+    }
+
+    SECTION( "records sorted with a projection" )
+    {
+        std::vector<log_entry> entries;
+        for (int value: collection) {
+            auto key = static_cast<std::uint32_t>(value + 1568);
+            entries.push_back({ key, key * 2u, 0.5 });
+        }
+        write_file(path.c_str(), entries);
+        cppsort::utility::sort_mapped_file<log_entry>(path.c_str(), std::less<>{}, &log_entry::timestamp);
+
+        auto res = read_file<log_entry>(path.c_str());
+        REQUIRE( res.size() == entries.size() );
+        for (std::uint32_t idx = 0 ; idx < res.size() ; ++idx) {
+            CHECK( res[idx].timestamp == idx );
+            CHECK( res[idx].offset == idx * 2u );
+        }
+    }
+
+    SECTION( "empty file" )
+    {
+        cppsort::utility::sort_mapped_file<int>(path.c_str());
+        CHECK( read_file<int>(path.c_str()).empty() );
+    }
+
+    SECTION( "errors" )
+    {
+        std::vector<char> bytes = { 1, 2, 3, 4, 5 };
+        write_file(path.c_str(), bytes);
+        CHECK_THROWS_AS( cppsort::utility::sort_mapped_file<int>(path.c_str()), std::system_error );
+        CHECK_THROWS_AS( cppsort::utility::sort_mapped_file<int>("cpp-sort-no-such-file"), std::system_error );
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021 Morwenn
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cpp-sort/utility/top_k.h>
+#include <testing-tools/distributions.h>
+#include <testing-tools/wrapper.h>
+
+TEST_CASE( "top_k_collector", "[utility][top_k]" )
+{
+    std::vector<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 100'000, -1568);
+    auto expected = collection;
+    std::sort(expected.begin(), expected.end());
+
+    SECTION( "push elements" )
+    {
+        for (std::size_t k: { 0, 1, 2, 100, 10'000, 100'000, 200'000 }) {
+            cppsort::utility::top_k_collector<int> collector(k);
+            for (int value: collection) {
+                collector.push(value);
+                CHECK( collector.size() <= k );
+            }
+
+            auto size = std::min(k, collection.size());
+            CHECK( collector.size() == size );
+            auto res = collector.extract_sorted();
+            CHECK( std::equal(res.begin(), res.end(), expected.begin(), expected.begin() + size) );
+            CHECK( collector.empty() );
+            CHECK( collector.capacity() == k );
+        }
+    }
+
+    SECTION( "reuse after extraction" )
+    {
+        cppsort::utility::top_k_collector<int, std::greater<>> collector(50);
+        for (int value: collection) {
+            collector.push(value);
+        }
+        collector.extract_sorted();
+
+        for (int value: { 5, 3, 8 }) {
+            collector.push(value);
+        }
+        auto res = collector.extract_sorted();
+        CHECK( res == std::vector<int>{ 8, 5, 3 } );
+    }
+
+    SECTION( "many duplicates" )
+    {
+        for (auto& value: collection) {
+            value %= 16;
+        }
+        expected = collection;
+        std::sort(expected.begin(), expected.end());
+
+        cppsort::utility::top_k_collector<int> collector(1'000);
+        for (int value: collection) {
+            collector.push(value);
+        }
+        auto res = collector.extract_sorted();
+        CHECK( std::equal(res.begin(), res.end(), expected.begin(), expected.begin() + 1'000) );
+    }
+
+    SECTION( "projection" )
+    {
+        using wrapper = generic_wrapper<std::string>;
+        cppsort::utility::top_k_collector<wrapper, std::greater<>, decltype(&wrapper::value)>
+            collector(3, {}, &wrapper::value);
+        for (const char* value: { "b", "e", "a", "d", "c" }) {
+            collector.push(wrapper{ value });
+        }
+        auto res = collector.extract_sorted();
+        REQUIRE( res.size() == 3 );
+        CHECK( res[0].value == "e" );
+        CHECK( res[1].value == "d" );
+        CHECK( res[2].value == "c" );
+    }
+}
+
+TEST_CASE( "top_k with input iterators", "[utility][top_k]" )
+{
+    std::vector<int> collection;
+    auto distribution = dist::shuffled{};
+    distribution(std::back_inserter(collection), 10'000, 0);
+
+    std::ostringstream oss;
+    for (int value: collection) {
+        oss << value << ' ';
+    }
+    std::istringstream iss(oss.str());
+
+    std::vector<int> res;
+    cppsort::utility::top_k(std::istream_iterator<int>(iss), std::istream_iterator<int>(),
+                            20, std::back_inserter(res), std::greater<>{});
+
+    REQUIRE( res.size() == 20 );
+    for (int idx = 0 ; idx < 20 ; ++idx) {
+        CHECK( res[idx] == 9'999 - idx );
+    }
+}